@@ -0,0 +1,57 @@
+#include "utec/thread/ParallelExecutor.h"
+#include "neural_network.h"
+#include <cstdio>
+#include <random>
+
+// Latencia (p50/p99) y throughput de ParallelExecutor por solicitud frente al modo por lotes,
+// con clientes que mantienen varias solicitudes en vuelo sobre la red 3-16-8-1 compilada.
+
+using namespace utec;
+
+static void correr(const char* nombre, thread::ParallelExecutor<float>& exec, int clientes, int en_vuelo, int rondas) {
+    std::vector<std::thread> hilos;
+    for (int c = 0; c < clientes; ++c)
+        hilos.emplace_back([&, c] {
+            std::vector<std::future<int>> futuros(en_vuelo);
+            for (int r = 0; r < rondas; ++r) {
+                for (int i = 0; i < en_vuelo; ++i)
+                    futuros[i] = exec.infer_async({0.5f, float((c + i + r) % 100) / 100.f, 0.5f});
+                for (auto& f : futuros) f.get();
+            }
+        });
+    for (auto& h : hilos) h.join();
+    auto st = exec.stats();
+    std::printf("%-24s lotes %7zu (media %6.1f)  p50 %9.1f us  p99 %9.1f us  %10.0f sol/s\n",
+                nombre, st.batches, st.mean_batch, st.p50_us, st.p99_us, st.throughput);
+}
+
+int main() {
+    neural_network::NeuralNetwork<float> net;
+    auto init = [](auto& W) {
+        std::mt19937 gen(1);
+        std::uniform_real_distribution<float> dist(-0.5f, 0.5f);
+        for (auto& w : W) w = dist(gen);
+    };
+    net.add_layer(std::make_unique<neural_network::Dense<float>>(3, 16, init, init));
+    net.add_layer(std::make_unique<neural_network::ReLU<float>>());
+    net.add_layer(std::make_unique<neural_network::Dense<float>>(16, 8, init, init));
+    net.add_layer(std::make_unique<neural_network::ReLU<float>>());
+    net.add_layer(std::make_unique<neural_network::Dense<float>>(8, 1, init, init));
+    net.compile(256);
+
+    nn::PongAgent<float> agente([&](const algebra::Tensor<float,2>& x) { return net.predict(x); });
+
+    const int clientes = 4, en_vuelo = 64, rondas = 200;
+    {
+        thread::ParallelExecutor<float> exec(4, agente);
+        correr("por solicitud (4 hilos)", exec, clientes, en_vuelo, rondas);
+    }
+    for (size_t max_batch : {16, 64, 256})
+        for (int espera_us : {50, 500}) {
+            thread::ParallelExecutor<float> exec(agente, {max_batch, std::chrono::microseconds(espera_us)});
+            char nombre[64];
+            std::snprintf(nombre, sizeof nombre, "lotes %zu / %d us", max_batch, espera_us);
+            correr(nombre, exec, clientes, en_vuelo, rondas);
+        }
+    return 0;
+}
@@ -0,0 +1,71 @@
+#include "tensor.h"
+#include <chrono>
+#include <cstdio>
+#include <random>
+
+// GFLOP/s de matrix_product frente al triple bucle original, en las formas de la red 3-16-8-1.
+
+using namespace utec;
+
+template <typename T>
+static algebra::Tensor<T,2> producto_ingenuo(const algebra::Tensor<T,2>& a, const algebra::Tensor<T,2>& b) {
+    auto [m, k1] = a.shape();
+    size_t n = b.shape()[1];
+    algebra::Tensor<T,2> result(m, n);
+    for (size_t i = 0; i < m; ++i)
+        for (size_t j = 0; j < n; ++j)
+            for (size_t k = 0; k < k1; ++k)
+                result(i, j) += a(i, k) * b(k, j);
+    return result;
+}
+
+template <typename F>
+static double segundos_por_llamada(F&& f) {
+    using clock = std::chrono::steady_clock;
+    for (int i = 0; i < 3; ++i) f();
+    size_t reps = 1;
+    while (true) {
+        auto t0 = clock::now();
+        for (size_t i = 0; i < reps; ++i) f();
+        double s = std::chrono::duration<double>(clock::now() - t0).count();
+        if (s > 0.2) return s / double(reps);
+        reps *= 2;
+    }
+}
+
+template <typename T>
+static void medir(const char* tipo, size_t m, size_t k, size_t n) {
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> dist(-1, 1);
+    algebra::Tensor<T,2> a(m, k), b(k, n);
+    for (auto& v : a) v = dist(rng);
+    for (auto& v : b) v = dist(rng);
+
+    volatile T sink = 0;
+    double t_new = segundos_por_llamada([&] { sink = sink + algebra::matrix_product(a, b)(0, 0); });
+    double t_old = segundos_por_llamada([&] { sink = sink + producto_ingenuo(a, b)(0, 0); });
+    double flops = 2.0 * double(m) * double(n) * double(k);
+    std::printf("%-6s %5zux%-5zux%-5zu  ingenuo %8.3f GFLOP/s  bloques %8.3f GFLOP/s  (x%.1f)\n",
+                tipo, m, k, n, flops / t_old * 1e-9, flops / t_new * 1e-9, t_old / t_new);
+}
+
+template <typename T>
+static void suite(const char* tipo) {
+    const size_t capas[][2] = {{3, 16}, {16, 8}, {8, 1}};
+    for (size_t batch : {1, 64, 256, 1024})
+        for (auto& c : capas)
+            medir<T>(tipo, batch, c[0], c[1]);
+    for (size_t s : {64, 256, 512})
+        medir<T>(tipo, s, s, s);
+}
+
+int main() {
+#ifdef UTEC_GEMM_AVX2
+    std::printf("kernel: AVX2/FMA\n");
+#else
+    std::printf("kernel: escalar\n");
+#endif
+    suite<float>("float");
+    suite<double>("double");
+    return 0;
+}
@@ -0,0 +1,156 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Arnés de benchmarks sin dependencias. Cada caso es una función que hace `items` unidades de
+// trabajo por llamada (p. ej. un lote de 64 filas o un episodio). El arnés calibra cuántas
+// llamadas caben en una repetición de al menos min_ms, corre `warmup` repeticiones sin medir y
+// luego `repetitions` medidas, y reporta ns por llamada (mínimo, p10, mediana, p90, máximo) y
+// unidades por segundo a partir de la mediana. La mediana y los percentiles son robustos a las
+// interrupciones del sistema, así que sirven para comparar entre versiones.
+
+namespace utec::bench {
+
+    struct Options {
+        size_t warmup = 2;
+        size_t repetitions = 15;
+        double min_ms = 20;
+        std::string filter;
+        std::string json;
+    };
+
+    struct Result {
+        std::string name;
+        std::string unit;
+        size_t calls_per_rep = 0;
+        double items_per_call = 1;
+        std::vector<double> ns;   // ns por llamada en cada repetición, ordenados
+
+        double percentile(double p) const {
+            if (ns.empty()) return 0;
+            const double pos = p / 100.0 * double(ns.size() - 1);
+            const size_t lo = size_t(pos);
+            const size_t hi = std::min(lo + 1, ns.size() - 1);
+            return ns[lo] + (ns[hi] - ns[lo]) * (pos - double(lo));
+        }
+
+        double median() const { return percentile(50); }
+        double mean() const {
+            double s = 0;
+            for (double v : ns) s += v;
+            return ns.empty() ? 0 : s / double(ns.size());
+        }
+        double per_second() const { return median() > 0 ? items_per_call * 1e9 / median() : 0; }
+    };
+
+    // --warmup N, --reps N, --min-ms X, --filtro TEXTO, --json ARCHIVO.
+    inline Options parse_options(int argc, char** argv) {
+        Options o;
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            auto value = [&]() -> std::string {
+                if (i + 1 >= argc)
+                    throw std::runtime_error("Falta el valor de " + arg);
+                return argv[++i];
+            };
+            if (arg == "--warmup") o.warmup = std::stoul(value());
+            else if (arg == "--reps") o.repetitions = std::max<size_t>(1, std::stoul(value()));
+            else if (arg == "--min-ms") o.min_ms = std::stod(value());
+            else if (arg == "--filtro") o.filter = value();
+            else if (arg == "--json") o.json = value();
+            else throw std::runtime_error("Opción desconocida: " + arg);
+        }
+        return o;
+    }
+
+    class Runner {
+    private:
+        Options options_;
+        std::vector<Result> results_;
+
+        using clock = std::chrono::steady_clock;
+
+        static double elapsed_ns(clock::time_point t0) {
+            return std::chrono::duration<double, std::nano>(clock::now() - t0).count();
+        }
+
+    public:
+        explicit Runner(Options options) : options_(std::move(options)) {}
+
+        const std::vector<Result>& results() const { return results_; }
+
+        // f() hace `items` unidades de `unit` (en plural: "filas", "episodios", ...).
+        void run(const std::string& name, const std::string& unit, double items, const std::function<void()>& f) {
+            if (!options_.filter.empty() && name.find(options_.filter) == std::string::npos) return;
+
+            // Calibración: duplica las llamadas por repetición hasta llegar a min_ms.
+            size_t calls = 1;
+            while (true) {
+                auto t0 = clock::now();
+                for (size_t i = 0; i < calls; ++i) f();
+                if (elapsed_ns(t0) >= options_.min_ms * 1e6 || calls >= (size_t(1) << 30)) break;
+                calls *= 2;
+            }
+
+            Result r{name, unit, calls, items, {}};
+            for (size_t rep = 0; rep < options_.warmup + options_.repetitions; ++rep) {
+                auto t0 = clock::now();
+                for (size_t i = 0; i < calls; ++i) f();
+                const double ns = elapsed_ns(t0) / double(calls);
+                if (rep >= options_.warmup) r.ns.push_back(ns);
+            }
+            std::sort(r.ns.begin(), r.ns.end());
+
+            std::printf("%-34s %12.1f ns  [p10 %10.1f  p90 %10.1f]  %14.0f %s/s\n",
+                        name.c_str(), r.median(), r.percentile(10), r.percentile(90), r.per_second(), unit.c_str());
+            std::fflush(stdout);
+            results_.push_back(std::move(r));
+        }
+
+        // Resultados y metadatos de la corrida; `meta` son pares clave/valor ya en texto.
+        void write_json(const std::vector<std::pair<std::string, std::string>>& meta) const {
+            if (options_.json.empty()) return;
+            std::ofstream out(options_.json);
+            if (!out)
+                throw std::runtime_error("No se pudo escribir " + options_.json);
+            out << "{\n  \"meta\": {";
+            for (size_t i = 0; i < meta.size(); ++i)
+                out << (i ? ", " : "") << "\"" << meta[i].first << "\": \"" << meta[i].second << "\"";
+            out << "},\n  \"opciones\": {\"warmup\": " << options_.warmup << ", \"repeticiones\": "
+                << options_.repetitions << ", \"min_ms\": " << options_.min_ms << "},\n  \"resultados\": [\n";
+            char buf[512];
+            for (size_t i = 0; i < results_.size(); ++i) {
+                const Result& r = results_[i];
+                std::snprintf(buf, sizeof(buf),
+                              "    {\"nombre\": \"%s\", \"unidad\": \"%s\", \"unidades_por_llamada\": %.0f, \"llamadas_por_rep\": %zu, "
+                              "\"ns_min\": %.3f, \"ns_p10\": %.3f, \"ns_mediana\": %.3f, \"ns_p90\": %.3f, "
+                              "\"ns_max\": %.3f, \"ns_media\": %.3f, \"por_segundo\": %.3f}",
+                              r.name.c_str(), r.unit.c_str(), r.items_per_call, r.calls_per_rep, r.ns.front(), r.percentile(10),
+                              r.median(), r.percentile(90), r.ns.back(), r.mean(), r.per_second());
+                out << buf << (i + 1 < results_.size() ? ",\n" : "\n");
+            }
+            out << "  ]\n}\n";
+            std::printf("Resultados en %s\n", options_.json.c_str());
+        }
+    };
+
+    // Evita que el compilador descarte un resultado no usado.
+    template <typename T>
+    inline void keep(const T& value) {
+#if defined(__GNUC__)
+        asm volatile("" : : "g"(&value) : "memory");
+#else
+        static const void* volatile sink;
+        sink = &value;
+#endif
+    }
+
+}
@@ -0,0 +1,99 @@
+#include "utec/thread/ConcurrentQueue.h"
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+// Millones de elementos por segundo a través de la cola, con P productores y P consumidores,
+// para la cola MPMC sin locks (unitaria y por lotes) frente a la cola anterior con mutex.
+
+using namespace utec;
+
+// La cola anterior (std::queue + mutex + condition_variable), con empty() corregido.
+template <typename T>
+class ColaConMutex {
+private:
+    std::queue<T> queue_;
+    mutable std::mutex mutex_;
+    std::condition_variable cond_var_;
+
+public:
+    void push(const T& item) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            queue_.push(item);
+        }
+        cond_var_.notify_one();
+    }
+
+    T pop() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cond_var_.wait(lock, [this] { return !queue_.empty(); });
+        T item = queue_.front();
+        queue_.pop();
+        return item;
+    }
+};
+
+template <typename Productor, typename Consumidor>
+static double medir(int hilos, long total, Productor producir, Consumidor consumir) {
+    auto t0 = std::chrono::steady_clock::now();
+    std::vector<std::thread> ts;
+    const long por_hilo = total / hilos;
+    for (int p = 0; p < hilos; ++p) ts.emplace_back([&] { producir(por_hilo); });
+    for (int c = 0; c < hilos; ++c) ts.emplace_back([&] { consumir(por_hilo); });
+    for (auto& t : ts) t.join();
+    double s = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    return double(por_hilo * hilos) / s * 1e-6;
+}
+
+int main() {
+    const long total = 400000;
+    std::printf("%8s %14s %14s %14s\n", "P = C", "mutex", "MPMC", "MPMC lotes 32");
+    for (int hilos : {1, 2, 4, 8, 16, 32}) {
+        double viejo, nuevo, lotes;
+        {
+            ColaConMutex<long> q;
+            viejo = medir(hilos, total,
+                          [&](long n) { for (long i = 0; i < n; ++i) q.push(i); },
+                          [&](long n) { for (long i = 0; i < n; ++i) q.pop(); });
+        }
+        {
+            thread::ConcurrentQueue<long> q(4096);
+            nuevo = medir(hilos, total,
+                          [&](long n) { for (long i = 0; i < n; ++i) q.push(i); },
+                          [&](long n) { for (long i = 0; i < n; ++i) q.pop(); });
+        }
+        {
+            thread::ConcurrentQueue<long> q(4096);
+            lotes = medir(hilos, total,
+                          [&](long n) {
+                              long buf[32];
+                              for (long i = 0; i < n;) {
+                                  long k = std::min<long>(32, n - i);
+                                  for (long j = 0; j < k; ++j) buf[j] = i + j;
+                                  long hecho = 0;
+                                  while (hecho < k) {
+                                      size_t m = q.push_bulk(buf + hecho, size_t(k - hecho));
+                                      if (m == 0) std::this_thread::yield();
+                                      hecho += long(m);
+                                  }
+                                  i += k;
+                              }
+                          },
+                          [&](long n) {
+                              long buf[32];
+                              for (long i = 0; i < n;) {
+                                  size_t m = q.pop_bulk(buf, size_t(std::min<long>(32, n - i)));
+                                  if (m == 0) std::this_thread::yield();
+                                  i += long(m);
+                              }
+                          });
+        }
+        std::printf("%8d %11.2f M/s %11.2f M/s %11.2f M/s\n", hilos, viejo, nuevo, lotes);
+    }
+    return 0;
+}
@@ -0,0 +1,64 @@
+#include "utec/agent/PongAgent.h"
+#include "utec/agent/PolicyQuantization.h"
+#include "neural_network.h"
+#include <chrono>
+#include <cstdio>
+#include <random>
+
+// Nanosegundos por decisión de PongAgent con la red 3-16-8-1: plan compilado detrás de
+// std::function frente a la red estática (PongPolicy) y a la red cuantizada a int8, ambas
+// llamadas con act_with.
+
+using namespace utec;
+
+template <typename F>
+static double ns_por_llamada(F&& f) {
+    using clock = std::chrono::steady_clock;
+    for (int i = 0; i < 1000; ++i) f(i);
+    size_t reps = 1024;
+    while (true) {
+        auto t0 = clock::now();
+        for (size_t i = 0; i < reps; ++i) f(i);
+        double s = std::chrono::duration<double>(clock::now() - t0).count();
+        if (s > 0.2) return s / double(reps) * 1e9;
+        reps *= 2;
+    }
+}
+
+int main() {
+    using T = float;
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<T> dist(-0.5f, 0.5f);
+    auto init = [&](auto& W) { for (auto& v : W) v = dist(rng); };
+
+    neural_network::NeuralNetwork<T> net;
+    net.add_layer(std::make_unique<neural_network::Dense<T>>(3, 16, init, init));
+    net.add_layer(std::make_unique<neural_network::ReLU<T>>());
+    net.add_layer(std::make_unique<neural_network::Dense<T>>(16, 8, init, init));
+    net.add_layer(std::make_unique<neural_network::ReLU<T>>());
+    net.add_layer(std::make_unique<neural_network::Dense<T>>(8, 1, init, init));
+    net.compile();
+
+    nn::PongPolicy<T> politica;
+    politica.load_from(net);
+
+    std::vector<nn::State> estados(1024);
+    std::uniform_real_distribution<float> u(0, 1);
+    for (auto& s : estados) s = {u(rng), u(rng), u(rng)};
+
+    auto cuantizada = nn::quantize_policy(net, estados);
+
+    nn::PongAgent<T> agente([&](const T* x) { return net.score(x); });
+    volatile int sink = 0;
+    double t_plan = ns_por_llamada([&](size_t i) { sink = sink + agente.act(estados[i & 1023]); });
+    double t_fija = ns_por_llamada([&](size_t i) {
+        sink = sink + nn::PongAgent<T>::act_with(politica, estados[i & 1023]);
+    });
+    double t_int8 = ns_por_llamada([&](size_t i) {
+        sink = sink + nn::PongAgent<T>::act_with(cuantizada, estados[i & 1023]);
+    });
+    std::printf("act (plan + std::function)   %8.1f ns/decisión\n", t_plan);
+    std::printf("act_with (PongPolicy)        %8.1f ns/decisión  (x%.1f)\n", t_fija, t_plan / t_fija);
+    std::printf("act_with (int8)              %8.1f ns/decisión  (x%.1f)\n", t_int8, t_plan / t_int8);
+    return 0;
+}
@@ -0,0 +1,279 @@
+#include "bench_harness.h"
+#include "utec/agent/PongAgentTrainable.h"
+#include "utec/agent/EnvGym.h"
+#include "utec/agent/ReplayBuffer.h"
+#include "utec/thread/ThreadPool.h"
+#include "neural_network.h"
+#include "nn_snapshot.h"
+#include "utec/metrics/Metrics.h"
+#include "utec/random/Philox.h"
+#include "utec/agent/VectorEnvGym.h"
+#include <ctime>
+#include <future>
+#include <random>
+
+// Suite de micro y macro benchmarks para seguir regresiones entre versiones:
+//   pong_bench [--warmup N] [--reps N] [--min-ms X] [--filtro TEXTO] [--json ARCHIVO]
+// Imprime la mediana y los percentiles p10/p90 en ns por unidad (fila, elemento, paso,
+// tarea o episodio) y, con --json, guarda todos los estadísticos junto con el compilador y
+// el kernel de gemm usados. Todas las entradas salen de semillas fijas.
+
+using namespace utec;
+using T = float;
+
+static std::mt19937 rng(7);
+
+static algebra::Tensor<T,2> aleatorio(size_t filas, size_t cols) {
+    std::uniform_real_distribution<T> dist(-1, 1);
+    algebra::Tensor<T,2> t(filas, cols);
+    for (auto& v : t) v = dist(rng);
+    return t;
+}
+
+static void init(algebra::Tensor<T,2>& W) {
+    std::uniform_real_distribution<T> dist(-0.5f, 0.5f);
+    for (auto& w : W) w = dist(rng);
+}
+
+static void armar(neural_network::NeuralNetwork<T>& net) {
+    net.add_layer(std::make_unique<neural_network::Dense<T>>(3, 16, init, init));
+    net.add_layer(std::make_unique<neural_network::ReLU<T>>());
+    net.add_layer(std::make_unique<neural_network::Dense<T>>(16, 8, init, init));
+    net.add_layer(std::make_unique<neural_network::ReLU<T>>());
+    net.add_layer(std::make_unique<neural_network::Dense<T>>(8, 1, init, init));
+    net.compile();
+}
+
+static void algebra_ops(bench::Runner& b) {
+    for (auto [m, k, n] : {std::array<size_t, 3>{64, 3, 16}, {64, 16, 8}, {256, 256, 256}}) {
+        auto A = aleatorio(m, k), B = aleatorio(k, n);
+        b.run("matrix_product " + std::to_string(m) + "x" + std::to_string(k) + "x" + std::to_string(n),
+              "FLOP", 2.0 * double(m * k * n), [&] { bench::keep(algebra::matrix_product(A, B)); });
+    }
+    for (auto [m, n] : {std::array<size_t, 2>{64, 16}, {512, 512}}) {
+        auto A = aleatorio(m, n);
+        b.run("transpose_2d " + std::to_string(m) + "x" + std::to_string(n), "elementos", double(m * n),
+              [&] { bench::keep(algebra::transpose_2d(A)); });
+    }
+
+    // Expresiones elemento a elemento: una pasada sobre un destino ya reservado.
+    auto X = aleatorio(64, 16), U = aleatorio(64, 16), bias = aleatorio(1, 16), R = aleatorio(64, 16);
+    b.run("expresión (X * a + b) / c 64x16", "elementos", double(X.size()), [&] {
+        R = (X * 1.5f + 0.25f) / 4.0f;
+        bench::keep(R);
+    });
+    b.run("expresión X * U + bias 64x16", "elementos", double(X.size()), [&] {
+        R = X * U + bias;
+        bench::keep(R);
+    });
+}
+
+static void capas(bench::Runner& b) {
+    const size_t lote = 64;
+    for (auto [in, out] : {std::array<size_t, 2>{3, 16}, {16, 8}}) {
+        neural_network::Dense<T> dense(in, out, init, init);
+        auto X = aleatorio(lote, in), dY = aleatorio(lote, out);
+        const std::string forma = std::to_string(in) + "x" + std::to_string(out);
+        b.run("Dense " + forma + " forward (64 filas)", "filas", lote, [&] { bench::keep(dense.forward(X)); });
+        dense.forward(X);
+        b.run("Dense " + forma + " backward (64 filas)", "filas", lote, [&] { bench::keep(dense.backward(dY)); });
+    }
+
+    auto Z = aleatorio(lote, 16), dA = aleatorio(lote, 16);
+    neural_network::ReLU<T> relu;
+    neural_network::Sigmoid<T> sigmoid;
+    b.run("ReLU forward 64x16", "elementos", double(Z.size()), [&] { bench::keep(relu.forward(Z)); });
+    b.run("ReLU backward 64x16", "elementos", double(Z.size()), [&] { bench::keep(relu.backward(dA)); });
+    b.run("Sigmoid forward 64x16", "elementos", double(Z.size()), [&] { bench::keep(sigmoid.forward(Z)); });
+    b.run("Sigmoid backward 64x16", "elementos", double(Z.size()), [&] { bench::keep(sigmoid.backward(dA)); });
+
+    auto pred = aleatorio(lote, 1), objetivo = aleatorio(lote, 1);
+    for (auto& v : pred) v = 0.5f + 0.4f * v;
+    for (auto& v : objetivo) v = v > 0 ? 1.0f : 0.0f;
+    b.run("MSELoss loss+gradiente (64 filas)", "filas", lote, [&] {
+        MSELoss<T> loss(pred, objetivo);
+        bench::keep(loss.loss());
+        bench::keep(loss.loss_gradient());
+    });
+    b.run("BCELoss loss+gradiente (64 filas)", "filas", lote, [&] {
+        BCELoss<T> loss(pred, objetivo);
+        bench::keep(loss.loss());
+        bench::keep(loss.loss_gradient());
+    });
+}
+
+static void optimizadores(bench::Runner& b) {
+    for (size_t n : {16 * 8, 256 * 256}) {
+        auto P = aleatorio(1, n), G = aleatorio(1, n);
+        for (auto& g : G) g *= 1e-3f;
+        neural_network::SGD<T> sgd(0.01f);
+        neural_network::Adam<T> adam(0.001f);
+        neural_network::Adam<T>::State estado;
+        b.run("SGD update " + std::to_string(n), "parámetros", double(n), [&] { sgd.update(P, G); });
+        b.run("Adam update " + std::to_string(n), "parámetros", double(n), [&] { adam.update(P, G, estado); });
+    }
+}
+
+static void agente(bench::Runner& b) {
+    nn::EnvGym env(11);
+    env.reset();
+    int accion = 0;
+    b.run("EnvGym::step", "pasos", 1, [&] {
+        float r;
+        bool done;
+        env.step(accion, r, done);
+        accion = accion == 1 ? -1 : accion + 1;
+        if (done) env.reset();
+    });
+
+    neural_network::NeuralNetwork<T> net;
+    armar(net);
+    nn::PongAgent<T> agent([&](const T* x) { return net.score(x); });
+    std::vector<nn::State> estados(1024);
+    std::uniform_real_distribution<float> u(0, 100);
+    for (auto& s : estados) s = {u(rng), u(rng), u(rng)};
+    size_t i = 0;
+    b.run("PongAgent::act", "decisiones", 1, [&] { bench::keep(agent.act(estados[i++ & 1023])); });
+
+    neural_network::SnapshotStore<T> store(net);
+    neural_network::SnapshotStore<T>::Reader lector(store);
+    nn::PongAgent<T> agent_rcu([&](const T* x) { return lector.score(x); });
+    b.run("PongAgent::act (instantánea RCU)", "decisiones", 1, [&] { bench::keep(agent_rcu.act(estados[i++ & 1023])); });
+    b.run("SnapshotStore::publish", "publicaciones", 1, [&] { bench::keep(store.publish()); });
+
+    nn::PongAgentTrainable<T> trainable([&](const T* x) { return net.score(x); }, net, 0.95f, 0.001f);
+    b.run("PongAgentTrainable::learnOnPolicy", "transiciones", 1, [&] {
+        const size_t k = i++ & 1023;
+        bench::keep(trainable.learnOnPolicy(estados[k], int(k % 3) - 1, 0.0f, estados[(k + 1) & 1023], 0));
+    });
+}
+
+static void hilos(bench::Runner& b) {
+    const size_t tareas = 256;
+    thread::ThreadPool pool(2);
+    std::vector<std::future<void>> futuros(tareas);
+    b.run("ThreadPool::enqueue (256 tareas)", "tareas", tareas, [&] {
+        for (auto& f : futuros) f = pool.enqueue([] {});
+        for (auto& f : futuros) f.get();
+    });
+}
+
+// Philox: de a uno, por lotes y un valor por flujo para muchos flujos a la vez.
+static void aleatorios(bench::Runner& b) {
+    random::Stream flujo(random::stream_id(random::Domain::Thread, 1), 7);
+    std::vector<float> out(4096);
+    b.run("Philox uniform escalar", "valores", 1, [&] { bench::keep(flujo.uniform()); });
+    b.run("Philox uniform lote 4096", "valores", double(out.size()), [&] {
+        flujo.uniform(out.data(), out.size());
+        bench::keep(out[0]);
+    });
+    b.run("Philox normal lote 4096", "valores", double(out.size()), [&] {
+        flujo.normal(out.data(), out.size());
+        bench::keep(out[0]);
+    });
+    uint64_t paso = 0;
+    b.run("Philox uniform_streams 1024 flujos", "valores", double(out.size()), [&] {
+        random::uniform_streams(random::stream_id(random::Domain::VectorEnv, 0), out.size() / 4, paso++, out.data(), 7);
+        bench::keep(out[0]);
+    });
+
+    nn::VectorEnvGym envs(1024, 3, 7);
+    std::vector<int> acciones(envs.size(), 1);
+    std::vector<float> recompensas;
+    std::vector<uint8_t> terminados;
+    envs.reset();
+    b.run("VectorEnvGym::step (1024 entornos)", "pasos", double(envs.size()), [&] {
+        bench::keep(envs.step(acciones, recompensas, terminados));
+    });
+}
+
+// Costo de registrar una muestra en el camino crítico (sin archivos ni consola).
+static void metricas(bench::Runner& b) {
+    metrics::Metrics m;
+    auto contador = m.counter("pasos");
+    auto histograma = m.histogram("pérdida", metrics::exponential_bounds(1e-4, 2.0, 20));
+    auto medidor = m.gauge("winrate");
+    double v = 0;
+    b.run("Metrics Counter::add", "muestras", 1, [&] { contador.add(); });
+    b.run("Metrics Histogram::record", "muestras", 1, [&] { histograma.record(v += 1e-3); });
+    b.run("Metrics Gauge::set", "muestras", 1, [&] { medidor.set(v += 1.0); });
+}
+
+// Episodios completos como el bucle de un hilo de main.cpp: ε-greedy, replay priorizado y un
+// minibatch de 64 cada 4 pasos; y, aparte, solo actuando.
+static void episodios(bench::Runner& b) {
+    neural_network::NeuralNetwork<T> net;
+    armar(net);
+    nn::PongAgentTrainable<T> agent([&](const T* x) { return net.score(x); }, net, 0.95f, 0.005f);
+    nn::ReplayBuffer<T> replay(20000, 3, true);
+    nn::ReplayBuffer<T>::Batch minibatch(64, 3);
+    std::mt19937 rng_replay(3);
+    std::uniform_real_distribution<float> u(0, 1);
+    nn::EnvGym env(5);
+    size_t pasos = 0;
+
+    auto episodio = [&](bool aprender) {
+        auto s = env.reset();
+        bool done = false;
+        while (!done) {
+            int a = u(rng_replay) < 0.1f ? int(rng_replay() % 3) - 1 : agent.act(s);
+            float r;
+            auto s_next = env.step(a, r, done);
+            if (aprender) {
+                agent.remember(replay, s, a, r, s_next, done);
+                if (replay.size() >= minibatch.size() && ++pasos % 4 == 0)
+                    agent.learnFromReplay(replay, minibatch, rng_replay);
+            }
+            s = s_next;
+        }
+    };
+
+    b.run("episodio (solo actuar)", "episodios", 1, [&] { episodio(false); });
+    b.run("episodio (actuar y aprender)", "episodios", 1, [&] { episodio(true); });
+}
+
+int main(int argc, char** argv) {
+    bench::Options options;
+    try {
+        options = bench::parse_options(argc, argv);
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "%s\n", e.what());
+        return 2;
+    }
+
+    bench::Runner b(options);
+    algebra_ops(b);
+    capas(b);
+    optimizadores(b);
+    agente(b);
+    hilos(b);
+    metricas(b);
+    aleatorios(b);
+    episodios(b);
+
+    char fecha[32];
+    std::time_t ahora = std::time(nullptr);
+    std::strftime(fecha, sizeof(fecha), "%Y-%m-%dT%H:%M:%S", std::localtime(&ahora));
+#ifdef UTEC_GEMM_AVX2
+    const char* kernel = "AVX2/FMA";
+#else
+    const char* kernel = "escalar";
+#endif
+#if defined(__clang__)
+    const std::string compilador = "clang " __clang_version__;
+#elif defined(__GNUC__)
+    const std::string compilador = "gcc " __VERSION__;
+#elif defined(_MSC_VER)
+    const std::string compilador = "msvc " + std::to_string(_MSC_VER);
+#else
+    const std::string compilador = "desconocido";
+#endif
+#ifdef NDEBUG
+    const char* build = "release";
+#else
+    const char* build = "debug";
+#endif
+    b.write_json({{"fecha", fecha}, {"compilador", compilador}, {"build", build}, {"kernel_gemm", kernel},
+                  {"hilos_intra_op", std::to_string(thread::intra_op::threads())}});
+    return 0;
+}
@@ -0,0 +1,216 @@
+#pragma once
+
+#include "PongAgentTrainable.h"
+#include "EnvGym.h"
+#include "ReplayBuffer.h"
+#include "neural_network.h"
+#include "nn_snapshot.h"
+#include "utec/thread/ConcurrentQueue.h"
+#include "utec/metrics/Metrics.h"
+#include "utec/random/Philox.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace utec::nn {
+
+    struct ActorLearnerConfig {
+        size_t actors = std::max(2u, std::thread::hardware_concurrency()) - 1;
+        size_t queue_capacity = 4096;
+        size_t replay_capacity = 20000;
+        size_t batch_size = 64;
+        size_t learn_every = 4;      // transiciones recibidas por paso del learner
+        size_t publish_every = 8;    // pasos del learner entre publicaciones de pesos
+        float epsilon = 0.1f;
+        uint64_t seed = 0;           // 0: semilla global (random::global_seed())
+    };
+
+    // Entrenamiento asíncrono actor-learner. Cada actor corre en su hilo con su propio EnvGym
+    // y un lector del SnapshotStore de la red, y manda sus transiciones por una ConcurrentQueue
+    // acotada. El learner, en el hilo que llama a run(), las pasa al replay, entrena por
+    // minibatches con learnFromReplay y cada publish_every pasos publica sus pesos con un
+    // intercambio atómico; cada act() de un actor usa la última versión publicada sin tomar
+    // locks ni copiar pesos. Con la cola llena los actores esperan, así que no se adelantan más
+    // de queue_capacity transiciones al learner.
+    template <typename T>
+    class ActorLearner {
+    private:
+        struct Transition {
+            T state[3];
+            T next_state[3];
+            int action;
+            T reward;
+            bool done;
+            T episode_reward;    // recompensa acumulada del episodio, válida si done
+        };
+
+        using Net = utec::neural_network::NeuralNetwork<T>;
+        using Store = utec::neural_network::SnapshotStore<T>;
+
+        Net& net_;
+        PongAgentTrainable<T>& learner_;
+        ActorLearnerConfig config_;
+
+        utec::thread::ConcurrentQueue<Transition> queue_;
+        ReplayBuffer<T> replay_;
+        typename ReplayBuffer<T>::Batch minibatch_;
+
+        std::unique_ptr<Store> store_;
+
+        bool metrics_ = false;
+        utec::metrics::Counter actor_steps_, learner_steps_metric_;
+        utec::metrics::Histogram loss_;
+        utec::metrics::Gauge queue_depth_;
+
+        std::atomic<bool> stop_{false};
+        std::mutex error_mutex_;
+        std::exception_ptr error_;
+
+        size_t learner_steps_ = 0;
+        size_t transitions_ = 0;
+
+        void fail(std::exception_ptr e) {
+            std::lock_guard<std::mutex> lock(error_mutex_);
+            if (!error_) error_ = e;
+            stop_.store(true);
+        }
+
+        // El actor i usa el entorno i y el flujo ε-greedy i bajo la misma semilla, así que su
+        // secuencia no depende de cómo se repartan los hilos. La instantánea ve el estado con la
+        // misma normalización que las transiciones que entrenan al learner.
+        void actor_loop(size_t index, uint64_t seed) {
+            typename Store::Reader reader(*store_);
+            EnvGym env(index, seed);
+            utec::random::Stream rng(utec::random::stream_id(utec::random::Domain::Actor, index), seed);
+            T x[3];
+            auto choose = [&](const State& s) {
+                if (rng.uniform() < config_.epsilon) return int(rng() % 3) - 1;
+                PongAgentTrainable<T>::encode(s, x);
+                return PongAgent<T>::to_action(reader.score(x));
+            };
+
+            Transition t{};
+            while (!stop_.load(std::memory_order_relaxed)) {
+                State s = env.reset();
+                int a = choose(s);
+                bool done = false;
+                T total = 0;
+                while (!done) {
+                    float r;
+                    State next = env.step(a, r, done);
+                    total += r;
+                    if (metrics_) actor_steps_.add();
+                    PongAgentTrainable<T>::encode(s, t.state);
+                    PongAgentTrainable<T>::encode(next, t.next_state);
+                    t.action = a;
+                    t.reward = T(r);
+                    t.done = done;
+                    t.episode_reward = total;
+                    while (!queue_.try_push(t)) {
+                        if (stop_.load(std::memory_order_relaxed)) return;
+                        std::this_thread::yield();
+                    }
+                    s = next;
+                    a = choose(s);
+                }
+            }
+        }
+
+    public:
+        ActorLearner(Net& net, PongAgentTrainable<T>& learner, ActorLearnerConfig config = {})
+                : net_(net), learner_(learner), config_(config),
+                  queue_(config.queue_capacity), replay_(config.replay_capacity, 3, true),
+                  minibatch_(config.batch_size, 3) {
+            if (config_.actors == 0 || config_.actors > Store::MAX_READERS ||
+                config_.learn_every == 0 || config_.publish_every == 0)
+                throw std::runtime_error("Configuración actor-learner inválida");
+        }
+
+        // Con metrics, los actores cuentan sus pasos de entorno ("pasos") y el learner registra
+        // la pérdida de cada minibatch ("pérdida"), sus pasos ("pasos_learner") y la
+        // ocupación de la cola ("cola"). nullptr lo desactiva; no llamar durante run().
+        void use_metrics(utec::metrics::Metrics* metrics) {
+            metrics_ = metrics != nullptr;
+            if (!metrics) return;
+            actor_steps_ = metrics->counter("pasos");
+            learner_steps_metric_ = metrics->counter("pasos_learner");
+            loss_ = metrics->histogram("pérdida", utec::metrics::exponential_bounds(1e-4, 2.0, 20));
+            queue_depth_ = metrics->gauge("cola");
+        }
+
+        // Corre hasta que el learner recibe episodes episodios completos. on_episode(recompensa)
+        // se llama en el hilo del learner por cada episodio, en el orden en que llegan. Relanza
+        // la primera excepción de un actor o del learner después de detener a todos los hilos.
+        void run(size_t episodes, const std::function<void(T)>& on_episode = {}) {
+            if (store_) store_->publish();
+            else store_ = std::make_unique<Store>(net_);
+
+            const uint64_t seed = config_.seed ? config_.seed : utec::random::global_seed();
+            utec::random::Stream rng(utec::random::stream_id(utec::random::Domain::Replay, 0), seed);
+            stop_.store(false);
+            std::vector<std::thread> actors;
+            for (size_t i = 0; i < config_.actors; ++i) {
+                actors.emplace_back([this, i, seed] {
+                    try {
+                        actor_loop(i, seed);
+                    } catch (...) {
+                        fail(std::current_exception());
+                    }
+                });
+            }
+
+            try {
+                std::vector<Transition> chunk(std::max<size_t>(config_.batch_size, 64));
+                size_t received = 0, credit = 0;
+                while (received < episodes && !stop_.load()) {
+                    size_t n = queue_.pop_bulk(chunk.begin(), chunk.size());
+                    if (n == 0) {
+                        if (!queue_.pop_for(chunk[0], std::chrono::milliseconds(10))) continue;
+                        n = 1;
+                    }
+                    for (size_t k = 0; k < n; ++k) {
+                        const Transition& t = chunk[k];
+                        replay_.push(t.state, t.action, t.reward, t.next_state, t.done);
+                        if (t.done && received < episodes) {
+                            ++received;
+                            if (on_episode) on_episode(t.episode_reward);
+                        }
+                    }
+                    transitions_ += n;
+                    if (metrics_) queue_depth_.set(double(queue_.size_approx()));
+                    credit += n;
+
+                    while (replay_.size() >= minibatch_.size() && credit >= config_.learn_every) {
+                        credit -= config_.learn_every;
+                        T loss = learner_.learnFromReplay(replay_, minibatch_, rng);
+                        if (metrics_) {
+                            loss_.record(double(loss));
+                            learner_steps_metric_.add();
+                        }
+                        if (++learner_steps_ % config_.publish_every == 0) store_->publish();
+                    }
+                }
+            } catch (...) {
+                fail(std::current_exception());
+            }
+
+            stop_.store(true);
+            for (auto& t : actors) t.join();
+            Transition drop;
+            while (queue_.try_pop(drop)) {}
+            if (error_) std::rethrow_exception(error_);
+        }
+
+        size_t learner_steps() const { return learner_steps_; }
+        size_t transitions() const { return transitions_; }
+        uint64_t published() const { return store_ ? store_->version() : 0; }
+        const ReplayBuffer<T>& replay() const { return replay_; }
+    };
+
+}
@@ -1,5 +1,7 @@
 #pragma once
 #include "State.h"
+#include "utec/random/Philox.h"
+#include <cstdint>
 
 namespace utec::nn {
 
@@ -7,8 +9,15 @@ namespace utec::nn {
     private:
         float paddle_y_ = 0.5f;
         float ball_y_ = 0.5f;
+        utec::random::Stream rng_;
 
     public:
+        // Cada instancia tiene su propio flujo Philox (Domain::Env, id), así que varios entornos
+        // pueden avanzar en hilos distintos y la secuencia depende solo de la semilla y el id.
+        // Sin id toma el siguiente libre; seed por defecto es la semilla global.
+        EnvGym() : rng_(utec::random::next_stream(utec::random::Domain::Env)) {}
+        explicit EnvGym(uint64_t id, uint64_t seed = utec::random::global_seed());
+
         State reset();
         State step(int action, float& reward, bool& done);
     };
@@ -0,0 +1,98 @@
+#pragma once
+
+#include "PongAgent.h"
+#include "EnvGym.h"
+#include "neural_network.h"
+#include "nn_quantized.h"
+#include <cmath>
+#include <ostream>
+#include <vector>
+
+namespace utec::nn {
+
+    // Entradas de la red para una lista de estados, codificadas como en act() y en el
+    // entrenamiento: la calibración INT8 ve el mismo rango que la red entrenada.
+    template <typename T>
+    algebra::Tensor<T,2> policy_inputs(const std::vector<State>& states) {
+        algebra::Tensor<T,2> X(states.size(), 3);
+        for (size_t i = 0; i < states.size(); ++i)
+            PongAgent<T>::encode(states[i], &X(i, 0));
+        return X;
+    }
+
+    // Estados visitados por la política de net en EnvGym (entorno 0 bajo la semilla dada), para
+    // calibrar o evaluar.
+    template <typename T>
+    std::vector<State> record_states(neural_network::NeuralNetwork<T>& net, size_t count, uint64_t seed) {
+        std::vector<State> states;
+        states.reserve(count);
+        EnvGym env(0, seed);
+        State s = env.reset();
+        algebra::Tensor<T,2> x(1, 3);
+        while (states.size() < count) {
+            states.push_back(s);
+            PongAgent<T>::encode(s, x.data());
+            float r;
+            bool done;
+            s = env.step(PongAgent<T>::to_action(net.infer(std::as_const(x).view())(0, 0)), r, done);
+            if (done) s = env.reset();
+        }
+        return states;
+    }
+
+    template <typename T>
+    neural_network::QuantizedNetwork<T> quantize_policy(neural_network::NeuralNetwork<T>& net,
+                                                        const std::vector<State>& calibration) {
+        auto X = policy_inputs<T>(calibration);
+        return neural_network::QuantizedNetwork<T>::quantize(net, std::as_const(X).view());
+    }
+
+    // Comparación de la política cuantizada con la de punto flotante sobre un conjunto de
+    // evaluación: coincidencia de acciones y error del puntaje.
+    struct QuantizationReport {
+        size_t samples = 0;
+        size_t matching_actions = 0;
+        double max_abs_error = 0;
+        double mean_abs_error = 0;
+        size_t float_bytes = 0;
+        size_t int8_bytes = 0;
+
+        double agreement() const { return samples ? double(matching_actions) / double(samples) : 1.0; }
+
+        void print(std::ostream& out) const {
+            out << "Cuantización INT8: " << matching_actions << " / " << samples << " acciones iguales ("
+                << 100.0 * agreement() << "%) | error de puntaje máx " << max_abs_error
+                << ", medio " << mean_abs_error << " | pesos " << float_bytes << " -> " << int8_bytes
+                << " bytes\n";
+        }
+    };
+
+    template <typename T>
+    QuantizationReport compare_policies(neural_network::NeuralNetwork<T>& net,
+                                        const neural_network::QuantizedNetwork<T>& quantized,
+                                        const std::vector<State>& evaluation) {
+        auto X = policy_inputs<T>(evaluation);
+        auto ref = net.predict(X);
+        algebra::Tensor<T,2> q(X.shape()[0], quantized.output_size());
+        quantized.forward_batch(std::as_const(X).view(), q.view());
+
+        QuantizationReport report;
+        report.samples = evaluation.size();
+        double total = 0;
+        for (size_t i = 0; i < report.samples; ++i) {
+            double err = std::fabs(double(ref(i, 0)) - double(q(i, 0)));
+            total += err;
+            report.max_abs_error = std::max(report.max_abs_error, err);
+            if (PongAgent<T>::to_action(ref(i, 0)) == PongAgent<T>::to_action(q(i, 0)))
+                ++report.matching_actions;
+        }
+        report.mean_abs_error = report.samples ? total / double(report.samples) : 0.0;
+
+        std::vector<neural_network::ParamRef<T>> params;
+        net.parameters(params);
+        for (const auto& p : params) report.float_bytes += p.value.size() * sizeof(T);
+        report.int8_bytes = quantized.weight_bytes();
+        return report;
+    }
+
+}
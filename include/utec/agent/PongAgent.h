@@ -1,23 +1,70 @@
 #pragma once
 
 #include "utec/nn/nn_interfaces.h"
+#include "utec/nn/nn_static.h"
 #include "utec/agent/State.h"
 #include "tensor.h"
 #include <memory>
 #include <functional>
+#include <vector>
 
 namespace utec::nn {
 
+    // Topología desplegada de la política (la misma que arma main.cpp).
+    template<typename T>
+    using PongPolicy = utec::neural_network::fixed::StaticNetwork<T,
+            utec::neural_network::fixed::Dense<3, 16>, utec::neural_network::fixed::ReLU,
+            utec::neural_network::fixed::Dense<16, 8>, utec::neural_network::fixed::ReLU,
+            utec::neural_network::fixed::Dense<8, 1>>;
+
     template<typename T>
     class PongAgent {
+    public:
+        // Puntaje de una sola observación (ball_x, ball_y, paddle_y), p. ej. NeuralNetwork::score
+        // tras compile(): act() no arma tensores por paso.
+        using ScoreFn = std::function<T(const T*)>;
+
     private:
         std::function<utec::algebra::Tensor<T,2>(const utec::algebra::Tensor<T,2>&)> forward_fn;
+        ScoreFn score_fn;
 
     public:
+        // Entrada de la red para un estado, con la misma normalización con la que se entrena
+        // (PongAgentTrainable la usa para s y s'), así que actuar y aprender ven las mismas escalas.
+        static void encode(const State& s, T* out) {
+            out[0] = s.ball_x / 100.0;
+            out[1] = s.ball_y / 100.0;
+            out[2] = s.paddle_y / 100.0;
+        }
+
+        // Acción (-1, 0, +1) para el puntaje de la red.
+        static int to_action(T val) {
+            if (val > T(0.1)) return +1;
+            if (val < T(-0.1)) return -1;
+            return 0;
+        }
+
         PongAgent(std::function<utec::algebra::Tensor<T,2>(const utec::algebra::Tensor<T,2>&)> fwd)
                 : forward_fn(fwd) {}
 
+        PongAgent(ScoreFn score)
+                : score_fn(std::move(score)) {}
+
         int act(const State& s);
+
+        // Decisión con una red de forma fija (p. ej. PongPolicy) llamada directamente, sin pasar
+        // por std::function ni asignar memoria.
+        template <typename Policy>
+        static int act_with(const Policy& policy, const State& s) {
+            T input[3];
+            encode(s, input);
+            return to_action(policy.score(input));
+        }
+
+        // Una acción por fila de obs (N x 3, p. ej. VectorEnvGym::observations()); con forward_fn
+        // la red se evalúa una sola vez para todo el lote.
+        void act_batch(const utec::algebra::Tensor<T,2>& obs, std::vector<int>& actions);
+        void act_batch(const utec::algebra::TensorView<const T>& obs, int* actions);
     };
 
 }
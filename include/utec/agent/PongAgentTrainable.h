@@ -2,7 +2,11 @@
 
 #include "PongAgent.h"
 #include "EnvGym.h"
+#include "ReplayBuffer.h"
 #include "neural_network.h"
+#include "nn_snapshot.h"
+#include <algorithm>
+#include <memory>
 #include <random>
 
 namespace utec::nn {
@@ -13,34 +17,128 @@ namespace utec::nn {
         neural_network::NeuralNetwork<T>& net_;
         T gamma_;
         T lr_;
+        neural_network::SGD<T> optimizer_;
+        algebra::Tensor<T,2> replay_input_;
+        algebra::Tensor<T,2> replay_grad_;
+        std::vector<T> td_errors_;
+        algebra::Tensor<T,2> td_input_;
+        algebra::Tensor<T,2> td_grad_;
+        std::unique_ptr<neural_network::TargetNetwork<T>> target_;
+        size_t target_sync_ = 0;
+        size_t replay_steps_ = 0;
+
+        // Columna de la red que estima Q(s, a): la única si la red tiene una salida, o una por
+        // acción (-1, 0, +1) si tiene tres.
+        static size_t action_column(int a, size_t cols) {
+            if (cols == 1) return 0;
+            if (a < -1 || size_t(a + 1) >= cols)
+                throw std::runtime_error("Acción sin columna en la salida de la red");
+            return size_t(a + 1);
+        }
 
     public:
         PongAgentTrainable(
                 std::function<algebra::Tensor<T,2>(const algebra::Tensor<T,2>&)> fwd,
                 neural_network::NeuralNetwork<T>& net,
                 T gamma = 0.95, T lr = 0.01
-        ) : PongAgent<T>(fwd), net_(net), gamma_(gamma), lr_(lr) {}
+        ) : PongAgent<T>(fwd), net_(net), gamma_(gamma), lr_(lr), optimizer_(lr), td_input_(2, 3) {}
+
+        PongAgentTrainable(
+                typename PongAgent<T>::ScoreFn score,
+                neural_network::NeuralNetwork<T>& net,
+                T gamma = 0.95, T lr = 0.01
+        ) : PongAgent<T>(std::move(score)), net_(net), gamma_(gamma), lr_(lr), optimizer_(lr), td_input_(2, 3) {}
+
+        // Paso SARSA sobre una transición: s y s_next van apilados en un solo forward de 2 filas,
+        // el objetivo es r + gamma * Q(s_next, a_next) (sin bootstrap si done) y el backward
+        // reutiliza las activaciones de ese mismo forward con gradiente solo en Q(s, a) (la fila
+        // de s_next no propaga nada). Un paso del optimizador persistente; devuelve el error TD.
+        T learnOnPolicy(const State& s, int a, float r, const State& s_next, int a_next, bool done = false) {
+            encode(s, td_input_.data());
+            encode(s_next, td_input_.data() + 3);
+
+            auto q = net_.forward_batch(std::as_const(td_input_).view());
+            const size_t col = action_column(a, q.cols());
+            const T target = T(r) + (done ? T(0) : gamma_ * q(1, action_column(a_next, q.cols())));
+            const T td_error = target - q(0, col);
 
-        void learnOnPolicy(const State& s, int a, float r, const State& s_next, int a_next) {
-            using namespace algebra;
+            // dL/dQ de (Q(s, a) - objetivo)^2 promediado sobre las columnas, como el MSE de train.
+            if (td_grad_.shape() != q.shape())
+                td_grad_ = algebra::Tensor<T,2>(q.rows(), q.cols());
+            td_grad_.fill(T(0));
+            td_grad_(0, col) = T(-2) * td_error / T(q.cols());
+            net_.backward_batch(std::as_const(td_grad_).view());
+            net_.update(optimizer_);
+            return td_error;
+        }
+
+        // Con every > 0, learnFromReplay toma Q(s') de una copia congelada de la red que se
+        // sincroniza cada every pasos (red objetivo de DQN); con 0 vuelve a usar la red en vivo.
+        void use_target_network(size_t every) {
+            target_sync_ = every;
+            replay_steps_ = 0;
+            if (every == 0) target_.reset();
+            else target_ = std::make_unique<neural_network::TargetNetwork<T>>(net_);
+        }
+
+        neural_network::TargetNetwork<T>* target_network() { return target_.get(); }
+
+        // Estado normalizado como lo ve la red; el mismo de PongAgent::act.
+        using PongAgent<T>::encode;
+
+        void remember(ReplayBuffer<T>& replay, const State& s, int a, float r, const State& s_next, bool done) {
+            T x[3], x_next[3];
+            encode(s, x);
+            encode(s_next, x_next);
+            replay.push(x, a, T(r), x_next, done);
+        }
 
-            Tensor<T,2> x(1,3);
-            x(0,0) = s.ball_x / 100.0;
-            x(0,1) = s.ball_y / 100.0;
-            x(0,2) = s.paddle_y / 100.0;
+        // Un paso de aprendizaje sobre un minibatch del replay, como learnOnPolicy pero por lotes:
+        // objetivo TD r + gamma * (1 - done) * max_a' Q(s', a') y gradiente solo en la columna de
+        // la acción tomada. Sin red objetivo, s y s' van apilados en un único forward de 2n filas
+        // (las de s' no propagan nada); con ella, Q(s') sale de la copia congelada y el forward
+        // es solo de s. Con muestreo por prioridad, el peso de importancia escala el gradiente de
+        // cada fila y el error TD actualiza las prioridades. Devuelve la pérdida del lote.
+        template <typename URBG>
+        T learnFromReplay(ReplayBuffer<T>& replay, typename ReplayBuffer<T>::Batch& batch,
+                          URBG& rng, T beta = T(0.4)) {
+            replay.sample(batch, rng, beta);
+            const size_t n = batch.size();
+            const size_t dim = batch.states.shape()[1];
 
-            Tensor<T,2> x_next(1,3);
-            x_next(0,0) = s_next.ball_x / 100.0;
-            x_next(0,1) = s_next.ball_y / 100.0;
-            x_next(0,2) = s_next.paddle_y / 100.0;
+            const size_t rows = target_ ? n : 2 * n;
+            if (replay_input_.shape() != std::array<size_t,2>{rows, dim})
+                replay_input_ = algebra::Tensor<T,2>(rows, dim);
+            std::copy_n(batch.states.data(), n * dim, replay_input_.data());
+            if (!target_) std::copy_n(batch.next_states.data(), n * dim, replay_input_.data() + n * dim);
 
-            auto Q_pred = net_.predict(x);
-            auto Q_next = net_.predict(x_next);
+            auto out = net_.forward_batch(std::as_const(replay_input_).view());
+            auto q = out.slice_rows(0, n);
+            auto q_next = target_ ? target_->run(batch.next_states.view()) : out.slice_rows(n, n);
+            const size_t cols = q.cols();
 
-            Tensor<T,2> target = Q_pred;
-            target(0,0) = r + gamma_ * Q_next(0,0);
+            if (replay_grad_.shape() != std::array<size_t,2>{rows, cols})
+                replay_grad_ = algebra::Tensor<T,2>(rows, cols);
+            replay_grad_.fill(T(0));
+            td_errors_.resize(n);
+            T loss = T(0);
+            for (size_t k = 0; k < n; ++k) {
+                T best = q_next(k, 0);
+                for (size_t j = 1; j < cols; ++j) best = std::max(best, q_next(k, j));
+                const size_t col = action_column(batch.actions[k], cols);
+                const T target = batch.rewards[k] + (batch.dones[k] ? T(0) : gamma_ * best);
+                td_errors_[k] = target - q(k, col);
+                // dL/dQ del MSE sobre n x cols con el término de la fila k ponderado.
+                const T weighted = batch.weights[k] * td_errors_[k];
+                replay_grad_(k, col) = T(-2) * weighted / T(n * cols);
+                loss += weighted * weighted;
+            }
+            replay.update_priorities(batch, td_errors_.data());
 
-            net_.train(x, target, 5, 1, lr_);
+            net_.backward_batch(std::as_const(replay_grad_).view());
+            net_.update(optimizer_);
+            if (target_ && ++replay_steps_ % target_sync_ == 0) target_->sync(net_);
+            return loss / T(n * cols);
         }
     };
 
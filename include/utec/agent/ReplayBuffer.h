@@ -0,0 +1,186 @@
+#pragma once
+
+#include "tensor.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+namespace utec::nn {
+
+    // Árbol de sumas sobre capacity hojas: actualizar una prioridad y buscar la hoja que
+    // contiene una masa acumulada u cuestan O(log n). Las hojas viven en [leaves_, 2 * leaves_).
+    template <typename T>
+    class SumTree {
+    private:
+        size_t leaves_ = 1;
+        std::vector<T> tree_;
+
+    public:
+        explicit SumTree(size_t capacity) {
+            while (leaves_ < capacity) leaves_ <<= 1;
+            tree_.assign(2 * leaves_, T(0));
+        }
+
+        T total() const { return tree_[1]; }
+        T get(size_t i) const { return tree_[leaves_ + i]; }
+
+        void set(size_t i, T priority) {
+            size_t node = leaves_ + i;
+            T delta = priority - tree_[node];
+            for (; node >= 1; node >>= 1) tree_[node] += delta;
+        }
+
+        // Hoja i con prefix(i) <= u < prefix(i) + p(i).
+        size_t find(T u) const {
+            size_t node = 1;
+            while (node < leaves_) {
+                size_t left = 2 * node;
+                if (u < tree_[left] || tree_[left + 1] <= T(0)) {
+                    node = left;
+                } else {
+                    u -= tree_[left];
+                    node = left + 1;
+                }
+            }
+            return node - leaves_;
+        }
+    };
+
+    // Memoria de experiencia de capacidad fija en estructura de arreglos: estados y
+    // siguientes estados en bloques planos de capacity x state_dim, y un arreglo por campo
+    // escalar. push() sobrescribe la transición más vieja en O(1) (O(log n) con prioridades).
+    // El muestreo escribe directo en un Batch reservado de antemano.
+    template <typename T>
+    class ReplayBuffer {
+    public:
+        // Minibatch reservado una vez; sample() lo llena sin asignar memoria.
+        struct Batch {
+            utec::algebra::Tensor<T, 2> states;
+            utec::algebra::Tensor<T, 2> next_states;
+            std::vector<int> actions;
+            std::vector<T> rewards;
+            std::vector<uint8_t> dones;
+            std::vector<size_t> indices;
+            std::vector<T> weights;      // pesos de importancia (1 en muestreo uniforme)
+
+            Batch(size_t batch_size, size_t state_dim)
+                    : states(batch_size, state_dim), next_states(batch_size, state_dim),
+                      actions(batch_size), rewards(batch_size), dones(batch_size),
+                      indices(batch_size), weights(batch_size, T(1)) {}
+
+            size_t size() const { return indices.size(); }
+        };
+
+    private:
+        size_t capacity_, state_dim_;
+        size_t head_ = 0, size_ = 0;
+        std::vector<T> states_;
+        std::vector<T> next_states_;
+        std::vector<int> actions_;
+        std::vector<T> rewards_;
+        std::vector<uint8_t> dones_;
+
+        bool prioritized_;
+        T alpha_;
+        T max_priority_ = T(1);
+        SumTree<T> tree_;
+
+        static constexpr T PRIORITY_EPS = T(1e-5);
+
+        template <typename URBG>
+        void sample_uniform(Batch& batch, URBG& rng) const {
+            std::uniform_int_distribution<size_t> dist(0, size_ - 1);
+            for (size_t k = 0; k < batch.size(); ++k) {
+                batch.indices[k] = dist(rng);
+                batch.weights[k] = T(1);
+            }
+        }
+
+        // Muestreo estratificado: una muestra por cada uno de B tramos iguales de la masa total.
+        // Los pesos w_i = (N * P(i))^-beta se normalizan por el máximo del lote.
+        template <typename URBG>
+        void sample_prioritized(Batch& batch, URBG& rng, T beta) const {
+            std::uniform_real_distribution<T> dist(T(0), T(1));
+            const T total = tree_.total();
+            const T segment = total / T(batch.size());
+            T max_w = T(0);
+            for (size_t k = 0; k < batch.size(); ++k) {
+                size_t i = std::min(tree_.find((T(k) + dist(rng)) * segment), size_ - 1);
+                batch.indices[k] = i;
+                T prob = tree_.get(i) / total;
+                batch.weights[k] = std::pow(T(size_) * prob, -beta);
+                max_w = std::max(max_w, batch.weights[k]);
+            }
+            for (size_t k = 0; k < batch.size(); ++k)
+                batch.weights[k] /= max_w;
+        }
+
+    public:
+        ReplayBuffer(size_t capacity, size_t state_dim = 3, bool prioritized = false, T alpha = T(0.6))
+                : capacity_(capacity), state_dim_(state_dim),
+                  states_(capacity * state_dim), next_states_(capacity * state_dim),
+                  actions_(capacity), rewards_(capacity), dones_(capacity),
+                  prioritized_(prioritized), alpha_(alpha), tree_(prioritized ? capacity : 1) {
+            if (capacity == 0)
+                throw std::runtime_error("La capacidad del replay buffer debe ser positiva");
+        }
+
+        size_t size() const { return size_; }
+        size_t capacity() const { return capacity_; }
+        size_t state_dim() const { return state_dim_; }
+        bool prioritized() const { return prioritized_; }
+
+        // Las transiciones nuevas entran con la prioridad máxima vista para que se muestreen
+        // al menos una vez.
+        void push(const T* state, int action, T reward, const T* next_state, bool done) {
+            const size_t i = head_;
+            std::copy(state, state + state_dim_, states_.data() + i * state_dim_);
+            std::copy(next_state, next_state + state_dim_, next_states_.data() + i * state_dim_);
+            actions_[i] = action;
+            rewards_[i] = reward;
+            dones_[i] = done;
+            if (prioritized_) tree_.set(i, max_priority_);
+
+            head_ = head_ + 1 == capacity_ ? 0 : head_ + 1;
+            size_ = std::min(size_ + 1, capacity_);
+        }
+
+        // Uniforme o por prioridad según el modo; beta solo afecta a los pesos de importancia.
+        template <typename URBG>
+        void sample(Batch& batch, URBG& rng, T beta = T(0.4)) const {
+            if (size_ == 0)
+                throw std::runtime_error("Replay buffer vacío");
+            if (batch.states.shape()[1] != state_dim_)
+                throw std::runtime_error("Dimensión de estado incompatible con el minibatch");
+
+            if (prioritized_) sample_prioritized(batch, rng, beta);
+            else sample_uniform(batch, rng);
+
+            const size_t n = batch.size();
+            utec::algebra::TensorView<const T> all(states_.data(), size_, state_dim_);
+            utec::algebra::TensorView<const T> all_next(next_states_.data(), size_, state_dim_);
+            utec::algebra::copy(all.gather_rows(batch.indices.data(), n), batch.states.view());
+            utec::algebra::copy(all_next.gather_rows(batch.indices.data(), n), batch.next_states.view());
+            for (size_t k = 0; k < n; ++k) {
+                size_t i = batch.indices[k];
+                batch.actions[k] = actions_[i];
+                batch.rewards[k] = rewards_[i];
+                batch.dones[k] = dones_[i];
+            }
+        }
+
+        // p_i = (|td_i| + eps)^alpha para las transiciones del último minibatch.
+        void update_priorities(const Batch& batch, const T* td_errors) {
+            if (!prioritized_) return;
+            for (size_t k = 0; k < batch.size(); ++k) {
+                T p = std::pow(std::fabs(td_errors[k]) + PRIORITY_EPS, alpha_);
+                max_priority_ = std::max(max_priority_, p);
+                tree_.set(batch.indices[k], p);
+            }
+        }
+    };
+
+}
@@ -0,0 +1,54 @@
+#pragma once
+#include "State.h"
+#include "tensor.h"
+#include "utec/random/Philox.h"
+#include <cstdint>
+#include <vector>
+
+namespace utec::nn {
+
+    // N copias de EnvGym guardadas como arreglos contiguos (una columna por variable de estado)
+    // para avanzar todas en un solo step(). Cada entorno tiene su propio flujo Philox y todos se
+    // sortean juntos con random::uniform_streams, cuatro sorteos por bloque en un bucle
+    // vectorizado; el resultado depende solo de la semilla y los ids. Los entornos que terminan se
+    // reinician en el mismo paso; la observación que devuelve step() ya es la del episodio nuevo
+    // y la del estado final queda en final_observations().
+    class VectorEnvGym {
+    private:
+        size_t n_;
+        std::vector<float> ball_y_;
+        std::vector<float> paddle_y_;
+        uint64_t first_stream_;
+        uint64_t seed_;
+        uint64_t draws_ = 0;                 // sorteos hechos por cada entorno
+        std::vector<float> noise_;           // 4 x N: el bloque vigente de cada flujo
+
+        const float* next_noise();
+        utec::algebra::Tensor<float, 2> obs_;
+        utec::algebra::Tensor<float, 2> final_obs_;
+
+        void write_observations(utec::algebra::Tensor<float, 2>& out) const;
+
+    public:
+        // Flujos (Domain::VectorEnv) nuevos, con la semilla global.
+        explicit VectorEnvGym(size_t n);
+        // Flujos id·2^24 + i, i < n: mismos id y semilla, misma secuencia.
+        VectorEnvGym(size_t n, uint64_t id, uint64_t seed = utec::random::global_seed());
+
+        size_t size() const { return n_; }
+
+        // Reinicia todos los entornos; devuelve la observación N x 3 (ball_x, ball_y, paddle_y).
+        const utec::algebra::Tensor<float, 2>& reset();
+
+        // actions[i] en {-1, 0, +1}. rewards y dones se redimensionan a N (solo la primera vez).
+        const utec::algebra::Tensor<float, 2>& step(const std::vector<int>& actions,
+                                                    std::vector<float>& rewards,
+                                                    std::vector<uint8_t>& dones);
+
+        const utec::algebra::Tensor<float, 2>& observations() const { return obs_; }
+        const utec::algebra::Tensor<float, 2>& final_observations() const { return final_obs_; }
+
+        State state(size_t i) const { return {0.5f, ball_y_[i], paddle_y_[i]}; }
+    };
+
+}
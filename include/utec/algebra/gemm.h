@@ -0,0 +1,408 @@
+#pragma once
+
+#include <cstddef>
+#include <algorithm>
+#include <vector>
+#include <type_traits>
+#include <memory>
+#include "tensor_view.h"
+#include "utec/thread/IntraOp.h"
+
+#if defined(__AVX2__) && defined(__FMA__)
+#include <immintrin.h>
+#define UTEC_GEMM_AVX2 1
+#endif
+
+// GEMM por bloques al estilo BLIS: A se empaqueta en paneles de MR filas, B en
+// paneles de NR columnas y un micro-kernel MR x NR acumula en registros.
+// Todas las matrices son row-major con su propio leading dimension; A y B pueden leerse
+// transpuestas sin copiarlas (el empaquetado absorbe el cambio de stride) y las filas de A
+// pueden venir de un índice (minibatch por gather).
+
+namespace utec::algebra::gemm {
+
+    // Tamaños de bloque: KC x NR de B cabe en L1, MC x KC de A en L2, KC x NC de B en L3.
+    inline constexpr size_t KC = 256;
+    inline constexpr size_t MC = 96;
+    inline constexpr size_t NC = 2048;
+
+    // Debajo de este número de multiply-adds el empaquetado no compensa.
+    inline constexpr size_t SMALL_GEMM_FLOPS = 32 * 32 * 32;
+
+    // Desde este número de multiply-adds los bloques MC de cada panel de B se reparten entre
+    // los hilos de intra_op; cada tile de C lo calcula un solo hilo en el mismo orden.
+    inline constexpr size_t PARALLEL_GEMM_FLOPS = 128 * 128 * 128;
+
+    enum class Trans { No, Yes };
+
+    // Epílogo aplicado a cada elemento de C tras la reducción completa en k, mientras el tile
+    // sigue en caché: epi(valor, columna). Sirve para fusionar bias y activación con el GEMM.
+    struct NoEpilogue {
+        template <typename T>
+        T operator()(T v, size_t) const { return v; }
+    };
+
+    template <typename T>
+    struct KernelShape { static constexpr size_t MR = 4, NR = 4; };
+
+#ifdef UTEC_GEMM_AVX2
+    template <>
+    struct KernelShape<float> { static constexpr size_t MR = 6, NR = 16; };
+
+    template <>
+    struct KernelShape<double> { static constexpr size_t MR = 6, NR = 8; };
+#endif
+
+    namespace detail {
+
+        template <typename T>
+        struct PackBuffers {
+            std::vector<T> a, b, gather_a, gather_b;
+            bool leased = false;
+        };
+
+        // Un juego de buffers por hilo: se reservan una vez y se reutilizan.
+        template <typename T>
+        PackBuffers<T>& pack_buffers() {
+            thread_local PackBuffers<T> buffers;
+            return buffers;
+        }
+
+        // Los buffers compartidos de una llamada (B empaquetada, gathers) se leen desde otros
+        // hilos mientras el que llama ayuda al pool, y ese hilo podría tomar ahí otro GEMM
+        // completo. Esa llamada anidada recibe un juego propio en vez de pisar el del hilo.
+        template <typename T>
+        class PackLease {
+        private:
+            PackBuffers<T>& local_;
+            std::unique_ptr<PackBuffers<T>> own_;
+
+        public:
+            PackLease() : local_(pack_buffers<T>()) {
+                if (local_.leased) own_ = std::make_unique<PackBuffers<T>>();
+                else local_.leased = true;
+            }
+            ~PackLease() {
+                if (!own_) local_.leased = false;
+            }
+            PackLease(const PackLease&) = delete;
+            PackLease& operator=(const PackLease&) = delete;
+
+            PackBuffers<T>& get() { return own_ ? *own_ : local_; }
+        };
+
+        // Empaqueta un bloque mc x kc de A en micro-paneles de MR filas (k-major), con relleno de ceros.
+        // A(i, p) = A[r(i) * rsa + p * csa], con r(i) = ria[i] si hay índice de filas.
+        template <typename T, size_t MR>
+        void pack_a(size_t mc, size_t kc, const T* A, size_t rsa, size_t csa, const size_t* ria, T* out) {
+            for (size_t i0 = 0; i0 < mc; i0 += MR) {
+                size_t rows = std::min(MR, mc - i0);
+                for (size_t p = 0; p < kc; ++p) {
+                    const T* col = A + p * csa;
+                    if (ria)
+                        for (size_t i = 0; i < rows; ++i)
+                            out[i] = col[ria[i0 + i] * rsa];
+                    else
+                        for (size_t i = 0; i < rows; ++i)
+                            out[i] = col[(i0 + i) * rsa];
+                    for (size_t i = rows; i < MR; ++i)
+                        out[i] = T(0);
+                    out += MR;
+                }
+            }
+        }
+
+        // Empaqueta un bloque kc x nc de B en micro-paneles de NR columnas, con relleno de ceros.
+        // B(p, j) = B[p * rsb + j * csb].
+        template <typename T, size_t NR>
+        void pack_b(size_t kc, size_t nc, const T* B, size_t rsb, size_t csb, T* out) {
+            for (size_t j0 = 0; j0 < nc; j0 += NR) {
+                size_t cols = std::min(NR, nc - j0);
+                for (size_t p = 0; p < kc; ++p) {
+                    const T* row = B + p * rsb + j0 * csb;
+                    if (csb == 1)
+                        for (size_t j = 0; j < cols; ++j)
+                            out[j] = row[j];
+                    else
+                        for (size_t j = 0; j < cols; ++j)
+                            out[j] = row[j * csb];
+                    for (size_t j = cols; j < NR; ++j)
+                        out[j] = T(0);
+                    out += NR;
+                }
+            }
+        }
+
+        // Micro-kernel genérico: acc = Ap * Bp sobre kc, luego C += acc.
+        template <typename T, size_t MR, size_t NR>
+        void kernel_scalar(size_t kc, const T* Ap, const T* Bp, T* C, size_t ldc) {
+            T acc[MR][NR] = {};
+            for (size_t p = 0; p < kc; ++p, Ap += MR, Bp += NR)
+                for (size_t i = 0; i < MR; ++i)
+                    for (size_t j = 0; j < NR; ++j)
+                        acc[i][j] += Ap[i] * Bp[j];
+            for (size_t i = 0; i < MR; ++i)
+                for (size_t j = 0; j < NR; ++j)
+                    C[i * ldc + j] += acc[i][j];
+        }
+
+#ifdef UTEC_GEMM_AVX2
+        inline void kernel_avx2(size_t kc, const float* Ap, const float* Bp, float* C, size_t ldc) {
+            __m256 c00 = _mm256_setzero_ps(), c01 = _mm256_setzero_ps();
+            __m256 c10 = _mm256_setzero_ps(), c11 = _mm256_setzero_ps();
+            __m256 c20 = _mm256_setzero_ps(), c21 = _mm256_setzero_ps();
+            __m256 c30 = _mm256_setzero_ps(), c31 = _mm256_setzero_ps();
+            __m256 c40 = _mm256_setzero_ps(), c41 = _mm256_setzero_ps();
+            __m256 c50 = _mm256_setzero_ps(), c51 = _mm256_setzero_ps();
+            for (size_t p = 0; p < kc; ++p, Ap += 6, Bp += 16) {
+                __m256 b0 = _mm256_loadu_ps(Bp);
+                __m256 b1 = _mm256_loadu_ps(Bp + 8);
+                __m256 a;
+                a = _mm256_broadcast_ss(Ap + 0); c00 = _mm256_fmadd_ps(a, b0, c00); c01 = _mm256_fmadd_ps(a, b1, c01);
+                a = _mm256_broadcast_ss(Ap + 1); c10 = _mm256_fmadd_ps(a, b0, c10); c11 = _mm256_fmadd_ps(a, b1, c11);
+                a = _mm256_broadcast_ss(Ap + 2); c20 = _mm256_fmadd_ps(a, b0, c20); c21 = _mm256_fmadd_ps(a, b1, c21);
+                a = _mm256_broadcast_ss(Ap + 3); c30 = _mm256_fmadd_ps(a, b0, c30); c31 = _mm256_fmadd_ps(a, b1, c31);
+                a = _mm256_broadcast_ss(Ap + 4); c40 = _mm256_fmadd_ps(a, b0, c40); c41 = _mm256_fmadd_ps(a, b1, c41);
+                a = _mm256_broadcast_ss(Ap + 5); c50 = _mm256_fmadd_ps(a, b0, c50); c51 = _mm256_fmadd_ps(a, b1, c51);
+            }
+            auto store = [ldc](float* c, __m256 lo, __m256 hi, size_t row) {
+                float* r = c + row * ldc;
+                _mm256_storeu_ps(r, _mm256_add_ps(_mm256_loadu_ps(r), lo));
+                _mm256_storeu_ps(r + 8, _mm256_add_ps(_mm256_loadu_ps(r + 8), hi));
+            };
+            store(C, c00, c01, 0); store(C, c10, c11, 1); store(C, c20, c21, 2);
+            store(C, c30, c31, 3); store(C, c40, c41, 4); store(C, c50, c51, 5);
+        }
+
+        inline void kernel_avx2(size_t kc, const double* Ap, const double* Bp, double* C, size_t ldc) {
+            __m256d c00 = _mm256_setzero_pd(), c01 = _mm256_setzero_pd();
+            __m256d c10 = _mm256_setzero_pd(), c11 = _mm256_setzero_pd();
+            __m256d c20 = _mm256_setzero_pd(), c21 = _mm256_setzero_pd();
+            __m256d c30 = _mm256_setzero_pd(), c31 = _mm256_setzero_pd();
+            __m256d c40 = _mm256_setzero_pd(), c41 = _mm256_setzero_pd();
+            __m256d c50 = _mm256_setzero_pd(), c51 = _mm256_setzero_pd();
+            for (size_t p = 0; p < kc; ++p, Ap += 6, Bp += 8) {
+                __m256d b0 = _mm256_loadu_pd(Bp);
+                __m256d b1 = _mm256_loadu_pd(Bp + 4);
+                __m256d a;
+                a = _mm256_broadcast_sd(Ap + 0); c00 = _mm256_fmadd_pd(a, b0, c00); c01 = _mm256_fmadd_pd(a, b1, c01);
+                a = _mm256_broadcast_sd(Ap + 1); c10 = _mm256_fmadd_pd(a, b0, c10); c11 = _mm256_fmadd_pd(a, b1, c11);
+                a = _mm256_broadcast_sd(Ap + 2); c20 = _mm256_fmadd_pd(a, b0, c20); c21 = _mm256_fmadd_pd(a, b1, c21);
+                a = _mm256_broadcast_sd(Ap + 3); c30 = _mm256_fmadd_pd(a, b0, c30); c31 = _mm256_fmadd_pd(a, b1, c31);
+                a = _mm256_broadcast_sd(Ap + 4); c40 = _mm256_fmadd_pd(a, b0, c40); c41 = _mm256_fmadd_pd(a, b1, c41);
+                a = _mm256_broadcast_sd(Ap + 5); c50 = _mm256_fmadd_pd(a, b0, c50); c51 = _mm256_fmadd_pd(a, b1, c51);
+            }
+            auto store = [ldc](double* c, __m256d lo, __m256d hi, size_t row) {
+                double* r = c + row * ldc;
+                _mm256_storeu_pd(r, _mm256_add_pd(_mm256_loadu_pd(r), lo));
+                _mm256_storeu_pd(r + 4, _mm256_add_pd(_mm256_loadu_pd(r + 4), hi));
+            };
+            store(C, c00, c01, 0); store(C, c10, c11, 1); store(C, c20, c21, 2);
+            store(C, c30, c31, 3); store(C, c40, c41, 4); store(C, c50, c51, 5);
+        }
+#endif
+
+        // Tile MR x NR completo: va directo a C; en los bordes pasa por un tile temporal.
+        template <typename T>
+        void micro_tile(size_t kc, const T* Ap, const T* Bp, T* C, size_t ldc, size_t mr, size_t nr) {
+            constexpr size_t MR = KernelShape<T>::MR, NR = KernelShape<T>::NR;
+            auto kernel = [&](T* c, size_t ld) {
+#ifdef UTEC_GEMM_AVX2
+                if constexpr (std::is_same_v<T, float> || std::is_same_v<T, double>)
+                    kernel_avx2(kc, Ap, Bp, c, ld);
+                else
+#endif
+                    kernel_scalar<T, MR, NR>(kc, Ap, Bp, c, ld);
+            };
+            if (mr == MR && nr == NR) {
+                kernel(C, ldc);
+                return;
+            }
+            T tile[MR * NR] = {};
+            kernel(tile, NR);
+            for (size_t i = 0; i < mr; ++i)
+                for (size_t j = 0; j < nr; ++j)
+                    C[i * ldc + j] += tile[i * NR + j];
+        }
+
+        // Acumula W columnas de C en un arreglo local de tamaño fijo para que el compilador lo
+        // mantenga en registros sin preocuparse por aliasing entre B y C. Requiere csb == 1.
+        template <typename T, size_t W, typename Epi>
+        inline void small_strip(size_t k, const T* a, size_t csa, const T* B, size_t rsb, T* c,
+                                size_t col0, bool accumulate, const Epi& epi) {
+            T acc[W] = {};
+            for (size_t p = 0; p < k; ++p) {
+                const T av = a[p * csa];
+                const T* b = B + p * rsb;
+                for (size_t j = 0; j < W; ++j)
+                    acc[j] += av * b[j];
+            }
+            if (accumulate)
+                for (size_t j = 0; j < W; ++j)
+                    c[j] = epi(c[j] + acc[j], col0 + j);
+            else
+                for (size_t j = 0; j < W; ++j)
+                    c[j] = epi(acc[j], col0 + j);
+        }
+
+        // Columnas sueltas (o B transpuesta): producto punto simple.
+        template <typename T>
+        inline T small_dot(size_t k, const T* a, size_t csa, const T* b, size_t rsb) {
+            T s = 0;
+            for (size_t p = 0; p < k; ++p)
+                s += a[p * csa] * b[p * rsb];
+            return s;
+        }
+
+        // Ruta para operandos pequeños (las capas del agente): sin empaquetado, por franjas de
+        // columnas; cada franja recorre todas las filas para no ramificar por fila.
+        template <typename T, typename Epi>
+        void gemm_small(size_t m, size_t n, size_t k,
+                        const T* A, size_t rsa, size_t csa, const size_t* ria,
+                        const T* B, size_t rsb, size_t csb, T* C, size_t ldc,
+                        bool accumulate, const Epi& epi) {
+            auto a_row = [&](size_t i) { return A + (ria ? ria[i] : i) * rsa; };
+            size_t j = 0;
+            if (csb == 1) {
+                constexpr size_t W = 64 / sizeof(T);
+                auto strips = [&](auto width) {
+                    constexpr size_t SW = decltype(width)::value;
+                    for (; j + SW <= n; j += SW)
+                        for (size_t i = 0; i < m; ++i)
+                            small_strip<T, SW>(k, a_row(i), csa, B + j, rsb, C + i * ldc + j,
+                                               j, accumulate, epi);
+                };
+                strips(std::integral_constant<size_t, W>{});
+                strips(std::integral_constant<size_t, W / 2>{});
+                strips(std::integral_constant<size_t, W / 4>{});
+            }
+            for (; j < n; ++j)
+                for (size_t i = 0; i < m; ++i) {
+                    T& c = C[i * ldc + j];
+                    T dot = small_dot(k, a_row(i), csa, B + j * csb, rsb);
+                    c = epi(accumulate ? c + dot : dot, j);
+                }
+        }
+
+        // Núcleo común: A(i, p) = A[r(i) * rsa + p * csa], B(p, j) = B[p * rsb + j * csb].
+        template <typename T, typename Epi = NoEpilogue>
+        void gemm_strided(size_t m, size_t n, size_t k,
+                          const T* A, size_t rsa, size_t csa, const size_t* ria,
+                          const T* B, size_t rsb, size_t csb,
+                          T* C, size_t ldc, bool accumulate, PackBuffers<T>& buf, const Epi& epi = {}) {
+            constexpr bool has_epilogue = !std::is_same_v<Epi, NoEpilogue>;
+            if (m == 0 || n == 0) return;
+
+            if (k != 0 && m * n * k <= SMALL_GEMM_FLOPS) {
+                gemm_small(m, n, k, A, rsa, csa, ria, B, rsb, csb, C, ldc, accumulate, epi);
+                return;
+            }
+
+            if (!accumulate)
+                for (size_t i = 0; i < m; ++i)
+                    std::fill(C + i * ldc, C + i * ldc + n, T(0));
+            if (k == 0) {
+                if constexpr (has_epilogue)
+                    for (size_t i = 0; i < m; ++i)
+                        for (size_t j = 0; j < n; ++j)
+                            C[i * ldc + j] = epi(C[i * ldc + j], j);
+                return;
+            }
+
+            constexpr size_t MR = KernelShape<T>::MR, NR = KernelShape<T>::NR;
+            const size_t nc_max = std::min(NC, (n + NR - 1) / NR * NR);
+            const size_t mc_max = std::min(MC, (m + MR - 1) / MR * MR);
+            if (buf.b.size() < KC * nc_max) buf.b.resize(KC * nc_max);
+            const size_t m_blocks = (m + MC - 1) / MC;
+
+            for (size_t jc = 0; jc < n; jc += NC) {
+                const size_t nc = std::min(NC, n - jc);
+                for (size_t pc = 0; pc < k; pc += KC) {
+                    const size_t kc = std::min(KC, k - pc);
+                    pack_b<T, NR>(kc, nc, B + pc * rsb + jc * csb, rsb, csb, buf.b.data());
+                    const T* Bpack = buf.b.data();
+
+                    // Bloques MC [b0, b1) de A contra el panel de B ya empaquetado. Cada hilo
+                    // empaqueta A en su propio buffer.
+                    auto row_blocks = [&](size_t b0, size_t b1) {
+                        auto& a_buf = pack_buffers<T>().a;
+                        if (a_buf.size() < KC * mc_max) a_buf.resize(KC * mc_max);
+                        T* Apack = a_buf.data();
+                        for (size_t ic = b0 * MC; ic < std::min(m, b1 * MC); ic += MC) {
+                            const size_t mc = std::min(MC, m - ic);
+                            if (ria)
+                                pack_a<T, MR>(mc, kc, A + pc * csa, rsa, csa, ria + ic, Apack);
+                            else
+                                pack_a<T, MR>(mc, kc, A + ic * rsa + pc * csa, rsa, csa, nullptr, Apack);
+                            for (size_t jr = 0; jr < nc; jr += NR) {
+                                const T* Bp = Bpack + jr * kc;
+                                for (size_t ir = 0; ir < mc; ir += MR) {
+                                    const T* Ap = Apack + ir * kc;
+                                    T* Ct = C + (ic + ir) * ldc + jc + jr;
+                                    const size_t mr = std::min(MR, mc - ir), nr = std::min(NR, nc - jr);
+                                    micro_tile(kc, Ap, Bp, Ct, ldc, mr, nr);
+                                    if constexpr (has_epilogue)
+                                        if (pc + kc == k)
+                                            for (size_t i = 0; i < mr; ++i)
+                                                for (size_t j = 0; j < nr; ++j)
+                                                    Ct[i * ldc + j] = epi(Ct[i * ldc + j], jc + jr + j);
+                                }
+                            }
+                        }
+                    };
+                    utec::thread::intra_op::for_tiles(m_blocks, 1, mc_max * nc * kc * m_blocks,
+                                                      PARALLEL_GEMM_FLOPS, row_blocks);
+                }
+            }
+        }
+
+    } // namespace detail
+
+    // C (m x n) = op(A) * op(B), o C += op(A) * op(B) si accumulate es true.
+    // op(A) es m x k y op(B) es k x n; lda/ldb son los leading dimension de A y B tal como
+    // están guardadas (antes de transponer).
+    template <typename T>
+    void gemm(Trans ta, Trans tb, size_t m, size_t n, size_t k,
+              const T* A, size_t lda, const T* B, size_t ldb,
+              T* C, size_t ldc, bool accumulate = false) {
+        const size_t rsa = ta == Trans::No ? lda : 1, csa = ta == Trans::No ? 1 : lda;
+        const size_t rsb = tb == Trans::No ? ldb : 1, csb = tb == Trans::No ? 1 : ldb;
+        detail::PackLease<T> lease;
+        detail::gemm_strided(m, n, k, A, rsa, csa, nullptr, B, rsb, csb, C, ldc, accumulate, lease.get());
+    }
+
+    // C (m x n) = A (m x k) * B (k x n), o C += A * B si accumulate es true.
+    template <typename T>
+    void gemm(size_t m, size_t n, size_t k,
+              const T* A, size_t lda, const T* B, size_t ldb,
+              T* C, size_t ldc, bool accumulate = false) {
+        gemm(Trans::No, Trans::No, m, n, k, A, lda, B, ldb, C, ldc, accumulate);
+    }
+
+    // C = A * B (o C += A * B) sobre vistas. A puede ser transpuesta, un corte o un gather de
+    // filas; B transpuesta o un corte. Los demás casos con índice (gather de columnas) se
+    // reúnen primero en un buffer contiguo por hilo en una sola pasada. C debe tener filas
+    // contiguas.
+    template <typename T, typename Epi = NoEpilogue>
+    void gemm(const TensorView<const T>& A, const TensorView<const T>& B, const TensorView<T>& C,
+              bool accumulate = false, const Epi& epi = {}) {
+        const size_t m = A.rows(), k = A.cols(), n = B.cols();
+        if (B.rows() != k || C.rows() != m || C.cols() != n)
+            throw std::runtime_error("Dimensiones incompatibles para producto");
+        if (!C.rows_contiguous() || C.row_index())
+            throw std::runtime_error("La salida del producto debe tener filas contiguas");
+
+        detail::PackLease<T> lease;
+        auto& buf = lease.get();
+        auto materialize = [](const TensorView<const T>& v, std::vector<T>& storage) {
+            if (storage.size() < v.size()) storage.resize(v.size());
+            copy(v, TensorView<T>(storage.data(), v.rows(), v.cols()));
+            return TensorView<const T>(storage.data(), v.rows(), v.cols());
+        };
+        TensorView<const T> a = A.col_index() ? materialize(A, buf.gather_a) : A;
+        TensorView<const T> b = B.row_index() || B.col_index() ? materialize(B, buf.gather_b) : B;
+        detail::gemm_strided(m, n, k, a.data(), a.row_stride(), a.col_stride(), a.row_index(),
+                             b.data(), b.row_stride(), b.col_stride(), C.data(), C.row_stride(), accumulate, buf, epi);
+    }
+
+} // namespace utec::algebra::gemm
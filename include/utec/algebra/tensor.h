@@ -10,6 +10,9 @@
 #include <iterator>
 #include <algorithm>
 #include <type_traits>
+#include "tensor_view.h"
+#include "tensor_expr.h"
+#include "gemm.h"
 
 namespace utec::algebra {
 
@@ -17,16 +20,26 @@ namespace utec::algebra {
     class Tensor {
     private:
         std::vector<T> data_;
-        std::array<size_t, Rank> shape_;
+        std::array<size_t, Rank> shape_{};
         size_t total_size_ = 1;
 
         template <typename U, size_t R>
         friend Tensor<U, R> transpose_2d(const Tensor<U, R>&);
 
+        template <typename E>
+        Tensor& assign_in_place(const E& e) {
+            if (e.shape() != shape_)
+                throw std::runtime_error("Formas incompatibles en la operación elemento a elemento");
+            auto [rows, cols] = expr::rows_cols(shape_);
+            expr::evaluate(e, data_.data(), rows, cols);
+            return *this;
+        }
+
     public:
         Tensor() = default;
 
         template <typename... Dims>
+            requires (std::is_integral_v<Dims> && ...)
         Tensor(Dims... dims) {
             if (sizeof...(Dims) != Rank)
                 throw std::runtime_error("Dimensiones incorrectas");
@@ -35,10 +48,50 @@ namespace utec::algebra {
             data_.resize(total_size_);
         }
 
+        // Materializa una vista (corte, transpuesta o gather) en un tensor propio.
+        template <typename U>
+            requires (Rank == 2 && std::is_same_v<std::remove_const_t<U>, T>)
+        explicit Tensor(const TensorView<U>& v) : Tensor(v.rows(), v.cols()) {
+            copy(TensorView<const T>(v), view());
+        }
+
+        // Evalúa una expresión elemento a elemento (ver tensor_expr.h) en una sola pasada.
+        template <expr::Expression E>
+            requires (E::rank == Rank && std::is_same_v<typename E::value_type, T>)
+        Tensor(const E& e) : shape_(e.shape()) {
+            for (size_t d : shape_) total_size_ *= d;
+            data_.resize(total_size_);
+            auto [rows, cols] = expr::rows_cols(shape_);
+            expr::evaluate(e, data_.data(), rows, cols);
+        }
+
+        // Con la misma forma evalúa en el lugar, aunque la expresión lea este mismo tensor; con
+        // otra forma, en un buffer nuevo.
+        template <expr::Expression E>
+            requires (E::rank == Rank && std::is_same_v<typename E::value_type, T>)
+        Tensor& operator=(const E& e) {
+            if (e.shape() != shape_) return *this = Tensor(e);
+            return assign_in_place(e);
+        }
+
+        // x puede ser un tensor, una expresión o un escalar, y difundirse sobre este tensor
+        // (p. ej. un bias 1 x N), pero el resultado debe conservar su forma.
+        template <expr::Operand X>
+        Tensor& operator+=(X&& x) { return assign_in_place(*this + std::forward<X>(x)); }
+        template <expr::Operand X>
+        Tensor& operator-=(X&& x) { return assign_in_place(*this - std::forward<X>(x)); }
+        template <expr::Operand X>
+        Tensor& operator*=(X&& x) { return assign_in_place(*this * std::forward<X>(x)); }
+        template <expr::Operand X>
+        Tensor& operator/=(X&& x) { return assign_in_place(*this / std::forward<X>(x)); }
+
         std::array<size_t, Rank> shape() const { return shape_; }
 
         size_t size() const { return total_size_; }
 
+        T* data()             { return data_.data(); }
+        const T* data() const { return data_.data(); }
+
         template <typename... Indices>
         T& operator()(Indices... indices) {
             static_assert(sizeof...(Indices) == Rank, "Número de índices incorrecto");
@@ -62,16 +115,20 @@ namespace utec::algebra {
             return *this;
         }
 
-        // Agregado: operator[] para Tensor 2D
-        Tensor<T, 2> operator[](size_t i) const {
-            static_assert(Rank == 2, "operator[] solo soportado en Tensor 2D");
-            size_t cols = shape_[1];
-            Tensor<T, 2> row(1, cols);
-            for (size_t j = 0; j < cols; ++j)
-                row(0, j) = (*this)(i, j);
-            return row;
+        TensorView<T> view() {
+            static_assert(Rank == 2, "view() solo soportado en Tensor 2D");
+            return {data_.data(), shape_[0], shape_[1]};
+        }
+
+        TensorView<const T> view() const {
+            static_assert(Rank == 2, "view() solo soportado en Tensor 2D");
+            return {data_.data(), shape_[0], shape_[1]};
         }
 
+        // Fila i como vista 1 x N (sin copia); `a[j] = b[i]` copia la fila i de b en la fila j de a.
+        TensorView<T> operator[](size_t i) { return view().row(i); }
+        TensorView<const T> operator[](size_t i) const { return view().row(i); }
+
         template <typename... NewDims>
         void reshape(NewDims... dims) {
             if (sizeof...(NewDims) != Rank)
@@ -127,40 +184,6 @@ namespace utec::algebra {
         auto end()   const       { return data_.end(); }
         auto cbegin() const      { return data_.cbegin(); }
         auto cend()   const      { return data_.cend(); }
-
-        Tensor operator+(T scalar) const {
-            Tensor result = *this;
-            for (T& v : result.data_) v += scalar;
-            return result;
-        }
-        Tensor operator-(T scalar) const {
-            Tensor result = *this;
-            for (T& v : result.data_) v -= scalar;
-            return result;
-        }
-        Tensor operator*(T scalar) const {
-            Tensor result = *this;
-            for (T& v : result.data_) v *= scalar;
-            return result;
-        }
-        Tensor operator/(T scalar) const {
-            Tensor result = *this;
-            for (T& v : result.data_) v /= scalar;
-            return result;
-        }
-
-        friend Tensor operator+(T scalar, const Tensor& t) { return t + scalar; }
-        friend Tensor operator-(T scalar, const Tensor& t) {
-            Tensor result = t;
-            for (T& v : result.data_) v = scalar - v;
-            return result;
-        }
-        friend Tensor operator*(T scalar, const Tensor& t) { return t * scalar; }
-        friend Tensor operator/(T scalar, const Tensor& t) {
-            Tensor result = t;
-            for (T& v : result.data_) v = scalar / v;
-            return result;
-        }
     };
 
     template <typename T, size_t Rank, size_t... Is>
@@ -179,6 +202,12 @@ namespace utec::algebra {
 
         Tensor<T, Rank> result = create_tensor_with_shape<T>(new_shape, std::make_index_sequence<Rank>{});
 
+        // 2D: una pasada por tiles a través de la vista transpuesta, sin decodificar índices.
+        if constexpr (Rank == 2) {
+            copy(t.view().transposed(), result.view());
+            return result;
+        }
+
         std::array<size_t, Rank> idx;
         for (size_t i = 0; i < t.total_size_; ++i) {
             size_t tmp = i;
@@ -199,10 +228,57 @@ namespace utec::algebra {
         if (k1 != k2)
             throw std::runtime_error("Dimensiones incompatibles para producto");
         Tensor<T, 2> result(m, n);
-        for (size_t i = 0; i < m; ++i)
-            for (size_t j = 0; j < n; ++j)
-                for (size_t k = 0; k < k1; ++k)
-                    result(i, j) += a(i, k) * b(k, j);
+        gemm::gemm(m, n, k1, a.data(), k1, b.data(), n, result.data(), n, true);
+        return result;
+    }
+
+    // out = a * b (o out += a * b) sobre vistas: cortes, transpuestas y gathers de filas se leen
+    // directamente por el GEMM.
+    // epi(valor, columna) se aplica a cada elemento de out al terminar su reducción (bias,
+    // activación) sin otra pasada sobre la salida.
+    template <typename TA, typename TB, typename T, typename Epi = gemm::NoEpilogue>
+    void matrix_product(const TensorView<TA>& a, const TensorView<TB>& b, const TensorView<T>& out,
+                        bool accumulate = false, const Epi& epi = {}) {
+        gemm::gemm(TensorView<const T>(a), TensorView<const T>(b), out, accumulate, epi);
+    }
+
+    // out (count x N) = filas indices[0..count) de src, en una sola pasada.
+    template <typename T>
+    void gather_rows(const Tensor<T, 2>& src, const size_t* indices, size_t count, Tensor<T, 2>& out) {
+        copy(src.view().gather_rows(indices, count), out.view());
+    }
+
+    // out = aᵀ * b, leyendo a en su disposición original (sin transpose_2d).
+    template <typename T>
+    void matmul_tn(const Tensor<T, 2>& a, const Tensor<T, 2>& b, Tensor<T, 2>& out) {
+        auto [k1, m] = a.shape();
+        auto [k2, n] = b.shape();
+        if (k1 != k2 || out.shape() != std::array<size_t, 2>{m, n})
+            throw std::runtime_error("Dimensiones incompatibles para producto");
+        gemm::gemm(gemm::Trans::Yes, gemm::Trans::No, m, n, k1, a.data(), m, b.data(), n, out.data(), n);
+    }
+
+    template <typename T>
+    Tensor<T, 2> matmul_tn(const Tensor<T, 2>& a, const Tensor<T, 2>& b) {
+        Tensor<T, 2> result(a.shape()[1], b.shape()[1]);
+        matmul_tn(a, b, result);
+        return result;
+    }
+
+    // out = a * bᵀ, leyendo b en su disposición original (sin transpose_2d).
+    template <typename T>
+    void matmul_nt(const Tensor<T, 2>& a, const Tensor<T, 2>& b, Tensor<T, 2>& out) {
+        auto [m, k1] = a.shape();
+        auto [n, k2] = b.shape();
+        if (k1 != k2 || out.shape() != std::array<size_t, 2>{m, n})
+            throw std::runtime_error("Dimensiones incompatibles para producto");
+        gemm::gemm(gemm::Trans::No, gemm::Trans::Yes, m, n, k1, a.data(), k1, b.data(), k2, out.data(), n);
+    }
+
+    template <typename T>
+    Tensor<T, 2> matmul_nt(const Tensor<T, 2>& a, const Tensor<T, 2>& b) {
+        Tensor<T, 2> result(a.shape()[0], b.shape()[0]);
+        matmul_nt(a, b, result);
         return result;
     }
 
@@ -0,0 +1,315 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace utec::algebra {
+
+    template <typename T, size_t Rank>
+    class Tensor;
+
+    // Expresiones elemento a elemento sobre Tensor que se evalúan al asignarse. `(t * a + b) / c`
+    // no calcula nada: arma un árbol de nodos livianos (referencias a los tensores, escalares y
+    // operaciones) y la asignación a un Tensor lo recorre en un solo bucle fusionado, fila por
+    // fila, con una reserva a lo sumo. Los operandos pueden ser Tensor, otras expresiones o
+    // escalares; un operando 1 x N se difunde sobre cada fila de uno M x N (p. ej. un bias). Los
+    // tensores temporales pasan a ser dueños de su nodo, así que `auto e = f() * 2` no queda
+    // colgando; un Tensor con nombre se referencia y debe vivir hasta evaluar la expresión.
+    struct ExprNode {};
+
+    namespace expr {
+
+        template <typename E>
+        concept Expression = std::is_base_of_v<ExprNode, std::remove_cvref_t<E>>;
+
+        template <typename X>
+        struct is_tensor : std::false_type {};
+        template <typename T, size_t Rank>
+        struct is_tensor<Tensor<T, Rank>> : std::true_type {
+            using value_type = T;
+            static constexpr size_t rank = Rank;
+        };
+
+        template <typename X>
+        concept TensorLike = Expression<X> || is_tensor<std::remove_cvref_t<X>>::value;
+
+        template <typename X>
+        concept Scalar = std::is_arithmetic_v<std::remove_cvref_t<X>>;
+
+        template <typename X>
+        concept Operand = TensorLike<X> || Scalar<X>;
+
+        // Filas y columnas del recorrido: la última dimensión es la fila contigua.
+        template <size_t Rank>
+        std::pair<size_t, size_t> rows_cols(const std::array<size_t, Rank>& shape) {
+            size_t total = 1;
+            for (size_t d : shape) total *= d;
+            const size_t cols = shape[Rank - 1];
+            return {cols == 0 ? 0 : total / cols, cols};
+        }
+
+        // Forma del resultado de combinar dos operandos: iguales, o en 2D uno de ellos 1 x N
+        // frente a M x N.
+        template <size_t Rank>
+        std::array<size_t, Rank> broadcast(const std::array<size_t, Rank>& a, const std::array<size_t, Rank>& b) {
+            if (a == b) return a;
+            if constexpr (Rank == 2) {
+                if (a[1] == b[1] && (a[0] == 1 || b[0] == 1)) return {std::max(a[0], b[0]), a[1]};
+            }
+            throw std::runtime_error("Formas incompatibles en la operación elemento a elemento");
+        }
+
+        // Fila de un operando tensorial. Un operando de una sola fila devuelve siempre la misma,
+        // que es como se difunde sobre las filas del resultado.
+        template <typename T>
+        struct RowPtr {
+            const T* p;
+            T operator[](size_t j) const { return p[j]; }
+        };
+
+        template <typename T, size_t Rank>
+        class Ref : public ExprNode {
+        private:
+            const Tensor<T, Rank>* t_;
+            size_t step_;
+
+        public:
+            using value_type = T;
+            static constexpr size_t rank = Rank;
+
+            explicit Ref(const Tensor<T, Rank>& t) : t_(&t) {
+                auto [rows, cols] = rows_cols(t.shape());
+                step_ = rows == 1 ? 0 : cols;
+            }
+
+            std::array<size_t, Rank> shape() const { return t_->shape(); }
+
+            RowPtr<T> row(size_t i) const { return {t_->data() + i * step_}; }
+            bool broadcasts() const { return step_ == 0; }
+        };
+
+        template <typename T, size_t Rank>
+        class Own : public ExprNode {
+        private:
+            Tensor<T, Rank> t_;
+            size_t step_;
+
+        public:
+            using value_type = T;
+            static constexpr size_t rank = Rank;
+
+            explicit Own(Tensor<T, Rank>&& t) : t_(std::move(t)) {
+                auto [rows, cols] = rows_cols(t_.shape());
+                step_ = rows == 1 ? 0 : cols;
+            }
+
+            std::array<size_t, Rank> shape() const { return t_.shape(); }
+
+            RowPtr<T> row(size_t i) const { return {t_.data() + i * step_}; }
+            bool broadcasts() const { return step_ == 0; }
+        };
+
+        template <typename T>
+        struct Constant {
+            T value;
+
+            struct Row {
+                T value;
+                T operator[](size_t) const { return value; }
+            };
+
+            Row row(size_t) const { return {value}; }
+            bool broadcasts() const { return false; }
+        };
+
+        template <typename Op, typename A>
+        class Unary : public ExprNode {
+        private:
+            A a_;
+            Op op_;
+
+            using ARow = decltype(std::declval<const A&>().row(size_t(0)));
+
+        public:
+            using value_type = typename A::value_type;
+            static constexpr size_t rank = A::rank;
+
+            Unary(A a, Op op) : a_(std::move(a)), op_(std::move(op)) {}
+
+            std::array<size_t, rank> shape() const { return a_.shape(); }
+            bool broadcasts() const { return a_.broadcasts(); }
+
+            auto row(size_t i) const {
+                struct Row {
+                    ARow a;
+                    const Op* op;
+                    value_type operator[](size_t j) const { return (*op)(a[j]); }
+                };
+                return Row{a_.row(i), &op_};
+            }
+        };
+
+        template <typename X>
+        struct is_constant : std::false_type {};
+        template <typename T>
+        struct is_constant<Constant<T>> : std::true_type {};
+
+        // Uno de A o B puede ser un Constant (escalar), nunca los dos.
+        template <typename Op, typename A, typename B>
+        class Binary : public ExprNode {
+        private:
+            using Shaped = std::conditional_t<is_constant<A>::value, B, A>;
+
+            A a_;
+            B b_;
+            Op op_;
+            std::array<size_t, Shaped::rank> shape_;
+
+            using ARow = decltype(std::declval<const A&>().row(size_t(0)));
+            using BRow = decltype(std::declval<const B&>().row(size_t(0)));
+
+        public:
+            using value_type = typename Shaped::value_type;
+            static constexpr size_t rank = Shaped::rank;
+
+            Binary(A a, B b, Op op) : a_(std::move(a)), b_(std::move(b)), op_(std::move(op)) {
+                if constexpr (is_constant<A>::value) {
+                    shape_ = b_.shape();
+                } else if constexpr (is_constant<B>::value) {
+                    shape_ = a_.shape();
+                } else {
+                    static_assert(std::is_same_v<typename A::value_type, typename B::value_type>,
+                                  "Los operandos deben tener el mismo tipo de dato");
+                    static_assert(A::rank == B::rank, "Los operandos deben tener el mismo rango");
+                    shape_ = broadcast(a_.shape(), b_.shape());
+                }
+            }
+
+            std::array<size_t, rank> shape() const { return shape_; }
+
+            bool broadcasts() const { return a_.broadcasts() || b_.broadcasts(); }
+
+            auto row(size_t i) const {
+                struct Row {
+                    ARow a;
+                    BRow b;
+                    const Op* op;
+                    value_type operator[](size_t j) const { return (*op)(a[j], b[j]); }
+                };
+                return Row{a_.row(i), b_.row(i), &op_};
+            }
+        };
+
+        template <typename X>
+        struct value_of {
+            using type = typename std::remove_cvref_t<X>::value_type;
+        };
+        template <typename T, size_t Rank>
+        struct value_of<Tensor<T, Rank>> {
+            using type = T;
+        };
+
+        template <typename X>
+        using value_t = typename value_of<std::remove_cvref_t<X>>::type;
+
+        // Nodo para un operando: referencia a un Tensor con nombre, dueño de un Tensor temporal,
+        // copia (o movida) de una expresión, o constante del tipo de dato V.
+        template <typename V, typename X>
+        auto node(X&& x) {
+            using D = std::remove_cvref_t<X>;
+            if constexpr (Scalar<X>) {
+                return Constant<V>{static_cast<V>(x)};
+            } else if constexpr (Expression<X>) {
+                return D(std::forward<X>(x));
+            } else if constexpr (std::is_lvalue_reference_v<X>) {
+                return Ref<typename is_tensor<D>::value_type, is_tensor<D>::rank>(x);
+            } else {
+                return Own<typename is_tensor<D>::value_type, is_tensor<D>::rank>(std::move(x));
+            }
+        }
+
+        // Tipo de dato del primer operando que no es escalar.
+        template <typename A, typename B>
+        auto common_value() {
+            if constexpr (TensorLike<A>) return value_t<A>{};
+            else return value_t<B>{};
+        }
+
+        template <typename Op, typename A, typename B>
+        auto binary(A&& a, B&& b, Op op = {}) {
+            using V = decltype(common_value<A, B>());
+            auto na = node<V>(std::forward<A>(a));
+            auto nb = node<V>(std::forward<B>(b));
+            return Binary<Op, decltype(na), decltype(nb)>(std::move(na), std::move(nb), std::move(op));
+        }
+
+        // dst (rows x cols, contiguo) = e. El bucle interno solo lee punteros de fila y aplica las
+        // operaciones en línea, así que el compilador lo vectoriza; sin operandos difundidos todo
+        // el tensor es una sola fila larga. dst puede ser uno de los operandos: cada elemento se
+        // lee y escribe en el mismo índice.
+        template <typename T, typename E>
+        void evaluate(const E& e, T* dst, size_t rows, size_t cols) {
+            if (rows > 1 && !e.broadcasts()) {
+                cols *= rows;
+                rows = 1;
+            }
+            for (size_t i = 0; i < rows; ++i) {
+                const auto r = e.row(i);
+                T* out = dst + i * cols;
+                for (size_t j = 0; j < cols; ++j) out[j] = r[j];
+            }
+        }
+
+    }
+
+    template <typename A, typename B>
+        requires (expr::Operand<A> && expr::Operand<B> && (expr::TensorLike<A> || expr::TensorLike<B>))
+    auto operator+(A&& a, B&& b) { return expr::binary<std::plus<>>(std::forward<A>(a), std::forward<B>(b)); }
+
+    template <typename A, typename B>
+        requires (expr::Operand<A> && expr::Operand<B> && (expr::TensorLike<A> || expr::TensorLike<B>))
+    auto operator-(A&& a, B&& b) { return expr::binary<std::minus<>>(std::forward<A>(a), std::forward<B>(b)); }
+
+    template <typename A, typename B>
+        requires (expr::Operand<A> && expr::Operand<B> && (expr::TensorLike<A> || expr::TensorLike<B>))
+    auto operator*(A&& a, B&& b) { return expr::binary<std::multiplies<>>(std::forward<A>(a), std::forward<B>(b)); }
+
+    template <typename A, typename B>
+        requires (expr::Operand<A> && expr::Operand<B> && (expr::TensorLike<A> || expr::TensorLike<B>))
+    auto operator/(A&& a, B&& b) { return expr::binary<std::divides<>>(std::forward<A>(a), std::forward<B>(b)); }
+
+    // f(x) sobre cada elemento.
+    template <expr::TensorLike A, typename F>
+    auto map(A&& a, F f) {
+        auto na = expr::node<expr::value_t<A>>(std::forward<A>(a));
+        return expr::Unary<F, decltype(na)>(std::move(na), std::move(f));
+    }
+
+    template <expr::TensorLike A>
+    auto operator-(A&& a) { return map(std::forward<A>(a), std::negate<>{}); }
+
+    // f(x, y) sobre los pares de elementos, con las mismas reglas de forma que los operadores.
+    template <expr::TensorLike A, expr::TensorLike B, typename F>
+    auto map(A&& a, B&& b, F f) {
+        return expr::binary<F>(std::forward<A>(a), std::forward<B>(b), std::move(f));
+    }
+
+    // Suma de todos los elementos de una expresión, en la misma pasada y sin materializarla.
+    template <expr::TensorLike A>
+    auto sum(A&& a) {
+        auto na = expr::node<expr::value_t<A>>(std::forward<A>(a));
+        auto [rows, cols] = expr::rows_cols(na.shape());
+        expr::value_t<A> total = 0;
+        for (size_t i = 0; i < rows; ++i) {
+            const auto r = na.row(i);
+            for (size_t j = 0; j < cols; ++j) total += r[j];
+        }
+        return total;
+    }
+
+}
@@ -0,0 +1,157 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <algorithm>
+#include <stdexcept>
+#include <type_traits>
+
+namespace utec::algebra {
+
+    // Vista 2D sin propiedad sobre memoria ajena. El elemento (i, j) vive en
+    // data[r(i) * row_stride + c(j) * col_stride], donde r/c son la identidad o un
+    // arreglo de índices (gather). Así se expresan cortes de filas, transposiciones y
+    // minibatches por índice sin copiar. T puede ser const.
+    template <typename T>
+    class TensorView {
+    private:
+        T* data_ = nullptr;
+        size_t rows_ = 0, cols_ = 0;
+        size_t row_stride_ = 0, col_stride_ = 1;
+        const size_t* row_index_ = nullptr;
+        const size_t* col_index_ = nullptr;
+
+        template <typename U>
+        friend class TensorView;
+
+    public:
+        TensorView() = default;
+
+        TensorView(T* data, size_t rows, size_t cols)
+                : data_(data), rows_(rows), cols_(cols), row_stride_(cols) {}
+
+        TensorView(T* data, size_t rows, size_t cols, size_t row_stride, size_t col_stride,
+                   const size_t* row_index = nullptr, const size_t* col_index = nullptr)
+                : data_(data), rows_(rows), cols_(cols), row_stride_(row_stride), col_stride_(col_stride),
+                  row_index_(row_index), col_index_(col_index) {}
+
+        // Vista mutable -> vista de solo lectura.
+        template <typename U, typename = std::enable_if_t<std::is_same_v<const U, T> && !std::is_const_v<U>>>
+        TensorView(const TensorView<U>& o)
+                : data_(o.data_), rows_(o.rows_), cols_(o.cols_), row_stride_(o.row_stride_),
+                  col_stride_(o.col_stride_), row_index_(o.row_index_), col_index_(o.col_index_) {}
+
+        TensorView(const TensorView&) = default;
+        TensorView(TensorView&&) = default;
+
+        // Asignar a una vista con nombre la re-apunta; asignar a una vista temporal copia los
+        // elementos, de modo que `batch[j] = X[i]` copia la fila i de X en la fila j de batch.
+        TensorView& operator=(const TensorView&) & = default;
+        TensorView& operator=(TensorView&&) & = default;
+
+        template <typename U>
+        const TensorView& operator=(const TensorView<U>& src) && {
+            assign(src);
+            return *this;
+        }
+
+        size_t rows() const { return rows_; }
+        size_t cols() const { return cols_; }
+        std::array<size_t, 2> shape() const { return {rows_, cols_}; }
+        size_t size() const { return rows_ * cols_; }
+
+        T* data() const { return data_; }
+        size_t row_stride() const { return row_stride_; }
+        size_t col_stride() const { return col_stride_; }
+        const size_t* row_index() const { return row_index_; }
+        const size_t* col_index() const { return col_index_; }
+
+        size_t row_offset(size_t i) const { return (row_index_ ? row_index_[i] : i) * row_stride_; }
+        size_t col_offset(size_t j) const { return (col_index_ ? col_index_[j] : j) * col_stride_; }
+
+        T& operator()(size_t i, size_t j) const { return data_[row_offset(i) + col_offset(j)]; }
+
+        // Filas contiguas (col_stride 1, sin índice de columnas): cada fila es un bloque plano.
+        bool rows_contiguous() const { return col_stride_ == 1 && !col_index_; }
+
+        bool contiguous() const { return rows_contiguous() && !row_index_ && (rows_ <= 1 || row_stride_ == cols_); }
+
+        T* row_ptr(size_t i) const { return data_ + row_offset(i); }
+
+        TensorView row(size_t i) const { return slice_rows(i, 1); }
+
+        TensorView slice_rows(size_t begin, size_t count) const {
+            if (begin + count > rows_)
+                throw std::runtime_error("Corte de filas fuera de rango");
+            if (row_index_)
+                return {data_, count, cols_, row_stride_, col_stride_, row_index_ + begin, col_index_};
+            return {data_ + begin * row_stride_, count, cols_, row_stride_, col_stride_, nullptr, col_index_};
+        }
+
+        // Filas indices[0..count) de esta vista; el arreglo debe vivir tanto como la vista.
+        TensorView gather_rows(const size_t* indices, size_t count) const {
+            if (row_index_)
+                throw std::runtime_error("La vista ya tiene un índice de filas");
+            return {data_, count, cols_, row_stride_, col_stride_, indices, col_index_};
+        }
+
+        TensorView transposed() const {
+            return {data_, cols_, rows_, col_stride_, row_stride_, col_index_, row_index_};
+        }
+
+        void fill(const T& value) const {
+            for (size_t i = 0; i < rows_; ++i) {
+                T* r = row_ptr(i);
+                if (rows_contiguous())
+                    std::fill(r, r + cols_, value);
+                else
+                    for (size_t j = 0; j < cols_; ++j) r[col_offset(j)] = value;
+            }
+        }
+
+        template <typename U>
+        void assign(const TensorView<U>& src) const;
+    };
+
+    // Copia elemento a elemento entre vistas de igual forma en una sola pasada. Las filas
+    // contiguas se copian en bloque; las transposiciones puras van por tiles para no
+    // recorrer la fuente a saltos de una línea de caché por elemento.
+    template <typename T>
+    void copy(const TensorView<const T>& src, const TensorView<T>& dst) {
+        if (src.shape() != dst.shape())
+            throw std::runtime_error("Formas incompatibles en copia");
+        const size_t m = src.rows(), n = src.cols();
+        if (src.rows_contiguous() && dst.rows_contiguous()) {
+            for (size_t i = 0; i < m; ++i)
+                std::copy(src.row_ptr(i), src.row_ptr(i) + n, dst.row_ptr(i));
+            return;
+        }
+        if (!src.row_index() && !src.col_index() && src.row_stride() == 1 && dst.contiguous()) {
+            constexpr size_t TILE = 16;
+            const T* s = src.data();
+            T* d = dst.data();
+            const size_t cs = src.col_stride();
+            for (size_t i0 = 0; i0 < m; i0 += TILE)
+                for (size_t j0 = 0; j0 < n; j0 += TILE) {
+                    const size_t ie = std::min(m, i0 + TILE), je = std::min(n, j0 + TILE);
+                    for (size_t j = j0; j < je; ++j)
+                        for (size_t i = i0; i < ie; ++i)
+                            d[i * n + j] = s[i + j * cs];
+                }
+            return;
+        }
+        for (size_t i = 0; i < m; ++i)
+            for (size_t j = 0; j < n; ++j)
+                dst(i, j) = src(i, j);
+    }
+
+    template <typename T>
+    template <typename U>
+    void TensorView<T>::assign(const TensorView<U>& src) const {
+        static_assert(!std::is_const_v<T>, "No se puede escribir en una vista de solo lectura");
+        copy(TensorView<const std::remove_const_t<U>>(src.data_, src.rows_, src.cols_, src.row_stride_,
+                                                      src.col_stride_, src.row_index_, src.col_index_),
+             *this);
+    }
+
+}
@@ -0,0 +1,460 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace utec::metrics {
+
+    struct MetricsConfig {
+        std::string csv_path;                              // vacío: sin CSV
+        std::string jsonl_path;                            // vacío: sin JSON lines
+        std::ostream* console = nullptr;                   // nullptr: sin resumen en consola
+        std::chrono::milliseconds flush_every{1000};
+        std::chrono::milliseconds console_every{5000};
+    };
+
+    // Límites superiores de los cubos de un histograma: start, start + width, ...
+    inline std::vector<double> linear_bounds(double start, double width, size_t n) {
+        std::vector<double> b(n);
+        for (size_t i = 0; i < n; ++i) b[i] = start + width * double(i);
+        return b;
+    }
+
+    // start, start·factor, start·factor², ...
+    inline std::vector<double> exponential_bounds(double start, double factor, size_t n) {
+        std::vector<double> b(n);
+        for (size_t i = 0; i < n; ++i) b[i] = start * std::pow(factor, double(i));
+        return b;
+    }
+
+    class Metrics;
+
+    // Suma monótona, p. ej. episodios o pasos; el resumen incluye su tasa por segundo.
+    class Counter {
+    private:
+        Metrics* metrics_ = nullptr;
+        size_t id_ = 0;
+
+    public:
+        Counter() = default;
+        Counter(Metrics* metrics, size_t id) : metrics_(metrics), id_(id) {}
+
+        void add(uint64_t n = 1) const;
+        size_t id() const { return id_; }
+    };
+
+    // Último valor asignado, desde cualquier hilo.
+    class Gauge {
+    private:
+        std::atomic<double>* value_ = nullptr;
+        size_t id_ = 0;
+
+    public:
+        Gauge() = default;
+        Gauge(std::atomic<double>* value, size_t id) : value_(value), id_(id) {}
+
+        void set(double v) const { value_->store(v, std::memory_order_relaxed); }
+        size_t id() const { return id_; }
+    };
+
+    // Distribución por cubos de límites fijos, con conteo, suma, mínimo y máximo.
+    class Histogram {
+    private:
+        Metrics* metrics_ = nullptr;
+        size_t id_ = 0;
+        const double* bounds_ = nullptr;
+        size_t buckets_ = 0;
+
+    public:
+        Histogram() = default;
+        Histogram(Metrics* metrics, size_t id, const std::vector<double>& bounds)
+                : metrics_(metrics), id_(id), bounds_(bounds.data()), buckets_(bounds.size()) {}
+
+        void record(double v) const;
+        size_t id() const { return id_; }
+    };
+
+    // Serie de eventos poco frecuentes (p. ej. el winrate de cada bloque de episodios): cada
+    // valor se conserva con su instante y sale como fila propia en el volcado siguiente, así
+    // que varios eventos de una misma ventana no se pisan como en un Gauge. Registrar toma un
+    // lock; no es para el bucle caliente.
+    class Series {
+    private:
+        Metrics* metrics_ = nullptr;
+        size_t id_ = 0;
+
+    public:
+        Series() = default;
+        Series(Metrics* metrics, size_t id) : metrics_(metrics), id_(id) {}
+
+        void record(double v) const;
+        size_t id() const { return id_; }
+    };
+
+    // Métricas de entrenamiento fuera del camino crítico. Cada hilo registra en su propio
+    // buffer (contadores y cubos de histograma con un solo escritor, sin locks ni operaciones
+    // atómicas de lectura-modificación-escritura), así que registrar una muestra cuesta unos
+    // pocos ns. Un hilo de fondo suma los buffers cada flush_every y escribe una fila por
+    // métrica al CSV y una línea JSON por volcado; cada console_every imprime una línea de
+    // resumen. Los totales de una ventana se calculan como diferencia con el volcado anterior.
+    // Los buffers de los hilos que terminan se conservan hasta destruir el objeto.
+    class Metrics {
+    public:
+        static constexpr size_t MAX_COUNTERS = 32;
+        static constexpr size_t MAX_GAUGES = 32;
+        static constexpr size_t MAX_HISTOGRAMS = 16;
+        static constexpr size_t MAX_BUCKETS = 32;
+        static constexpr size_t MAX_SERIES = 16;
+
+        struct HistogramTotals {
+            std::vector<uint64_t> buckets;   // bounds.size() + 1: el último recoge lo que excede
+            uint64_t count = 0;
+            double sum = 0;
+            double min = std::numeric_limits<double>::infinity();
+            double max = -std::numeric_limits<double>::infinity();
+        };
+
+        // Suma de todos los hilos, indexada por el id de cada métrica.
+        struct Totals {
+            std::chrono::steady_clock::time_point at;
+            std::vector<uint64_t> counters;
+            std::vector<double> gauges;                  // NaN: nunca asignado
+            std::vector<HistogramTotals> histograms;
+        };
+
+    private:
+        friend class Counter;
+        friend class Histogram;
+        friend class Series;
+
+        struct Event {
+            size_t id;
+            std::chrono::steady_clock::time_point at;
+            double value;
+        };
+
+        struct HistogramCells {
+            std::array<std::atomic<uint64_t>, MAX_BUCKETS + 1> buckets{};
+            std::atomic<uint64_t> count{0};
+            std::atomic<double> sum{0};
+            std::atomic<double> min{std::numeric_limits<double>::infinity()};
+            std::atomic<double> max{-std::numeric_limits<double>::infinity()};
+        };
+
+        struct alignas(64) ThreadBuffer {
+            std::array<std::atomic<uint64_t>, MAX_COUNTERS> counters{};
+            std::array<HistogramCells, MAX_HISTOGRAMS> histograms;
+        };
+
+        // Solo el hilo dueño escribe la celda; el volcado la lee con relaxed, así que puede ver
+        // el conteo de un histograma sin su suma, que llega en el volcado siguiente.
+        template <typename V>
+        static void bump(std::atomic<V>& cell, V v) {
+            cell.store(cell.load(std::memory_order_relaxed) + v, std::memory_order_relaxed);
+        }
+
+        static uint64_t next_id() {
+            static std::atomic<uint64_t> id{0};
+            return ++id;
+        }
+
+        const uint64_t id_ = next_id();
+        MetricsConfig config_;
+        std::chrono::steady_clock::time_point start_ = std::chrono::steady_clock::now();
+
+        mutable std::mutex mutex_;
+        std::vector<std::string> counter_names_, gauge_names_, histogram_names_, series_names_;
+        std::array<std::vector<double>, MAX_HISTOGRAMS> bounds_;
+        std::array<std::atomic<double>, MAX_GAUGES> gauges_;
+        std::vector<std::unique_ptr<ThreadBuffer>> buffers_;
+
+        std::mutex events_mutex_;
+        std::vector<Event> events_;              // eventos de Series aún no volcados
+
+        std::mutex flush_mutex_;
+        std::ofstream csv_, jsonl_;
+        Totals last_;
+        std::chrono::steady_clock::time_point last_console_ = start_;
+
+        std::mutex stop_mutex_;
+        std::condition_variable stop_cv_;
+        bool stop_ = false;
+        std::thread flusher_;
+
+        // Buffer de este hilo, que se crea la primera vez. La caché es por hilo y compartida
+        // entre instancias; los ids no se reutilizan, así que una entrada vieja nunca coincide.
+        ThreadBuffer& local() {
+            struct Entry {
+                uint64_t owner;
+                ThreadBuffer* buffer;
+            };
+            thread_local std::vector<Entry> cache;
+            for (const Entry& e : cache)
+                if (e.owner == id_) return *e.buffer;
+            std::lock_guard lock(mutex_);
+            buffers_.push_back(std::make_unique<ThreadBuffer>());
+            cache.push_back({id_, buffers_.back().get()});
+            return *buffers_.back();
+        }
+
+        static size_t find_or_add(std::vector<std::string>& names, const std::string& name, size_t max,
+                                  const char* kind) {
+            auto it = std::find(names.begin(), names.end(), name);
+            if (it != names.end()) return size_t(it - names.begin());
+            if (names.size() == max)
+                throw std::runtime_error(std::string("Demasiados ") + kind + " registrados");
+            names.push_back(name);
+            return names.size() - 1;
+        }
+
+        // Límite superior del cubo donde la ventana acumula la fracción q de sus muestras,
+        // acotado por el máximo observado.
+        static double quantile(const std::vector<uint64_t>& window, const std::vector<double>& bounds,
+                               uint64_t count, double q, double max) {
+            const double target = q * double(count);
+            uint64_t acc = 0;
+            for (size_t i = 0; i < window.size(); ++i) {
+                acc += window[i];
+                if (double(acc) >= target && acc > 0) return i < bounds.size() ? std::min(bounds[i], max) : max;
+            }
+            return max;
+        }
+
+        static std::string number(double v) {
+            std::ostringstream os;
+            os << std::setprecision(6) << v;
+            return os.str();
+        }
+
+        // Métricas de la ventana entre prev y now, en el formato de cada salida.
+        void write(const Totals& now, const Totals& prev, const std::vector<Event>& events, bool console) {
+            const double seconds = std::chrono::duration<double>(now.at - start_).count();
+            const double dt = std::max(std::chrono::duration<double>(now.at - prev.at).count(), 1e-9);
+            const std::string t = number(seconds);
+            std::ostringstream json, line;
+            json << "{\"segundos\": " << t;
+            line << "[" << std::fixed << std::setprecision(1) << seconds << " s]" << std::defaultfloat;
+            const char* sep = " ";
+
+            json << ", \"contadores\": {";
+            for (size_t i = 0; i < now.counters.size(); ++i) {
+                const uint64_t before = i < prev.counters.size() ? prev.counters[i] : 0;
+                const double rate = double(now.counters[i] - before) / dt;
+                if (csv_.is_open())
+                    csv_ << t << ",\"" << counter_names_[i] << "\",contador," << now.counters[i] << ','
+                         << number(rate) << ",,,,,,\n";
+                json << (i ? ", " : "") << '"' << counter_names_[i] << "\": {\"total\": " << now.counters[i]
+                     << ", \"por_segundo\": " << number(rate) << '}';
+                line << sep << counter_names_[i] << ' ' << now.counters[i] << " (" << number(rate) << "/s)";
+                sep = " | ";
+            }
+
+            json << "}, \"medidores\": {";
+            bool first = true;
+            for (size_t i = 0; i < now.gauges.size(); ++i) {
+                if (std::isnan(now.gauges[i])) continue;
+                if (csv_.is_open())
+                    csv_ << t << ",\"" << gauge_names_[i] << "\",medidor," << number(now.gauges[i]) << ",,,,,,,\n";
+                json << (first ? "" : ", ") << '"' << gauge_names_[i] << "\": " << number(now.gauges[i]);
+                line << sep << gauge_names_[i] << ' ' << number(now.gauges[i]);
+                sep = " | ";
+                first = false;
+            }
+
+            json << "}, \"histogramas\": {";
+            first = true;
+            for (size_t i = 0; i < now.histograms.size(); ++i) {
+                const HistogramTotals& h = now.histograms[i];
+                const HistogramTotals empty;
+                const HistogramTotals& p = i < prev.histograms.size() ? prev.histograms[i] : empty;
+                const uint64_t count = h.count - p.count;
+                if (count == 0) continue;
+                std::vector<uint64_t> window(h.buckets.size());
+                for (size_t k = 0; k < window.size(); ++k)
+                    window[k] = h.buckets[k] - (k < p.buckets.size() ? p.buckets[k] : 0);
+                const std::string mean = number((h.sum - p.sum) / double(count));
+                const std::string p50 = number(quantile(window, bounds_[i], count, 0.5, h.max));
+                const std::string p90 = number(quantile(window, bounds_[i], count, 0.9, h.max));
+                if (csv_.is_open())
+                    csv_ << t << ",\"" << histogram_names_[i] << "\",histograma,,," << count << ',' << mean << ','
+                         << number(h.min) << ',' << number(h.max) << ',' << p50 << ',' << p90 << "\n";
+                json << (first ? "" : ", ") << '"' << histogram_names_[i] << "\": {\"conteo\": " << count
+                     << ", \"media\": " << mean << ", \"min\": " << number(h.min) << ", \"max\": " << number(h.max)
+                     << ", \"p50\": " << p50 << ", \"p90\": " << p90 << '}';
+                line << sep << histogram_names_[i] << " media " << mean << " p90 " << p90 << " (n=" << count << ")";
+                sep = " | ";
+                first = false;
+            }
+            json << "}, \"eventos\": [";
+            std::vector<const Event*> last(series_names_.size(), nullptr);
+            for (size_t e = 0; e < events.size(); ++e) {
+                const Event& ev = events[e];
+                const std::string at = number(std::chrono::duration<double>(ev.at - start_).count());
+                if (csv_.is_open())
+                    csv_ << at << ",\"" << series_names_[ev.id] << "\",evento," << number(ev.value) << ",,,,,,,\n";
+                json << (e ? ", " : "") << "{\"metrica\": \"" << series_names_[ev.id] << "\", \"segundos\": " << at
+                     << ", \"valor\": " << number(ev.value) << '}';
+                last[ev.id] = &ev;
+            }
+            for (size_t i = 0; i < last.size(); ++i) {
+                if (!last[i]) continue;
+                line << sep << series_names_[i] << ' ' << number(last[i]->value);
+                sep = " | ";
+            }
+            json << "]}\n";
+
+            if (csv_.is_open()) csv_.flush();
+            if (jsonl_.is_open()) jsonl_ << json.str() << std::flush;
+            if (console && config_.console) *config_.console << line.str() << std::endl;
+        }
+
+        void flush(bool force_console) {
+            std::lock_guard lock(flush_mutex_);
+            Totals now = totals();
+            std::vector<Event> events;
+            {
+                std::lock_guard events_lock(events_mutex_);
+                events.swap(events_);
+            }
+            const bool console = force_console || now.at - last_console_ >= config_.console_every;
+            write(now, last_, events, console);
+            if (console) last_console_ = now.at;
+            last_ = std::move(now);
+        }
+
+        void flusher_loop() {
+            std::unique_lock lock(stop_mutex_);
+            while (!stop_cv_.wait_for(lock, config_.flush_every, [this] { return stop_; })) {
+                lock.unlock();
+                flush(false);
+                lock.lock();
+            }
+        }
+
+    public:
+        explicit Metrics(MetricsConfig config = {}) : config_(std::move(config)) {
+            for (auto& g : gauges_) g.store(std::numeric_limits<double>::quiet_NaN(), std::memory_order_relaxed);
+            if (!config_.csv_path.empty()) {
+                csv_.open(config_.csv_path);
+                if (!csv_)
+                    throw std::runtime_error("No se pudo escribir las métricas en " + config_.csv_path);
+                csv_ << "segundos,metrica,tipo,valor,por_segundo,conteo,media,min,max,p50,p90\n";
+            }
+            if (!config_.jsonl_path.empty()) {
+                jsonl_.open(config_.jsonl_path);
+                if (!jsonl_)
+                    throw std::runtime_error("No se pudo escribir las métricas en " + config_.jsonl_path);
+            }
+            last_.at = start_;
+            if (config_.flush_every.count() > 0) flusher_ = std::thread([this] { flusher_loop(); });
+        }
+
+        // Detiene el hilo de fondo y hace un último volcado, con resumen en consola.
+        ~Metrics() {
+            {
+                std::lock_guard lock(stop_mutex_);
+                stop_ = true;
+            }
+            stop_cv_.notify_all();
+            if (flusher_.joinable()) flusher_.join();
+            flush(true);
+        }
+
+        Metrics(const Metrics&) = delete;
+        Metrics& operator=(const Metrics&) = delete;
+
+        // Registrar devuelve la métrica existente si el nombre ya está; hacerlo fuera del bucle
+        // caliente y guardar el handle, que es válido mientras viva el objeto.
+        Counter counter(const std::string& name) {
+            std::lock_guard lock(mutex_);
+            return {this, find_or_add(counter_names_, name, MAX_COUNTERS, "contadores")};
+        }
+
+        Gauge gauge(const std::string& name) {
+            std::lock_guard lock(mutex_);
+            size_t id = find_or_add(gauge_names_, name, MAX_GAUGES, "medidores");
+            return {&gauges_[id], id};
+        }
+
+        // bounds: límites superiores crecientes de los cubos (el valor v va al primero con
+        // v <= límite); un cubo extra recoge lo que los excede.
+        Histogram histogram(const std::string& name, const std::vector<double>& bounds) {
+            if (bounds.empty() || bounds.size() > MAX_BUCKETS || !std::is_sorted(bounds.begin(), bounds.end()))
+                throw std::runtime_error("Límites de histograma inválidos para " + name);
+            std::lock_guard lock(mutex_);
+            size_t id = find_or_add(histogram_names_, name, MAX_HISTOGRAMS, "histogramas");
+            if (bounds_[id].empty()) bounds_[id] = bounds;
+            else if (bounds_[id] != bounds)
+                throw std::runtime_error("El histograma " + name + " ya existe con otros límites");
+            return {this, id, bounds_[id]};
+        }
+
+        Series series(const std::string& name) {
+            std::lock_guard lock(mutex_);
+            return {this, find_or_add(series_names_, name, MAX_SERIES, "series")};
+        }
+
+        Totals totals() const {
+            std::lock_guard lock(mutex_);
+            Totals t;
+            t.at = std::chrono::steady_clock::now();
+            t.counters.assign(counter_names_.size(), 0);
+            t.gauges.resize(gauge_names_.size());
+            for (size_t i = 0; i < t.gauges.size(); ++i) t.gauges[i] = gauges_[i].load(std::memory_order_relaxed);
+            t.histograms.resize(histogram_names_.size());
+            for (size_t i = 0; i < t.histograms.size(); ++i) t.histograms[i].buckets.assign(bounds_[i].size() + 1, 0);
+            for (const auto& b : buffers_) {
+                for (size_t i = 0; i < t.counters.size(); ++i) t.counters[i] += b->counters[i].load(std::memory_order_relaxed);
+                for (size_t i = 0; i < t.histograms.size(); ++i) {
+                    const HistogramCells& c = b->histograms[i];
+                    HistogramTotals& h = t.histograms[i];
+                    for (size_t k = 0; k < h.buckets.size(); ++k) h.buckets[k] += c.buckets[k].load(std::memory_order_relaxed);
+                    h.count += c.count.load(std::memory_order_relaxed);
+                    h.sum += c.sum.load(std::memory_order_relaxed);
+                    h.min = std::min(h.min, c.min.load(std::memory_order_relaxed));
+                    h.max = std::max(h.max, c.max.load(std::memory_order_relaxed));
+                }
+            }
+            return t;
+        }
+
+        // Volcado inmediato, además de los periódicos; el resumen en consola sigue limitado.
+        void flush() { flush(false); }
+    };
+
+    inline void Counter::add(uint64_t n) const {
+        Metrics::bump(metrics_->local().counters[id_], n);
+    }
+
+    inline void Series::record(double v) const {
+        std::lock_guard lock(metrics_->events_mutex_);
+        metrics_->events_.push_back({id_, std::chrono::steady_clock::now(), v});
+    }
+
+    inline void Histogram::record(double v) const {
+        auto& c = metrics_->local().histograms[id_];
+        const size_t k = size_t(std::lower_bound(bounds_, bounds_ + buckets_, v) - bounds_);
+        Metrics::bump(c.buckets[k], uint64_t(1));
+        Metrics::bump(c.count, uint64_t(1));
+        Metrics::bump(c.sum, v);
+        if (v < c.min.load(std::memory_order_relaxed)) c.min.store(v, std::memory_order_relaxed);
+        if (v > c.max.load(std::memory_order_relaxed)) c.max.store(v, std::memory_order_relaxed);
+    }
+
+}
@@ -5,29 +5,374 @@
 #include <random>
 #include <algorithm>
 #include <fstream>
+#include <iomanip>
+#include <limits>
 #include "tensor.h"
 #include "nn_dense.h"
 #include "nn_activation.h"
 #include "nn_loss.h"
 #include "nn_optimizer.h"
+#include "nn_workspace.h"
+#include "nn_inference.h"
+#include "nn_model_file.h"
+#include "nn_profiler.h"
+#include "utec/thread/IntraOp.h"
+#include "utec/random/Philox.h"
 
 namespace utec::neural_network {
 
     template<typename T>
     class NeuralNetwork {
     private:
+        using ConstView = utec::algebra::TensorView<const T>;
+        using View = utec::algebra::TensorView<T>;
+
         std::vector<std::unique_ptr<ILayer<T>>> layers_;
+        ParameterBuffer<T> buffer_;
+        Workspace<T> workspace_;
+        std::vector<size_t> cols_;
+        std::vector<bool> in_place_;
+        std::unique_ptr<InferencePlan<T>> plan_;
+        std::unique_ptr<model_file::MappedModel> mapped_;
+
+        // Entrenamiento en paralelo de datos: la red misma es la réplica 0 y replicas_ guarda
+        // las demás, con capas clonadas y su propio workspace. params_[r] lista los parámetros
+        // de la réplica r en el mismo orden para todas.
+        size_t data_parallel_ = 1;
+        std::vector<std::unique_ptr<NeuralNetwork>> replicas_;
+        std::vector<std::vector<ParamRef<T>>> params_;
+        std::vector<T> shard_loss_;
+
+        // Sitios del perfilador (forward, backward, update) de cada capa; solo con PONG_PROFILE.
+        std::vector<std::array<size_t, 3>> sites_;
+
+        // Orden de los minibatches de train: un flujo Philox por red (semilla global), así que
+        // el orden es reproducible y no se vuelve a sembrar en cada llamada.
+        utec::random::Stream shuffle_rng_{utec::random::next_stream(utec::random::Domain::Shuffle)};
+
+        void ensure_sites() {
+            if (sites_.size() == layers_.size()) return;
+            sites_.clear();
+            for (size_t i = 0; i < layers_.size(); ++i)
+                sites_.push_back(profiler::layer_sites(i, *layers_[i]));
+        }
+
+        // Replanifica la arena solo si el lote no cabe o cambió la topología. Una capa corre en
+        // el lugar si lo admite y la anterior no necesita conservar su salida para el backward.
+        void ensure_workspace(size_t rows, size_t input_cols) {
+            cols_.resize(layers_.size() + 1);
+            in_place_.resize(layers_.size());
+            cols_[0] = input_cols;
+            for (size_t i = 0; i < layers_.size(); ++i) {
+                cols_[i + 1] = layers_[i]->output_cols(cols_[i]);
+                in_place_[i] = layers_[i]->in_place() && cols_[i + 1] == cols_[i] &&
+                               (i == 0 || !layers_[i - 1]->keeps_output());
+            }
+            if (!workspace_.fits(rows, cols_, in_place_))
+                workspace_.plan(std::max(rows, workspace_.capacity_rows()), cols_, in_place_);
+            if constexpr (profiler::enabled) ensure_sites();
+        }
+
+        // Forward desde la activación 0 (ya cargada con el lote).
+        ConstView run_forward(size_t rows) {
+            for (size_t i = 0; i < layers_.size(); ++i) {
+                UTEC_PROFILE_SITE(sites_[i][0], profiler::layer_cost(*layers_[i], profiler::Phase::Forward, rows, cols_[i]));
+                layers_[i]->forward_into(workspace_.activation(i, rows), workspace_.activation(i + 1, rows));
+            }
+            return workspace_.activation(layers_.size(), rows);
+        }
+
+        // Backward desde el gradiente de la salida guardado en el slot 0; las capas en el lugar
+        // sobrescriben el gradiente entrante en vez de alternar de buffer.
+        void run_backward(size_t rows) {
+            size_t slot = 0;
+            for (size_t k = layers_.size(); k-- > 0;) {
+                size_t next = in_place_[k] ? slot : slot + 1;
+                View dx = k == 0 ? View() : workspace_.gradient(next, rows, cols_[k]);
+                UTEC_PROFILE_SITE(sites_[k][1], profiler::layer_cost(*layers_[k], profiler::Phase::Backward, rows, cols_[k]));
+                layers_[k]->backward_into(workspace_.gradient(slot, rows, cols_[k + 1]), dx);
+                slot = next;
+            }
+        }
+
+        template <typename LossType>
+        static T loss_gradient_into(const ConstView& pred, const ConstView& target, const View& grad) {
+            UTEC_PROFILE_SCOPE("pérdida", profiler::Cost{3 * pred.rows() * pred.cols(),
+                                                         3 * sizeof(T) * pred.rows() * pred.cols()});
+            if constexpr (requires { LossType::gradient_into(pred, target, grad); }) {
+                return LossType::gradient_into(pred, target, grad);
+            } else {
+                LossType loss_fn{Tensor<T,2>(pred), Tensor<T,2>(target)};
+                auto g = loss_fn.loss_gradient();
+                utec::algebra::copy(std::as_const(g).view(), grad);
+                return loss_fn.loss();
+            }
+        }
+
+        // Paso completo sobre el lote cargado en la activación 0 y el objetivo del workspace.
+        template <typename LossType>
+        T step_loaded(size_t rows, IOptimizer<T>& optimizer) {
+            ConstView output = run_forward(rows);
+            T loss = loss_gradient_into<LossType>(output, workspace_.target(rows),
+                                                  workspace_.gradient(0, rows, cols_.back()));
+            run_backward(rows);
+            update(optimizer);
+            return loss;
+        }
+
+        // Mueve los parámetros de las capas con flat_parameters() a un buffer_ nuevo, en orden de
+        // capas, para que un paso del optimizador sea una sola pasada sobre memoria contigua.
+        // Los valores se conservan; las vistas anteriores a los parámetros dejan de ser válidas.
+        void pack_parameters() {
+            ParameterBuffer<T> buffer;
+            std::vector<std::vector<ParamRef<T>>> old(layers_.size());
+            for (size_t i = 0; i < layers_.size(); ++i) {
+                if (!layers_[i]->flat_parameters()) continue;
+                layers_[i]->parameters(old[i]);
+                for (const auto& p : old[i]) buffer.add(p.value.rows(), p.value.cols());
+            }
+            size_t segment = 0;
+            std::vector<ParamRef<T>> bound;
+            for (size_t i = 0; i < layers_.size(); ++i) {
+                if (old[i].empty()) continue;
+                bound.clear();
+                for (const auto& p : old[i]) {
+                    ParamRef<T> ref{buffer.value(segment), buffer.grad(segment)};
+                    ++segment;
+                    utec::algebra::copy(utec::algebra::TensorView<const T>(p.value), ref.value);
+                    bound.push_back(ref);
+                }
+                layers_[i]->bind_parameters(bound.data());
+            }
+            buffer_ = std::move(buffer);
+        }
+
+        NeuralNetwork& replica(size_t r) { return r == 0 ? *this : *replicas_[r - 1]; }
+
+        void ensure_replicas() {
+            if (replicas_.size() + 1 == data_parallel_) return;
+            replicas_.clear();
+            for (size_t r = 1; r < data_parallel_; ++r)
+                replicas_.push_back(clone());
+            params_.assign(data_parallel_, {});
+            for (size_t r = 0; r < data_parallel_; ++r)
+                replica(r).parameters(params_[r]);
+        }
+
+        // Suma en árbol de los gradientes de las réplicas [0, shards) sobre la réplica 0: en
+        // cada nivel los pares (k, k + stride) se combinan en paralelo. El orden de las sumas
+        // solo depende de shards, así que el resultado es reproducible.
+        void all_reduce(size_t shards) {
+            UTEC_PROFILE_SCOPE("all-reduce");
+            for (size_t stride = 1; stride < shards; stride *= 2) {
+                const size_t pairs = (shards - stride + 2 * stride - 1) / (2 * stride);
+                utec::thread::intra_op::pool().parallel_for(0, pairs, 1, [&](size_t p0, size_t p1) {
+                    for (size_t p = p0; p < p1; ++p) {
+                        auto& dst = params_[2 * stride * p];
+                        auto& src = params_[2 * stride * p + stride];
+                        for (size_t i = 0; i < dst.size(); ++i) {
+                            T* d = dst[i].grad.data();
+                            const T* s = src[i].grad.data();
+                            const size_t n = dst[i].grad.size();
+                            for (size_t j = 0; j < n; ++j) d[j] += s[j];
+                        }
+                    }
+                }, pairs - 1);
+            }
+        }
+
+        // Paso síncrono sobre un lote de rows filas repartido en tramos contiguos entre las
+        // réplicas. load(net, begin, count) carga las filas [begin, begin + count) del lote en
+        // la activación 0 y el objetivo de net. Cada réplica copia los pesos de la 0, hace
+        // forward y backward sobre su tramo con el gradiente de la pérdida escalado por
+        // count / rows (las pérdidas promedian sobre su lote), y tras el all-reduce la réplica
+        // 0 aplica un solo paso del optimizador.
+        template <typename LossType, typename Load>
+        T step_data_parallel(size_t rows, size_t input_cols, IOptimizer<T>& optimizer, Load&& load) {
+            ensure_replicas();
+            const size_t shards = std::min(data_parallel_, rows);
+            shard_loss_.resize(shards);
+            utec::thread::intra_op::pool().parallel_for(0, shards, 1, [&](size_t s0, size_t s1) {
+                for (size_t s = s0; s < s1; ++s) {
+                    NeuralNetwork& net = replica(s);
+                    if (s != 0)
+                        for (size_t i = 0; i < params_[0].size(); ++i) {
+                            const auto& w = params_[0][i].value;
+                            std::copy(w.data(), w.data() + w.size(), params_[s][i].value.data());
+                        }
+
+                    const size_t begin = rows * s / shards;
+                    const size_t count = rows * (s + 1) / shards - begin;
+                    net.ensure_workspace(count, input_cols);
+                    load(net, begin, count);
+
+                    ConstView output = net.run_forward(count);
+                    View grad = net.workspace_.gradient(0, count, net.cols_.back());
+                    const T share = T(count) / T(rows);
+                    shard_loss_[s] = share * loss_gradient_into<LossType>(output, net.workspace_.target(count), grad);
+                    for (size_t i = 0; i < grad.rows(); ++i)
+                        for (size_t j = 0; j < grad.cols(); ++j) grad(i, j) *= share;
+                    net.run_backward(count);
+                }
+            }, shards - 1);
+
+            all_reduce(shards);
+            update(optimizer);
+            T loss = 0;
+            for (size_t s = 0; s < shards; ++s) loss += shard_loss_[s];
+            return loss;
+        }
 
     public:
         void add_layer(std::unique_ptr<ILayer<T>> layer) {
             layers_.emplace_back(std::move(layer));
+            pack_parameters();
+            plan_.reset();
+            mapped_.reset();
+            replicas_.clear();
+            sites_.clear();
+        }
+
+        // Número de réplicas para train y train_batch; 1 (por defecto) entrena en serie. Las
+        // réplicas se crean en el primer paso y todas las capas deben implementar clone().
+        void set_data_parallel(size_t replicas) {
+            data_parallel_ = std::max<size_t>(1, replicas);
+            replicas_.clear();
+        }
+
+        size_t data_parallel() const { return data_parallel_; }
+
+        // Red independiente con copias de las capas y los mismos pesos (sin plan ni réplicas).
+        // Todas las capas deben implementar clone().
+        std::unique_ptr<NeuralNetwork> clone() const {
+            auto net = std::make_unique<NeuralNetwork>();
+            for (const auto& layer : layers_) {
+                auto copy = layer->clone();
+                if (!copy)
+                    throw std::runtime_error("La capa no admite réplicas para el entrenamiento en paralelo");
+                net->layers_.push_back(std::move(copy));
+            }
+            net->pack_parameters();
+            return net;
+        }
+
+        std::vector<LayerKind> layer_kinds() const {
+            std::vector<LayerKind> kinds;
+            for (const auto& layer : layers_) kinds.push_back(layer->kind());
+            return kinds;
+        }
+
+        // Buffer plano con los parámetros y gradientes de las capas que lo admiten (todas las Dense).
+        const ParameterBuffer<T>& parameter_buffer() const { return buffer_; }
+
+        // Parámetros entrenables de todas las capas, en orden.
+        void parameters(std::vector<ParamRef<T>>& out) {
+            for (auto& layer : layers_) layer->parameters(out);
+        }
+
+        // Plan de inferencia nuevo sobre las capas de la red, con sus propios buffers y enlazado a
+        // los pesos actuales. Las columnas de entrada salen de la primera Dense. No reemplaza al
+        // de compile(): sirve para evaluar desde otro hilo con bind() a otra copia de los pesos.
+        std::unique_ptr<InferencePlan<T>> make_plan(size_t max_rows = 1) const {
+            size_t input_cols = 0;
+            for (const auto& layer : layers_) {
+                if (layer->kind() == LayerKind::Dense) {
+                    input_cols = static_cast<const Dense<T>*>(layer.get())->in_features();
+                    break;
+                }
+                if (layer->kind() == LayerKind::Custom) break;
+            }
+            if (input_cols == 0)
+                throw std::runtime_error("No se puede deducir la entrada de la red para compilarla");
+            return std::make_unique<InferencePlan<T>>(layers_, input_cols, max_rows);
+        }
+
+        // Arma el plan de inferencia fusionado para lotes de hasta max_rows filas; add_layer
+        // descarta el plan.
+        void compile(size_t max_rows = 1) {
+            plan_ = make_plan(max_rows);
+            mapped_.reset();
+        }
+
+        bool compiled() const { return plan_ != nullptr; }
+
+        // Compila la red y enlaza el plan a los pesos de un modelo binario mapeado en memoria,
+        // sin copiarlos. Solo para inferencia: las capas conservan sus propios pesos, así que
+        // entrenar no cambia lo que ve el plan; compile() o load_model() vuelven a los de las capas.
+        void map_model(const std::string& filename, size_t max_rows = 1) {
+            auto model = std::make_unique<model_file::MappedModel>(filename);
+            model->check(layers_);
+            compile(max_rows);
+            plan_->bind(model->template parameters<T>());
+            mapped_ = std::move(model);
+        }
+
+        bool mapped() const { return mapped_ != nullptr; }
+
+        // Inferencia por el plan compilado o, si no lo hay, sobre la arena. La vista devuelta es
+        // válida hasta la siguiente llamada.
+        ConstView infer(const ConstView& X) {
+            if (plan_) {
+                UTEC_PROFILE_SCOPE("inferencia (plan)");
+                return plan_->run(X);
+            }
+            ensure_workspace(X.rows(), X.cols());
+            utec::algebra::copy(X, workspace_.activation(0, X.rows()));
+            return run_forward(X.rows());
+        }
+
+        // Primera salida para una sola fila; requiere compile().
+        T score(const T* x) {
+            if (!plan_)
+                throw std::runtime_error("La red no está compilada");
+            UTEC_PROFILE_SCOPE("inferencia (plan)");
+            return plan_->score(x);
         }
 
         Tensor<T,2> predict(const Tensor<T,2>& X) {
-            Tensor<T,2> output = X;
-            for (auto& layer : layers_)
-                output = layer->forward(output);
-            return output;
+            return Tensor<T,2>(infer(X.view()));
+        }
+
+        // Forward de entrenamiento: las capas guardan vistas a la arena para el backward.
+        ConstView forward_batch(const ConstView& X) {
+            ensure_workspace(X.rows(), X.cols());
+            utec::algebra::copy(X, workspace_.activation(0, X.rows()));
+            return run_forward(X.rows());
+        }
+
+        // Backward a partir de dL/dY del último forward_batch.
+        void backward_batch(const ConstView& grad_output) {
+            utec::algebra::copy(grad_output, workspace_.gradient(0, grad_output.rows(), cols_.back()));
+            run_backward(grad_output.rows());
+        }
+
+        // Un paso del optimizador: una pasada sobre buffer_ y update_params solo para las capas
+        // que guardan sus propios parámetros.
+        void update(IOptimizer<T>& optimizer) {
+            UTEC_PROFILE_SCOPE("optimizador", profiler::Cost{2 * buffer_.size(), 3 * sizeof(T) * buffer_.size()});
+            if (!buffer_.empty())
+                optimizer.update(buffer_);
+            if constexpr (profiler::enabled) ensure_sites();
+            for (size_t i = 0; i < layers_.size(); ++i) {
+                if (layers_[i]->flat_parameters()) continue;
+                UTEC_PROFILE_SITE(sites_[i][2], profiler::layer_cost(*layers_[i], profiler::Phase::Update, 0, 0));
+                layers_[i]->update_params(optimizer);
+            }
+        }
+
+        // Un paso de descenso sobre un lote; devuelve la pérdida antes de actualizar.
+        template <typename LossType = MSELoss<T>>
+        T train_batch(const ConstView& X, const ConstView& Y, IOptimizer<T>& optimizer) {
+            if (data_parallel_ > 1)
+                return step_data_parallel<LossType>(X.rows(), X.cols(), optimizer,
+                                                     [&](NeuralNetwork& net, size_t begin, size_t count) {
+                    utec::algebra::copy(X.slice_rows(begin, count), net.workspace_.activation(0, count));
+                    utec::algebra::copy(Y.slice_rows(begin, count), net.workspace_.target(count));
+                });
+            ensure_workspace(X.rows(), X.cols());
+            utec::algebra::copy(X, workspace_.activation(0, X.rows()));
+            utec::algebra::copy(Y, workspace_.target(Y.rows()));
+            return step_loaded<LossType>(X.rows(), optimizer);
         }
 
         template <typename LossType = MSELoss<T>, typename OptimizerType = SGD<T>>
@@ -35,59 +380,78 @@ namespace utec::neural_network {
                    size_t epochs, size_t batch_size, T learning_rate) {
 
             size_t n_samples = X.shape()[0];
+            if (n_samples == 0 || batch_size == 0) return;
 
             OptimizerType optimizer(learning_rate);
 
             std::vector<size_t> indices(n_samples);
             std::iota(indices.begin(), indices.end(), 0);
 
-            std::mt19937 rng(std::random_device{}());
+            // La arena se planifica una vez para el lote completo; cada minibatch se reúne
+            // directamente en ella desde X e Y (en modo paralelo, cada tramo en su réplica).
+            ensure_workspace(std::min(batch_size, n_samples), X.shape()[1]);
 
             for (size_t epoch = 0; epoch < epochs; ++epoch) {
-                std::shuffle(indices.begin(), indices.end(), rng);
+                std::shuffle(indices.begin(), indices.end(), shuffle_rng_);
 
                 for (size_t i = 0; i < n_samples; i += batch_size) {
                     size_t current_batch = std::min(batch_size, n_samples - i);
 
-                    Tensor<T,2> X_batch(current_batch, X.shape()[1]);
-                    Tensor<T,2> Y_batch(current_batch, Y.shape()[1]);
-
-                    for (size_t j = 0; j < current_batch; ++j) {
-                        X_batch[j] = X[indices[i + j]];
-                        Y_batch[j] = Y[indices[i + j]];
+                    if (data_parallel_ > 1) {
+                        step_data_parallel<LossType>(current_batch, X.shape()[1], optimizer,
+                                                     [&](NeuralNetwork& net, size_t begin, size_t count) {
+                            utec::algebra::copy(X.view().gather_rows(&indices[i + begin], count),
+                                                net.workspace_.activation(0, count));
+                            utec::algebra::copy(Y.view().gather_rows(&indices[i + begin], count),
+                                                net.workspace_.target(count));
+                        });
+                        continue;
                     }
 
-                    Tensor<T,2> output = X_batch;
-                    for (auto& layer : layers_)
-                        output = layer->forward(output);
-
-                    LossType loss_fn(output, Y_batch);
-                    Tensor<T,2> grad = loss_fn.loss_gradient();
-
-                    for (int k = layers_.size() - 1; k >= 0; --k)
-                        grad = layers_[k]->backward(grad);
+                    utec::algebra::copy(X.view().gather_rows(&indices[i], current_batch),
+                                        workspace_.activation(0, current_batch));
+                    utec::algebra::copy(Y.view().gather_rows(&indices[i], current_batch),
+                                        workspace_.target(current_batch));
 
-                    for (auto& layer : layers_)
-                        layer->update_params(optimizer);
+                    step_loaded<LossType>(current_batch, optimizer);
                 }
             }
         }
 
+        // Modelo binario versionado (ver nn_model_file.h). load_model lanza si el archivo no
+        // corresponde a la topología o el tipo de dato de la red.
         void save_model(const std::string& filename) const {
-            std::ofstream out(filename);
-            for (const auto& layer : layers_) {
-                auto* d = dynamic_cast<Dense<T>*>(layer.get());
-                if (d) d->save(out);
-            }
+            model_file::save(filename, layers_);
         }
 
         void load_model(const std::string& filename) {
-            std::ifstream in(filename);
-            for (const auto& layer : layers_) {
-                auto* d = dynamic_cast<Dense<T>*>(layer.get());
-                if (d) d->load(in);
+            model_file::load(filename, layers_);
+            if (mapped_) {
+                std::vector<ParamRef<T>> params;
+                parameters(params);
+                std::vector<const T*> weights;
+                for (const auto& p : params) weights.push_back(p.value.data());
+                plan_->bind(weights);
+                mapped_.reset();
             }
         }
+
+        // Exportación en texto (el formato anterior de pesos.txt): todos los pesos de cada
+        // Dense en decimal, sin forma ni tipo, así que no detecta topologías distintas.
+        void export_text(const std::string& filename) const {
+            std::ofstream out(filename);
+            out << std::setprecision(std::numeric_limits<T>::max_digits10);
+            for (const auto& layer : layers_)
+                if (layer->kind() == LayerKind::Dense)
+                    static_cast<const Dense<T>*>(layer.get())->save(out);
+        }
+
+        void import_text(const std::string& filename) {
+            std::ifstream in(filename);
+            for (const auto& layer : layers_)
+                if (layer->kind() == LayerKind::Dense)
+                    static_cast<Dense<T>*>(layer.get())->load(in);
+        }
     };
 
 }
@@ -1,59 +1,152 @@
 #pragma once
 #include "nn_interfaces.h"
 #include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
 
 namespace utec {
     namespace neural_network {
 
+        namespace detail {
+
+            // Aplica f(in, out, n) fila por fila; las vistas de la arena tienen filas contiguas y el
+            // bucle interno se vectoriza. out puede coincidir con in (capa en el lugar).
+            template<typename T, typename F>
+            void map_rows(const utec::algebra::TensorView<const T>& in,
+                          const utec::algebra::TensorView<T>& out, F f) {
+                if (in.rows_contiguous() && out.rows_contiguous()) {
+                    for (size_t i = 0; i < out.rows(); ++i)
+                        f(in.row_ptr(i), out.row_ptr(i), out.cols());
+                    return;
+                }
+                for (size_t i = 0; i < out.rows(); ++i)
+                    for (size_t j = 0; j < out.cols(); ++j) {
+                        T v = in(i, j), r;
+                        f(&v, &r, 1);
+                        out(i, j) = r;
+                    }
+            }
+
+            // Igual que map_rows con dos entradas: f(a, b, out, n).
+            template<typename T, typename F>
+            void map_rows(const utec::algebra::TensorView<const T>& a,
+                          const utec::algebra::TensorView<const T>& b,
+                          const utec::algebra::TensorView<T>& out, F f) {
+                if (a.rows_contiguous() && b.rows_contiguous() && out.rows_contiguous()) {
+                    for (size_t i = 0; i < out.rows(); ++i)
+                        f(a.row_ptr(i), b.row_ptr(i), out.row_ptr(i), out.cols());
+                    return;
+                }
+                for (size_t i = 0; i < out.rows(); ++i)
+                    for (size_t j = 0; j < out.cols(); ++j) {
+                        T va = a(i, j), vb = b(i, j), r;
+                        f(&va, &vb, &r, 1);
+                        out(i, j) = r;
+                    }
+            }
+
+            template<typename T>
+            struct relu_op {
+                T operator()(T v) const { return v > T(0) ? v : T(0); }
+            };
+
+            template<typename T>
+            struct sigmoid_op {
+                T operator()(T v) const { return T(1) / (T(1) + std::exp(-v)); }
+            };
+
+        } // namespace detail
+
+        // Dentro de NeuralNetwork corre en el lugar sobre el buffer de la capa anterior y guarda
+        // solo una vista a su salida (y > 0 <=> z > 0). Fuera de la red guarda una máscara de un
+        // bit por elemento en vez de una copia de la entrada.
         template<typename T>
         class ReLU final : public ILayer<T> {
         private:
-            utec::algebra::Tensor<T,2> cached_;
+            std::vector<uint64_t> mask_;
+            utec::algebra::TensorView<const T> output_view_;
         public:
             utec::algebra::Tensor<T,2> forward(const utec::algebra::Tensor<T,2>& z) override {
-                cached_ = z;
                 utec::algebra::Tensor<T,2> out = z;
-                std::transform(z.cbegin(), z.cend(), out.begin(),
-                               [](T val) { return val > T(0) ? val : T(0); });
+                const size_t n = out.size();
+                mask_.assign((n + 63) / 64, 0);
+                T* o = out.data();
+                for (size_t i = 0; i < n; ++i) {
+                    bool pos = o[i] > T(0);
+                    mask_[i >> 6] |= uint64_t(pos) << (i & 63);
+                    o[i] = pos ? o[i] : T(0);
+                }
                 return out;
             }
 
             utec::algebra::Tensor<T,2> backward(const utec::algebra::Tensor<T,2>& g) override {
                 utec::algebra::Tensor<T,2> grad = g;
-                auto c_it = cached_.cbegin();
-                auto g_it = g.cbegin();
-                auto grad_it = grad.begin();
-                for (size_t i = 0; i < grad.size(); ++i, ++c_it, ++g_it, ++grad_it) {
-                    *grad_it = (*c_it > T(0)) ? *g_it : T(0);
-                }
+                T* d = grad.data();
+                for (size_t i = 0; i < grad.size(); ++i)
+                    if (!((mask_[i >> 6] >> (i & 63)) & 1)) d[i] = T(0);
                 return grad;
             }
+
+            bool in_place() const override { return true; }
+            bool keeps_output() const override { return true; }
+            LayerKind kind() const override { return LayerKind::ReLU; }
+            std::unique_ptr<ILayer<T>> clone() const override { return std::make_unique<ReLU>(); }
+
+            void forward_into(const utec::algebra::TensorView<const T>& z,
+                              const utec::algebra::TensorView<T>& out) override {
+                detail::map_rows(z, out, [](const T* in, T* o, size_t n) {
+                    for (size_t j = 0; j < n; ++j) o[j] = detail::relu_op<T>{}(in[j]);
+                });
+                output_view_ = out;
+            }
+
+            void backward_into(const utec::algebra::TensorView<const T>& g,
+                               const utec::algebra::TensorView<T>& grad) override {
+                detail::map_rows(output_view_, g, grad, [](const T* y, const T* dy, T* dx, size_t n) {
+                    for (size_t j = 0; j < n; ++j) dx[j] = y[j] > T(0) ? dy[j] : T(0);
+                });
+            }
         };
 
         template<typename T>
         class Sigmoid final : public ILayer<T> {
         private:
             utec::algebra::Tensor<T,2> cached_;
+            utec::algebra::TensorView<const T> output_view_;
         public:
             utec::algebra::Tensor<T,2> forward(const utec::algebra::Tensor<T,2>& z) override {
-                cached_ = z;
-                utec::algebra::Tensor<T,2> out = z;
-                std::transform(z.cbegin(), z.cend(), out.begin(),
-                               [](T val) { return T(1) / (T(1) + std::exp(-val)); });
-                cached_ = out;
-                return out;
+                if (cached_.shape() != z.shape())
+                    cached_ = utec::algebra::Tensor<T,2>(z.shape()[0], z.shape()[1]);
+                forward_into(z.view(), cached_.view());
+                return cached_;
             }
 
             utec::algebra::Tensor<T,2> backward(const utec::algebra::Tensor<T,2>& g) override {
                 utec::algebra::Tensor<T,2> grad = g;
-                auto c_it = cached_.cbegin();
-                auto g_it = g.cbegin();
-                auto grad_it = grad.begin();
-                for (size_t i = 0; i < grad.size(); ++i, ++c_it, ++g_it, ++grad_it) {
-                    *grad_it = (*c_it) * (T(1) - *c_it) * (*g_it);
-                }
+                backward_into(g.view(), grad.view());
                 return grad;
             }
+
+            bool in_place() const override { return true; }
+            bool keeps_output() const override { return true; }
+            LayerKind kind() const override { return LayerKind::Sigmoid; }
+            std::unique_ptr<ILayer<T>> clone() const override { return std::make_unique<Sigmoid>(); }
+
+            void forward_into(const utec::algebra::TensorView<const T>& z,
+                              const utec::algebra::TensorView<T>& out) override {
+                detail::map_rows(z, out, [](const T* in, T* o, size_t n) {
+                    for (size_t j = 0; j < n; ++j) o[j] = detail::sigmoid_op<T>{}(in[j]);
+                });
+                output_view_ = out;
+            }
+
+            void backward_into(const utec::algebra::TensorView<const T>& g,
+                               const utec::algebra::TensorView<T>& grad) override {
+                detail::map_rows(output_view_, g, grad, [](const T* s, const T* dy, T* dx, size_t n) {
+                    for (size_t j = 0; j < n; ++j) dx[j] = s[j] * (T(1) - s[j]) * dy[j];
+                });
+            }
         };
 
     } // namespace neural_network
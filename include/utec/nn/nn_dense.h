@@ -1,7 +1,9 @@
 #pragma once
 
 #include "nn_interfaces.h"
+#include "nn_parameters.h"
 #include "tensor.h"
+#include "utec/thread/IntraOp.h"
 #include <functional>
 #include <random>
 #include <fstream>
@@ -15,22 +17,43 @@ namespace utec::neural_network {
     class Dense : public ILayer<T> {
     private:
         using Tensor2D = utec::algebra::Tensor<T, 2>;
+        using ConstView = utec::algebra::TensorView<const T>;
+        using View = utec::algebra::TensorView<T>;
 
-        Tensor2D W_;
-        Tensor2D b_;
+        // W, b y sus gradientes son vistas: a own_ mientras la capa está sola y al buffer plano
+        // de la red desde que NeuralNetwork la agrega (bind_parameters). En ambos casos b sigue
+        // a W en el mismo buffer, así que update_params es una sola pasada del optimizador.
+        ParameterBuffer<T> own_;
+        View W_;
+        View b_;
+        View dW_;
+        View db_;
         Tensor2D input_;
-        Tensor2D dW_;
-        Tensor2D db_;
+        ConstView input_view_;
         InitFunc<T> weight_init_;
         InitFunc<T> bias_init_;
 
+        static constexpr size_t PARALLEL_ELEMS = 1 << 16;
+        static constexpr size_t BIAS_GRAIN = 64;
+
+        void allocate_own(size_t in, size_t out) {
+            own_.add(in, out);
+            own_.add(1, out);
+            W_ = own_.value(0);
+            dW_ = own_.grad(0);
+            b_ = own_.value(1);
+            db_ = own_.grad(1);
+        }
+
     public:
         Dense(size_t in, size_t out, InitFunc<T> w_init, InitFunc<T> b_init)
-                : W_(in, out), b_(1, out),
-                  dW_(in, out), db_(1, out),
-                  weight_init_(w_init), bias_init_(b_init) {
-            weight_init_(W_);
-            bias_init_(b_);
+                : weight_init_(w_init), bias_init_(b_init) {
+            allocate_own(in, out);
+            Tensor2D W(in, out), b(1, out);
+            weight_init_(W);
+            bias_init_(b);
+            std::copy(W.begin(), W.end(), W_.data());
+            std::copy(b.begin(), b.end(), b_.data());
         }
 
         // Constructor por defecto simplificado
@@ -39,42 +62,95 @@ namespace utec::neural_network {
                         [](auto& W) { W.fill(0.1); },
                         [](auto& b) { b.fill(0); }) {}
 
+        // La copia (clone) tiene su propio buffer con los mismos pesos.
+        Dense(const Dense& o)
+                : input_(o.input_), weight_init_(o.weight_init_), bias_init_(o.bias_init_) {
+            allocate_own(o.in_features(), o.out_features());
+            std::copy(o.W_.data(), o.W_.data() + o.W_.size(), W_.data());
+            std::copy(o.b_.data(), o.b_.data() + o.b_.size(), b_.data());
+        }
+
+        Dense& operator=(const Dense&) = delete;
+
         Tensor2D forward(const Tensor2D& input) override {
             input_ = input;
-            auto z = utec::algebra::matrix_product(input, W_);
-            for (size_t i = 0; i < z.shape()[0]; ++i)
-                for (size_t j = 0; j < z.shape()[1]; ++j)
-                    z(i, j) += b_(0, j);
+            Tensor2D z(input.shape()[0], W_.cols());
+            forward_into(std::as_const(input_).view(), z.view());
             return z;
         }
 
         Tensor2D backward(const Tensor2D& grad_output) override {
-            auto input_T = utec::algebra::transpose_2d(input_);
-            dW_ = utec::algebra::matrix_product(input_T, grad_output);
+            Tensor2D grad_input(grad_output.shape()[0], W_.rows());
+            backward_into(grad_output.view(), grad_input.view());
+            return grad_input;
+        }
+
+        size_t output_cols(size_t) const override { return W_.cols(); }
+
+        LayerKind kind() const override { return LayerKind::Dense; }
+
+        std::unique_ptr<ILayer<T>> clone() const override { return std::make_unique<Dense>(*this); }
+
+        void parameters(std::vector<ParamRef<T>>& out) override {
+            out.push_back({W_, dW_});
+            out.push_back({b_, db_});
+        }
+
+        bool flat_parameters() const override { return true; }
+
+        void bind_parameters(const ParamRef<T>* params) override {
+            W_ = params[0].value;
+            dW_ = params[0].grad;
+            b_ = params[1].value;
+            db_ = params[1].grad;
+            own_.clear();
+        }
+
+        size_t in_features() const { return W_.rows(); }
+        size_t out_features() const { return W_.cols(); }
+        ConstView weights() const { return W_; }
+        ConstView bias() const { return b_; }
+
+        void forward_into(const ConstView& input, const View& z) override {
+            input_view_ = input;
+            const T* b = b_.data();
+            utec::algebra::matrix_product(input, ConstView(W_), z, false,
+                                          [b](T v, size_t j) { return v + b[j]; });
+        }
+
+        void backward_into(const ConstView& grad_output, const View& grad_input) override {
+            utec::algebra::matrix_product(input_view_.transposed(), grad_output, dW_);
 
+            // db por tiras de columnas: cada columna la suma un solo hilo, siempre en orden de filas.
             db_.fill(0);
-            for (size_t i = 0; i < grad_output.shape()[0]; ++i)
-                for (size_t j = 0; j < grad_output.shape()[1]; ++j)
-                    db_(0, j) += grad_output(i, j);
+            T* db = db_.data();
+            const size_t rows = grad_output.rows(), cols = grad_output.cols();
+            utec::thread::intra_op::for_tiles(cols, BIAS_GRAIN, rows * cols, PARALLEL_ELEMS,
+                                              [&](size_t j0, size_t j1) {
+                for (size_t i = 0; i < rows; ++i)
+                    for (size_t j = j0; j < j1; ++j)
+                        db[j] += grad_output(i, j);
+            });
 
-            auto W_T = utec::algebra::transpose_2d(W_);
-            return utec::algebra::matrix_product(grad_output, W_T);
+            if (grad_input.rows() != 0)
+                utec::algebra::matrix_product(grad_output, ConstView(W_).transposed(), grad_input);
         }
 
+        // Solo para la capa suelta: dentro de una red el optimizador recorre el buffer de la red.
         void update_params(IOptimizer<T>& optimizer) override {
-            optimizer.update(W_, dW_);
-            optimizer.update(b_, db_);
+            if (!own_.empty()) optimizer.update(own_);
+            else optimizer.update(W_.data(), dW_.data(), size_t(b_.data() + b_.size() - W_.data()));
         }
 
         void save(std::ostream& out) const {
-            for (const auto& v : W_) out << v << " ";
-            for (const auto& v : b_) out << v << " ";
+            for (size_t i = 0; i < W_.size(); ++i) out << W_.data()[i] << " ";
+            for (size_t i = 0; i < b_.size(); ++i) out << b_.data()[i] << " ";
             out << "\n";
         }
 
         void load(std::istream& in) {
-            for (auto& v : W_) in >> v;
-            for (auto& v : b_) in >> v;
+            for (size_t i = 0; i < W_.size(); ++i) in >> W_.data()[i];
+            for (size_t i = 0; i < b_.size(); ++i) in >> b_.data()[i];
         }
     };
 
@@ -0,0 +1,158 @@
+#pragma once
+
+#include <memory>
+#include <stdexcept>
+#include <vector>
+#include "nn_dense.h"
+#include "nn_activation.h"
+#include "aligned_allocator.h"
+
+namespace utec::neural_network {
+
+    // Plan de inferencia plano que arma NeuralNetwork::compile() recorriendo las capas una vez.
+    // Cada Dense seguida de ReLU/Sigmoid se vuelve un solo GEMM cuyo epílogo suma el bias y
+    // aplica la activación sobre el tile de salida; las demás capas conocidas corren sin
+    // llamadas virtuales y solo las capas propias pasan por forward_into. Los buffers se
+    // reservan al compilar. El plan guarda punteros a los pesos de cada Dense, así que ve las
+    // actualizaciones del optimizador y solo deja de ser válido si cambian las capas.
+    template <typename T>
+    class InferencePlan {
+    private:
+        using ConstView = utec::algebra::TensorView<const T>;
+        using View = utec::algebra::TensorView<T>;
+
+        enum class Op { Dense, DenseReLU, DenseSigmoid, ReLU, Sigmoid, Layer };
+
+        struct Step {
+            Op op;
+            size_t in_cols, out_cols;
+            const T* W = nullptr;
+            const T* b = nullptr;
+            ILayer<T>* layer = nullptr;
+        };
+
+        std::vector<Step> steps_;
+        std::vector<T, utec::algebra::AlignedAllocator<T>> buffers_[2];
+        size_t input_cols_ = 0, max_cols_ = 0, max_rows_ = 0;
+
+        void reserve(size_t rows) {
+            max_rows_ = rows;
+            for (auto& buf : buffers_) buf.assign(rows * max_cols_, T(0));
+        }
+
+    public:
+        InferencePlan(const std::vector<std::unique_ptr<ILayer<T>>>& layers, size_t input_cols, size_t max_rows)
+                : input_cols_(input_cols) {
+            size_t cols = input_cols;
+            for (size_t i = 0; i < layers.size(); ++i) {
+                ILayer<T>* layer = layers[i].get();
+                Step s{Op::Layer, cols, layer->output_cols(cols)};
+                switch (layer->kind()) {
+                    case LayerKind::Dense: {
+                        auto* d = static_cast<Dense<T>*>(layer);
+                        if (d->in_features() != cols)
+                            throw std::runtime_error("Topología incompatible al compilar la red");
+                        s.op = Op::Dense;
+                        s.W = d->weights().data();
+                        s.b = d->bias().data();
+                        LayerKind next = i + 1 < layers.size() ? layers[i + 1]->kind() : LayerKind::Custom;
+                        if (next == LayerKind::ReLU || next == LayerKind::Sigmoid) {
+                            s.op = next == LayerKind::ReLU ? Op::DenseReLU : Op::DenseSigmoid;
+                            ++i;
+                        }
+                        break;
+                    }
+                    case LayerKind::ReLU: s.op = Op::ReLU; break;
+                    case LayerKind::Sigmoid: s.op = Op::Sigmoid; break;
+                    default: s.layer = layer; break;
+                }
+                steps_.push_back(s);
+                cols = s.out_cols;
+                max_cols_ = std::max(max_cols_, cols);
+            }
+            reserve(max_rows);
+        }
+
+        size_t input_cols() const { return input_cols_; }
+        size_t output_cols() const { return steps_.empty() ? input_cols_ : steps_.back().out_cols; }
+        size_t steps() const { return steps_.size(); }
+
+        // Punteros de pesos enlazados, en el mismo orden que espera bind().
+        std::vector<const T*> weights() const {
+            std::vector<const T*> params;
+            for (const auto& s : steps_) {
+                if (s.op != Op::Dense && s.op != Op::DenseReLU && s.op != Op::DenseSigmoid) continue;
+                params.push_back(s.W);
+                params.push_back(s.b);
+            }
+            return params;
+        }
+
+        // Reemplaza los punteros de pesos de las Dense, en orden (W y b de cada una), p. ej. por
+        // los de un modelo mapeado en memoria. Los datos deben vivir mientras se use el plan.
+        void bind(const std::vector<const T*>& params) {
+            size_t k = 0;
+            for (auto& s : steps_) {
+                if (s.op != Op::Dense && s.op != Op::DenseReLU && s.op != Op::DenseSigmoid) continue;
+                if (k + 2 > params.size())
+                    throw std::runtime_error("Faltan pesos para enlazar el plan");
+                s.W = params[k++];
+                s.b = params[k++];
+            }
+            if (k != params.size())
+                throw std::runtime_error("Sobran pesos para enlazar el plan");
+        }
+
+        // La vista devuelta vive en los buffers del plan hasta la siguiente llamada. Un lote con
+        // más filas que las previstas amplía los buffers una vez.
+        ConstView run(const ConstView& X) {
+            if (X.cols() != input_cols_)
+                throw std::runtime_error("Columnas de entrada incompatibles con la red compilada");
+            const size_t rows = X.rows();
+            if (rows > max_rows_) reserve(rows);
+
+            ConstView x = X;
+            int cur = 0;
+            for (const auto& s : steps_) {
+                View y(buffers_[cur].data(), rows, s.out_cols);
+                const T* b = s.b;
+                switch (s.op) {
+                    case Op::Dense:
+                        utec::algebra::matrix_product(x, ConstView(s.W, s.in_cols, s.out_cols), y, false,
+                                                      [b](T v, size_t j) { return v + b[j]; });
+                        break;
+                    case Op::DenseReLU:
+                        utec::algebra::matrix_product(x, ConstView(s.W, s.in_cols, s.out_cols), y, false,
+                                                      [b](T v, size_t j) { return detail::relu_op<T>{}(v + b[j]); });
+                        break;
+                    case Op::DenseSigmoid:
+                        utec::algebra::matrix_product(x, ConstView(s.W, s.in_cols, s.out_cols), y, false,
+                                                      [b](T v, size_t j) { return detail::sigmoid_op<T>{}(v + b[j]); });
+                        break;
+                    case Op::ReLU:
+                        detail::map_rows(x, y, [](const T* in, T* o, size_t n) {
+                            for (size_t j = 0; j < n; ++j) o[j] = detail::relu_op<T>{}(in[j]);
+                        });
+                        break;
+                    case Op::Sigmoid:
+                        detail::map_rows(x, y, [](const T* in, T* o, size_t n) {
+                            for (size_t j = 0; j < n; ++j) o[j] = detail::sigmoid_op<T>{}(in[j]);
+                        });
+                        break;
+                    case Op::Layer:
+                        s.layer->forward_into(x, y);
+                        break;
+                }
+                x = y;
+                cur ^= 1;
+            }
+            return x;
+        }
+
+        // Primera salida para una sola fila de input_cols() valores (la ruta de PongAgent::act).
+        T score(const T* x) {
+            return run(ConstView(x, 1, input_cols_))(0, 0);
+        }
+    };
+
+}
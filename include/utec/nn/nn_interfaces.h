@@ -1,10 +1,27 @@
 #pragma once
 #include "tensor.h"
+#include "nn_parameters.h"
+#include <memory>
+#include <utility>
+#include <vector>
 
+// Un optimizador actualiza n parámetros contiguos a partir de sus gradientes. El estado que
+// necesite (momentos de Adam, contador de pasos) va en el ParameterBuffer cuando se le pasa uno,
+// así que nace y muere con él; con punteros sueltos se guarda por la dirección de params y
+// quien lo llama pasa siempre el mismo buffer vivo, una vez por paso.
 template<typename T>
 class IOptimizer {
 public:
-    virtual void update(utec::algebra::Tensor<T,2>& params, const utec::algebra::Tensor<T,2>& grads) = 0;
+    virtual void update(T* params, const T* grads, size_t n) = 0;
+
+    virtual void update(utec::neural_network::ParameterBuffer<T>& buffer) {
+        update(buffer.values(), buffer.grads(), buffer.size());
+    }
+
+    void update(utec::algebra::Tensor<T,2>& params, const utec::algebra::Tensor<T,2>& grads) {
+        update(params.data(), grads.data(), params.size());
+    }
+
     virtual void step() {}
     virtual ~IOptimizer() = default;
 };
@@ -12,6 +29,17 @@ public:
 namespace utec {
     namespace neural_network {
 
+        // Identifica las capas que NeuralNetwork sabe compilar o serializar sin dynamic_cast.
+        enum class LayerKind { Custom, Dense, ReLU, Sigmoid };
+
+        // Un parámetro entrenable y su gradiente (vistas contiguas del mismo tamaño), para quien
+        // combina gradientes entre réplicas o copia pesos.
+        template<typename T>
+        struct ParamRef {
+            utec::algebra::TensorView<T> value;
+            utec::algebra::TensorView<T> grad;
+        };
+
         template<typename T>
         class ILayer {
         public:
@@ -19,6 +47,43 @@ namespace utec {
             virtual utec::algebra::Tensor<T,2> backward(const utec::algebra::Tensor<T,2>& dZ) = 0;
             virtual void update_params(class IOptimizer<T>& optimizer) {}
             virtual ~ILayer() = default;
+
+            virtual LayerKind kind() const { return LayerKind::Custom; }
+
+            // Copia independiente con los mismos parámetros para el entrenamiento en paralelo de
+            // datos; nullptr indica que la capa no admite réplicas.
+            virtual std::unique_ptr<ILayer<T>> clone() const { return nullptr; }
+            virtual void parameters(std::vector<ParamRef<T>>& /*out*/) {}
+
+            // Con flat_parameters() la capa acepta que NeuralNetwork mueva sus parámetros al
+            // buffer plano de la red: bind_parameters recibe los tramos nuevos en el orden de
+            // parameters(), ya con los valores actuales, y desde ahí el optimizador los actualiza
+            // en la pasada única sobre el buffer en vez de llamar a update_params.
+            virtual bool flat_parameters() const { return false; }
+            virtual void bind_parameters(const ParamRef<T>* /*params*/) {}
+
+            // Ruta sin asignaciones que usa el workspace de NeuralNetwork. x e y viven en la arena
+            // hasta el backward siguiente, así que la capa puede guardar vistas en lugar de copias.
+            // Un dx vacío (0 filas) indica que nadie consume el gradiente de entrada.
+            virtual size_t output_cols(size_t input_cols) const { return input_cols; }
+
+            // in_place: y puede ser el mismo buffer que x (y dx el mismo que dy).
+            // keeps_output: el backward lee la salida, así que la capa siguiente no puede pisarla.
+            virtual bool in_place() const { return false; }
+            virtual bool keeps_output() const { return false; }
+
+            virtual void forward_into(const utec::algebra::TensorView<const T>& x,
+                                      const utec::algebra::TensorView<T>& y) {
+                auto out = forward(utec::algebra::Tensor<T,2>(x));
+                utec::algebra::copy(std::as_const(out).view(), y);
+            }
+
+            virtual void backward_into(const utec::algebra::TensorView<const T>& dy,
+                                       const utec::algebra::TensorView<T>& dx) {
+                auto grad = backward(utec::algebra::Tensor<T,2>(dy));
+                if (dx.rows() != 0)
+                    utec::algebra::copy(std::as_const(grad).view(), dx);
+            }
         };
 
         template<typename T>
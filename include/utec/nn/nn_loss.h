@@ -14,23 +14,27 @@ public:
             : y_pred_(y_pred), y_true_(y_true) {}
 
     T loss() const override {
-        T sum = 0;
-        auto pred_it = y_pred_.cbegin();
-        auto true_it = y_true_.cbegin();
-        for (size_t i = 0; i < y_pred_.size(); ++i, ++pred_it, ++true_it)
-            sum += (*pred_it - *true_it) * (*pred_it - *true_it);
-        return sum / T(y_pred_.size());
+        auto sq = [](T p, T y) { return (p - y) * (p - y); };
+        return utec::algebra::sum(utec::algebra::map(y_pred_, y_true_, sq)) / T(y_pred_.size());
     }
 
     utec::algebra::Tensor<T,2> loss_gradient() const override {
-        auto shape = y_pred_.shape();
-        utec::algebra::Tensor<T,2> grad(shape[0], shape[1]);
-        auto pred_it = y_pred_.cbegin();
-        auto true_it = y_true_.cbegin();
-        auto grad_it = grad.begin();
-        for (size_t i = 0; i < grad.size(); ++i, ++pred_it, ++true_it, ++grad_it)
-            *grad_it = (2.0 / T(grad.size())) * (*pred_it - *true_it);
-        return grad;
+        return T(2.0 / T(y_pred_.size())) * (y_pred_ - y_true_);
+    }
+
+    // Gradiente en un buffer existente (workspace); devuelve la pérdida calculada en la misma pasada.
+    static T gradient_into(const utec::algebra::TensorView<const T>& y_pred,
+                           const utec::algebra::TensorView<const T>& y_true,
+                           const utec::algebra::TensorView<T>& grad) {
+        const T scale = T(2) / T(grad.size());
+        T sum = 0;
+        for (size_t i = 0; i < grad.rows(); ++i)
+            for (size_t j = 0; j < grad.cols(); ++j) {
+                T diff = y_pred(i, j) - y_true(i, j);
+                sum += diff * diff;
+                grad(i, j) = scale * diff;
+            }
+        return sum / T(grad.size());
     }
 };
 
@@ -43,29 +47,35 @@ public:
             : y_pred_(y_pred), y_true_(y_true) {}
 
     T loss() const override {
-        T sum = 0;
-        auto pred_it = y_pred_.cbegin();
-        auto true_it = y_true_.cbegin();
-        for (size_t i = 0; i < y_pred_.size(); ++i, ++pred_it, ++true_it) {
-            T y = *true_it;
-            T p = std::clamp(*pred_it, T(1e-12), T(1) - T(1e-12));
-            sum += -(y * std::log(p) + (T(1) - y) * std::log(T(1) - p));
-        }
-        return sum / T(y_pred_.size());
+        auto bce = [](T p, T y) {
+            p = std::clamp(p, T(1e-12), T(1) - T(1e-12));
+            return -(y * std::log(p) + (T(1) - y) * std::log(T(1) - p));
+        };
+        return utec::algebra::sum(utec::algebra::map(y_pred_, y_true_, bce)) / T(y_pred_.size());
     }
 
     utec::algebra::Tensor<T,2> loss_gradient() const override {
-        auto shape = y_pred_.shape();
-        utec::algebra::Tensor<T,2> grad(shape[0], shape[1]);
-        auto pred_it = y_pred_.cbegin();
-        auto true_it = y_true_.cbegin();
-        auto grad_it = grad.begin();
-        for (size_t i = 0; i < grad.size(); ++i, ++pred_it, ++true_it, ++grad_it) {
-            T y = *true_it;
-            T p = std::clamp(*pred_it, T(1e-12), T(1) - T(1e-12));
-            *grad_it = (p - y) / (p * (T(1) - p) * T(grad.size()));
-        }
-        return grad;
+        const T n = T(y_pred_.size());
+        return utec::algebra::map(y_pred_, y_true_, [n](T p, T y) {
+            p = std::clamp(p, T(1e-12), T(1) - T(1e-12));
+            return (p - y) / (p * (T(1) - p) * n);
+        });
+    }
+
+    // Gradiente en un buffer existente (workspace); devuelve la pérdida calculada en la misma pasada.
+    static T gradient_into(const utec::algebra::TensorView<const T>& y_pred,
+                           const utec::algebra::TensorView<const T>& y_true,
+                           const utec::algebra::TensorView<T>& grad) {
+        const T n = T(grad.size());
+        T sum = 0;
+        for (size_t i = 0; i < grad.rows(); ++i)
+            for (size_t j = 0; j < grad.cols(); ++j) {
+                T y = y_true(i, j);
+                T p = std::clamp(y_pred(i, j), T(1e-12), T(1) - T(1e-12));
+                sum += -(y * std::log(p) + (T(1) - y) * std::log(T(1) - p));
+                grad(i, j) = (p - y) / (p * (T(1) - p) * n);
+            }
+        return sum / n;
     }
 };
 
@@ -0,0 +1,270 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include "nn_dense.h"
+#include "aligned_allocator.h"
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace utec::neural_network::model_file {
+
+    // Formato binario de modelo (little-endian):
+    //   [0, 64)        Header
+    //   [64, ...)      un LayerRecord por capa, en orden
+    //   blobs          W (in x out, por filas) y b (1 x out) de cada Dense, cada uno alineado a 64
+    // El CRC-32 cubre todo lo que sigue al encabezado. Como los blobs quedan alineados dentro de
+    // un archivo mapeado en memoria (alineado a página), el plan de inferencia puede leerlos en
+    // el lugar sin copiarlos.
+
+    static_assert(std::endian::native == std::endian::little, "El formato de modelo es little-endian");
+
+    inline constexpr char MAGIC[8] = {'U', 'T', 'E', 'C', 'N', 'N', '\x1a', '\n'};
+    inline constexpr uint32_t VERSION = 1;
+    inline constexpr size_t ALIGN = 64;
+
+    enum class DType : uint32_t { Float32 = 1, Float64 = 2 };
+
+    struct Header {
+        char magic[8];
+        uint32_t version;
+        uint32_t dtype;
+        uint32_t layer_count;
+        uint32_t crc32;
+        uint64_t file_size;
+        uint8_t reserved[32];
+    };
+    static_assert(sizeof(Header) == 64);
+
+    // Las capas sin parámetros guardan solo kind; in, out y los offsets quedan en 0.
+    struct LayerRecord {
+        uint32_t kind;
+        uint32_t reserved;
+        uint64_t in, out;
+        uint64_t weights_offset, bias_offset;
+    };
+    static_assert(sizeof(LayerRecord) == 40);
+
+    template <typename T>
+    constexpr DType dtype_of() {
+        static_assert(std::is_same_v<T, float> || std::is_same_v<T, double>,
+                      "El formato de modelo solo admite float y double");
+        return std::is_same_v<T, float> ? DType::Float32 : DType::Float64;
+    }
+
+    inline size_t align_up(size_t n) { return (n + ALIGN - 1) / ALIGN * ALIGN; }
+
+    // CRC-32 (IEEE 802.3, polinomio reflejado 0xEDB88320).
+    inline uint32_t crc32(const unsigned char* p, size_t n) {
+        static const auto table = [] {
+            std::array<uint32_t, 256> t{};
+            for (uint32_t i = 0; i < 256; ++i) {
+                uint32_t c = i;
+                for (int k = 0; k < 8; ++k) c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+                t[i] = c;
+            }
+            return t;
+        }();
+        uint32_t c = 0xFFFFFFFFu;
+        for (size_t i = 0; i < n; ++i) c = table[(c ^ p[i]) & 0xFF] ^ (c >> 8);
+        return c ^ 0xFFFFFFFFu;
+    }
+
+    template <typename T>
+    void save(const std::string& path, const std::vector<std::unique_ptr<ILayer<T>>>& layers) {
+        std::vector<LayerRecord> records(layers.size());
+        size_t offset = align_up(sizeof(Header) + layers.size() * sizeof(LayerRecord));
+        for (size_t i = 0; i < layers.size(); ++i) {
+            LayerRecord& r = records[i];
+            r = {};
+            LayerKind kind = layers[i]->kind();
+            if (kind == LayerKind::Custom)
+                throw std::runtime_error("No se puede guardar una capa propia en el formato de modelo");
+            r.kind = static_cast<uint32_t>(kind);
+            if (kind == LayerKind::Dense) {
+                auto* d = static_cast<const Dense<T>*>(layers[i].get());
+                r.in = d->in_features();
+                r.out = d->out_features();
+                r.weights_offset = offset;
+                offset = align_up(offset + r.in * r.out * sizeof(T));
+                r.bias_offset = offset;
+                offset = align_up(offset + r.out * sizeof(T));
+            }
+        }
+
+        std::vector<unsigned char> file(offset, 0);
+        std::memcpy(file.data() + sizeof(Header), records.data(), records.size() * sizeof(LayerRecord));
+        for (size_t i = 0; i < layers.size(); ++i) {
+            if (records[i].kind != static_cast<uint32_t>(LayerKind::Dense)) continue;
+            auto* d = static_cast<const Dense<T>*>(layers[i].get());
+            std::memcpy(file.data() + records[i].weights_offset, d->weights().data(), d->weights().size() * sizeof(T));
+            std::memcpy(file.data() + records[i].bias_offset, d->bias().data(), d->bias().size() * sizeof(T));
+        }
+
+        Header h{};
+        std::memcpy(h.magic, MAGIC, sizeof(MAGIC));
+        h.version = VERSION;
+        h.dtype = static_cast<uint32_t>(dtype_of<T>());
+        h.layer_count = static_cast<uint32_t>(layers.size());
+        h.file_size = file.size();
+        h.crc32 = crc32(file.data() + sizeof(Header), file.size() - sizeof(Header));
+        std::memcpy(file.data(), &h, sizeof(Header));
+
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char*>(file.data()), std::streamsize(file.size()));
+        if (!out)
+            throw std::runtime_error("No se pudo escribir el modelo en " + path);
+    }
+
+    // Archivo de modelo mapeado en memoria de solo lectura y validado (encabezado, límites,
+    // alineación y CRC). Los punteros que entrega viven mientras viva el objeto.
+    class MappedModel {
+    private:
+        const unsigned char* data_ = nullptr;
+        size_t size_ = 0;
+#if defined(_WIN32)
+        std::vector<unsigned char, utec::algebra::AlignedAllocator<unsigned char>> buffer_;
+#endif
+
+        const Header& header() const { return *reinterpret_cast<const Header*>(data_); }
+
+        void map(const std::string& path) {
+#if defined(_WIN32)
+            std::ifstream in(path, std::ios::binary | std::ios::ate);
+            if (!in)
+                throw std::runtime_error("No se pudo abrir el modelo " + path);
+            buffer_.resize(size_t(in.tellg()));
+            in.seekg(0);
+            in.read(reinterpret_cast<char*>(buffer_.data()), std::streamsize(buffer_.size()));
+            data_ = buffer_.data();
+            size_ = buffer_.size();
+#else
+            int fd = ::open(path.c_str(), O_RDONLY);
+            if (fd < 0)
+                throw std::runtime_error("No se pudo abrir el modelo " + path);
+            struct stat st{};
+            if (::fstat(fd, &st) != 0 || st.st_size < off_t(sizeof(Header))) {
+                ::close(fd);
+                throw std::runtime_error("Archivo de modelo truncado: " + path);
+            }
+            void* p = ::mmap(nullptr, size_t(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+            ::close(fd);
+            if (p == MAP_FAILED)
+                throw std::runtime_error("No se pudo mapear el modelo " + path);
+            data_ = static_cast<const unsigned char*>(p);
+            size_ = size_t(st.st_size);
+#endif
+        }
+
+        void unmap() {
+#if !defined(_WIN32)
+            if (data_) ::munmap(const_cast<unsigned char*>(data_), size_);
+#endif
+            data_ = nullptr;
+        }
+
+        void validate(const std::string& path) const {
+            if (size_ < sizeof(Header) || std::memcmp(header().magic, MAGIC, sizeof(MAGIC)) != 0)
+                throw std::runtime_error("No es un archivo de modelo: " + path);
+            if (header().version == 0 || header().version > VERSION)
+                throw std::runtime_error("Versión de modelo no soportada en " + path);
+            if (header().file_size != size_ ||
+                sizeof(Header) + uint64_t(header().layer_count) * sizeof(LayerRecord) > size_)
+                throw std::runtime_error("Archivo de modelo truncado: " + path);
+            if (crc32(data_ + sizeof(Header), size_ - sizeof(Header)) != header().crc32)
+                throw std::runtime_error("Checksum inválido en el modelo " + path);
+
+            const size_t elem = header().dtype == uint32_t(DType::Float64) ? 8 : 4;
+            for (size_t i = 0; i < layers(); ++i) {
+                const LayerRecord& r = layer(i);
+                if (r.kind != uint32_t(LayerKind::Dense)) continue;
+                auto fits = [&](uint64_t offset, uint64_t count) {
+                    return offset % ALIGN == 0 && offset <= size_ && count * elem <= size_ - offset;
+                };
+                if (!fits(r.weights_offset, r.in * r.out) || !fits(r.bias_offset, r.out))
+                    throw std::runtime_error("Capa fuera de los límites del modelo " + path);
+            }
+        }
+
+    public:
+        explicit MappedModel(const std::string& path) {
+            map(path);
+            try {
+                validate(path);
+            } catch (...) {
+                unmap();
+                throw;
+            }
+        }
+
+        ~MappedModel() { unmap(); }
+
+        MappedModel(const MappedModel&) = delete;
+        MappedModel& operator=(const MappedModel&) = delete;
+
+        uint32_t version() const { return header().version; }
+        DType dtype() const { return DType(header().dtype); }
+        size_t layers() const { return header().layer_count; }
+        const LayerRecord& layer(size_t i) const {
+            return reinterpret_cast<const LayerRecord*>(data_ + sizeof(Header))[i];
+        }
+
+        // Lanza si el archivo no describe exactamente estas capas con este tipo de dato.
+        template <typename T>
+        void check(const std::vector<std::unique_ptr<ILayer<T>>>& net) const {
+            if (dtype() != dtype_of<T>())
+                throw std::runtime_error("Tipo de dato del modelo incompatible con la red");
+            bool ok = layers() == net.size();
+            for (size_t i = 0; ok && i < net.size(); ++i) {
+                const LayerRecord& r = layer(i);
+                ok = r.kind == static_cast<uint32_t>(net[i]->kind());
+                if (ok && r.kind == uint32_t(LayerKind::Dense)) {
+                    auto* d = static_cast<const Dense<T>*>(net[i].get());
+                    ok = r.in == d->in_features() && r.out == d->out_features();
+                }
+            }
+            if (!ok)
+                throw std::runtime_error("Topología del modelo incompatible con la red");
+        }
+
+        // W y b de cada Dense en orden, apuntando dentro del archivo.
+        template <typename T>
+        std::vector<const T*> parameters() const {
+            std::vector<const T*> out;
+            for (size_t i = 0; i < layers(); ++i) {
+                const LayerRecord& r = layer(i);
+                if (r.kind != uint32_t(LayerKind::Dense)) continue;
+                out.push_back(reinterpret_cast<const T*>(data_ + r.weights_offset));
+                out.push_back(reinterpret_cast<const T*>(data_ + r.bias_offset));
+            }
+            return out;
+        }
+    };
+
+    // Copia los pesos del archivo a las capas después de verificar la topología.
+    template <typename T>
+    void load(const std::string& path, const std::vector<std::unique_ptr<ILayer<T>>>& layers) {
+        MappedModel model(path);
+        model.check(layers);
+        auto blobs = model.parameters<T>();
+        std::vector<ParamRef<T>> params;
+        for (const auto& layer : layers)
+            if (layer->kind() == LayerKind::Dense) layer->parameters(params);
+        for (size_t i = 0; i < params.size(); ++i)
+            std::memcpy(params[i].value.data(), blobs[i], params[i].value.size() * sizeof(T));
+    }
+
+}
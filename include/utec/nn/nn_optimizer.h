@@ -1,11 +1,118 @@
 #pragma once
 #include "nn_interfaces.h"
+#include "aligned_allocator.h"
+#include "utec/thread/IntraOp.h"
+#include <atomic>
 #include <cmath>
+#include <stdexcept>
 #include <vector>
 
+#if defined(__AVX2__) && defined(__FMA__)
+#include <immintrin.h>
+#define UTEC_OPTIMIZER_AVX2 1
+#endif
+
 namespace utec {
     namespace neural_network {
 
+        namespace detail {
+
+            // Los bucles de actualización son elemento a elemento: se parten en trozos contiguos
+            // sobre intra_op cuando el tensor es grande, sin cambiar el resultado.
+            inline constexpr size_t PARALLEL_UPDATE_ELEMS = 1 << 16;
+            inline constexpr size_t UPDATE_GRAIN = 1 << 14;
+
+            template <typename F>
+            void for_elements(size_t n, F&& f) {
+                utec::thread::intra_op::for_tiles(n, UPDATE_GRAIN, n, PARALLEL_UPDATE_ELEMS, f);
+            }
+
+            // Coeficientes de Adam de un paso: las correcciones de sesgo se aplican una vez al
+            // tamaño de paso y a epsilon, lr·m̂/(√v̂ + ε) = step·m/(√v + eps).
+            template <typename T>
+            struct AdamStep {
+                T beta1, beta2, one_minus_beta1, one_minus_beta2, step, eps;
+            };
+
+            // Las rutas SIMD y escalar hacen las mismas operaciones con el mismo redondeo (FMA
+            // explícito), así que el resultado de cada elemento no depende de dónde cae un trozo.
+            template <typename T>
+            inline T fma(T a, T b, T c) {
+#ifdef UTEC_OPTIMIZER_AVX2
+                return std::fma(a, b, c);
+#else
+                return a * b + c;
+#endif
+            }
+
+            template <typename T>
+            void sgd_scalar(T* p, const T* g, size_t n, T lr) {
+                for (size_t i = 0; i < n; ++i) p[i] = fma(-lr, g[i], p[i]);
+            }
+
+            template <typename T>
+            void adam_scalar(T* p, const T* g, T* m, T* v, size_t n, const AdamStep<T>& c) {
+                for (size_t i = 0; i < n; ++i) {
+                    m[i] = fma(c.beta1, m[i], c.one_minus_beta1 * g[i]);
+                    v[i] = fma(c.beta2, v[i], c.one_minus_beta2 * (g[i] * g[i]));
+                    p[i] = p[i] - (c.step * m[i]) / (std::sqrt(v[i]) + c.eps);
+                }
+            }
+
+            template <typename T>
+            void sgd(T* p, const T* g, size_t n, T lr) {
+                size_t i = 0;
+#ifdef UTEC_OPTIMIZER_AVX2
+                if constexpr (std::is_same_v<T, float>) {
+                    const __m256 neg_lr = _mm256_set1_ps(-lr);
+                    for (; i + 8 <= n; i += 8)
+                        _mm256_storeu_ps(p + i, _mm256_fmadd_ps(neg_lr, _mm256_loadu_ps(g + i), _mm256_loadu_ps(p + i)));
+                } else if constexpr (std::is_same_v<T, double>) {
+                    const __m256d neg_lr = _mm256_set1_pd(-lr);
+                    for (; i + 4 <= n; i += 4)
+                        _mm256_storeu_pd(p + i, _mm256_fmadd_pd(neg_lr, _mm256_loadu_pd(g + i), _mm256_loadu_pd(p + i)));
+                }
+#endif
+                sgd_scalar(p + i, g + i, n - i, lr);
+            }
+
+            template <typename T>
+            void adam(T* p, const T* g, T* m, T* v, size_t n, const AdamStep<T>& c) {
+                size_t i = 0;
+#ifdef UTEC_OPTIMIZER_AVX2
+                if constexpr (std::is_same_v<T, float>) {
+                    const __m256 b1 = _mm256_set1_ps(c.beta1), b2 = _mm256_set1_ps(c.beta2);
+                    const __m256 c1 = _mm256_set1_ps(c.one_minus_beta1), c2 = _mm256_set1_ps(c.one_minus_beta2);
+                    const __m256 step = _mm256_set1_ps(c.step), eps = _mm256_set1_ps(c.eps);
+                    for (; i + 8 <= n; i += 8) {
+                        const __m256 gi = _mm256_loadu_ps(g + i);
+                        const __m256 mi = _mm256_fmadd_ps(b1, _mm256_loadu_ps(m + i), _mm256_mul_ps(c1, gi));
+                        const __m256 vi = _mm256_fmadd_ps(b2, _mm256_loadu_ps(v + i), _mm256_mul_ps(c2, _mm256_mul_ps(gi, gi)));
+                        const __m256 d = _mm256_add_ps(_mm256_sqrt_ps(vi), eps);
+                        _mm256_storeu_ps(m + i, mi);
+                        _mm256_storeu_ps(v + i, vi);
+                        _mm256_storeu_ps(p + i, _mm256_sub_ps(_mm256_loadu_ps(p + i), _mm256_div_ps(_mm256_mul_ps(step, mi), d)));
+                    }
+                } else if constexpr (std::is_same_v<T, double>) {
+                    const __m256d b1 = _mm256_set1_pd(c.beta1), b2 = _mm256_set1_pd(c.beta2);
+                    const __m256d c1 = _mm256_set1_pd(c.one_minus_beta1), c2 = _mm256_set1_pd(c.one_minus_beta2);
+                    const __m256d step = _mm256_set1_pd(c.step), eps = _mm256_set1_pd(c.eps);
+                    for (; i + 4 <= n; i += 4) {
+                        const __m256d gi = _mm256_loadu_pd(g + i);
+                        const __m256d mi = _mm256_fmadd_pd(b1, _mm256_loadu_pd(m + i), _mm256_mul_pd(c1, gi));
+                        const __m256d vi = _mm256_fmadd_pd(b2, _mm256_loadu_pd(v + i), _mm256_mul_pd(c2, _mm256_mul_pd(gi, gi)));
+                        const __m256d d = _mm256_add_pd(_mm256_sqrt_pd(vi), eps);
+                        _mm256_storeu_pd(m + i, mi);
+                        _mm256_storeu_pd(v + i, vi);
+                        _mm256_storeu_pd(p + i, _mm256_sub_pd(_mm256_loadu_pd(p + i), _mm256_div_pd(_mm256_mul_pd(step, mi), d)));
+                    }
+                }
+#endif
+                adam_scalar(p + i, g + i, m + i, v + i, n - i, c);
+            }
+
+        }
+
         template<typename T>
         class SGD final : public IOptimizer<T> {
         private:
@@ -13,45 +120,90 @@ namespace utec {
         public:
             explicit SGD(T lr = 0.01) : lr_(lr) {}
 
-            void update(utec::algebra::Tensor<T,2>& params, const utec::algebra::Tensor<T,2>& grads) override {
-                size_t N = params.size();
-                auto p_it = params.begin();
-                auto g_it = grads.cbegin();
-                for (size_t i = 0; i < N; ++i, ++p_it, ++g_it)
-                    *p_it -= lr_ * (*g_it);
+            using IOptimizer<T>::update;
+
+            void update(T* params, const T* grads, size_t n) override {
+                detail::for_elements(n, [&](size_t i0, size_t i1) {
+                    detail::sgd(params + i0, grads + i0, i1 - i0, lr_);
+                });
             }
         };
 
+        // Los momentos y el contador de pasos son de cada buffer, así que una red, cada capa
+        // suelta o cada tensor lleva su propio estado. Con un ParameterBuffer (la red y la Dense
+        // suelta) el estado vive en el buffer: se libera con él y un buffer nuevo en la misma
+        // dirección empieza de cero; otro Adam que lo encuentre escrito también lo reinicia.
+        // Con punteros sueltos o tensores el estado lo pasa quien llama (Adam::State); sin él,
+        // update lanza en vez de adivinar el estado por la dirección. Cada llamada a update es un
+        // paso para ese buffer: t avanza una vez y las correcciones de sesgo se calculan una vez
+        // por llamada, no por elemento.
         template<typename T>
         class Adam final : public IOptimizer<T> {
+        public:
+            using State = typename ParameterBuffer<T>::OptimizerState;
+
         private:
+            static uint64_t next_id() {
+                static std::atomic<uint64_t> next{1};
+                return next.fetch_add(1, std::memory_order_relaxed);
+            }
+
             T lr_, beta1_, beta2_, epsilon_;
-            std::vector<T> m_, v_;
-            int t_ = 0;
+            uint64_t id_ = next_id();
+
+            // Momentos m y v en slots[0, n) y slots[n, 2n).
+            void step(State& s, T* params, const T* grads, size_t n) {
+                if (s.owner != id_ || s.slots.size() != 2 * n) {
+                    s.owner = id_;
+                    s.slots.assign(2 * n, T(0));
+                    s.t = 0;
+                }
+                ++s.t;
+                const T bc1 = 1 - std::pow(beta1_, T(s.t));
+                const T sqrt_bc2 = std::sqrt(1 - std::pow(beta2_, T(s.t)));
+                const detail::AdamStep<T> c{beta1_, beta2_, 1 - beta1_, 1 - beta2_,
+                                            lr_ * sqrt_bc2 / bc1, epsilon_ * sqrt_bc2};
+                T* m = s.slots.data();
+                T* v = m + n;
+                detail::for_elements(n, [&](size_t i0, size_t i1) {
+                    detail::adam(params + i0, grads + i0, m + i0, v + i0, i1 - i0, c);
+                });
+            }
+
         public:
             explicit Adam(T lr = 0.001, T b1 = 0.9, T b2 = 0.999, T eps = 1e-8)
                     : lr_(lr), beta1_(b1), beta2_(b2), epsilon_(eps) {}
 
-            void update(utec::algebra::Tensor<T,2>& params, const utec::algebra::Tensor<T,2>& grads) override {
-                size_t N = params.size();
-                if (m_.empty()) {
-                    m_.resize(N, T(0));
-                    v_.resize(N, T(0));
-                }
-                ++t_;
-                auto p_it = params.begin();
-                auto g_it = grads.cbegin();
-                for (size_t i = 0; i < N; ++i, ++p_it, ++g_it) {
-                    m_[i] = beta1_ * m_[i] + (1 - beta1_) * (*g_it);
-                    v_[i] = beta2_ * v_[i] + (1 - beta2_) * (*g_it) * (*g_it);
+            // Cada Adam es un optimizador distinto: la copia no comparte el id (ni el estado de
+            // los buffers) del original.
+            Adam(const Adam& o)
+                    : lr_(o.lr_), beta1_(o.beta1_), beta2_(o.beta2_), epsilon_(o.epsilon_) {}
+            Adam& operator=(const Adam&) = delete;
 
-                    T m_hat = m_[i] / (1 - std::pow(beta1_, t_));
-                    T v_hat = v_[i] / (1 - std::pow(beta2_, t_));
+            using IOptimizer<T>::update;
 
-                    *p_it -= lr_ * m_hat / (std::sqrt(v_hat) + epsilon_);
-                }
+            void update(T*, const T*, size_t) override {
+                throw std::runtime_error("Adam necesita estado: usar un ParameterBuffer o update con Adam::State");
+            }
+
+            void update(ParameterBuffer<T>& buffer) override {
+                step(buffer.optimizer_state(), buffer.values(), buffer.grads(), buffer.size());
+            }
+
+            // El estado de params es de quien llama y vive tanto como él lo guarde.
+            void update(T* params, const T* grads, size_t n, State& state) {
+                step(state, params, grads, n);
             }
 
+            void update(utec::algebra::Tensor<T,2>& params, const utec::algebra::Tensor<T,2>& grads, State& state) {
+                step(state, params.data(), grads.data(), params.size());
+            }
+
+            // Pasos dados con este Adam sobre ese estado (0 si nunca lo usó).
+            long long steps(const State& state) const { return state.owner == id_ ? state.t : 0; }
+
+            long long steps(const ParameterBuffer<T>& buffer) const { return steps(buffer.optimizer_state()); }
+
             void step() override {}
         };
 
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "tensor_view.h"
+#include "aligned_allocator.h"
+
+namespace utec::neural_network {
+
+    // Parámetros y gradientes de varios tensores en dos buffers planos paralelos: el tramo i
+    // ocupa el mismo offset en values y en grads, y cada tramo empieza alineado a 64 bytes. El
+    // relleno entre tramos queda en cero en ambos buffers, así que un optimizador puede recorrer
+    // todo el buffer de una sola pasada sin cambiar nada fuera de los tramos.
+    template <typename T>
+    class ParameterBuffer {
+    private:
+        using View = utec::algebra::TensorView<T>;
+
+        static constexpr size_t ALIGN_ELEMS = std::max<size_t>(1, 64 / sizeof(T));
+
+        struct Segment {
+            size_t offset, rows, cols;
+        };
+
+    public:
+        // Estado de un optimizador guardado junto a los parámetros (p. ej. los momentos de Adam
+        // en slots): vive y muere con el buffer, así que uno nuevo empieza sin estado aunque
+        // ocupe la dirección de otro ya liberado. owner es el id del optimizador que lo escribió.
+        struct OptimizerState {
+            uint64_t owner = 0;
+            long long t = 0;
+            std::vector<T, utec::algebra::AlignedAllocator<T>> slots;
+        };
+
+    private:
+        std::vector<T, utec::algebra::AlignedAllocator<T>> values_, grads_;
+        std::vector<Segment> segments_;
+        OptimizerState optimizer_state_;
+
+    public:
+        // Reserva un tramo rows x cols y devuelve su índice; invalida las vistas anteriores.
+        size_t add(size_t rows, size_t cols) {
+            const size_t offset = (values_.size() + ALIGN_ELEMS - 1) / ALIGN_ELEMS * ALIGN_ELEMS;
+            segments_.push_back({offset, rows, cols});
+            values_.resize(offset + rows * cols, T(0));
+            grads_.resize(values_.size(), T(0));
+            optimizer_state_ = {};
+            return segments_.size() - 1;
+        }
+
+        void clear() {
+            values_.clear();
+            values_.shrink_to_fit();
+            grads_.clear();
+            grads_.shrink_to_fit();
+            segments_.clear();
+            optimizer_state_ = {};
+        }
+
+        size_t segments() const { return segments_.size(); }
+        size_t size() const { return values_.size(); }
+        bool empty() const { return values_.empty(); }
+
+        T* values() { return values_.data(); }
+        T* grads() { return grads_.data(); }
+        const T* values() const { return values_.data(); }
+
+        OptimizerState& optimizer_state() { return optimizer_state_; }
+        const OptimizerState& optimizer_state() const { return optimizer_state_; }
+
+        View value(size_t i) {
+            const Segment& s = segments_[i];
+            return View(values_.data() + s.offset, s.rows, s.cols);
+        }
+
+        View grad(size_t i) {
+            const Segment& s = segments_[i];
+            return View(grads_.data() + s.offset, s.rows, s.cols);
+        }
+    };
+
+}
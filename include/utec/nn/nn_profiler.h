@@ -0,0 +1,293 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "nn_interfaces.h"
+#include "nn_dense.h"
+
+// Perfilador por capa de NeuralNetwork. Se activa con -DPONG_PROFILE (opción PONG_PROFILE de
+// CMake); sin ella las macros UTEC_PROFILE_* no generan código y enabled es false.
+//
+// Cada sitio (p. ej. "[0] Dense 3x16 forward" o "pérdida") acumula llamadas, tiempo de pared,
+// FLOPs y bytes movidos estimados, y bytes pedidos a operator new mientras estuvo abierto (solo
+// si se enlaza src/utec/nn/Profiler.cpp, que reemplaza operator new). Cada hilo acumula en su
+// propio bloque, así que los forward de las réplicas en paralelo no compiten por un lock.
+// Los sitios anidados (p. ej. "optimizador" contiene los update de cada capa) se cuentan en
+// ambos, así que los tiempos no se suman.
+
+namespace utec::neural_network::profiler {
+
+#if defined(PONG_PROFILE)
+    inline constexpr bool enabled = true;
+#else
+    inline constexpr bool enabled = false;
+#endif
+
+    struct Stats {
+        uint64_t calls = 0;
+        uint64_t ns = 0;
+        uint64_t flops = 0;
+        uint64_t bytes_moved = 0;
+        uint64_t bytes_allocated = 0;
+
+        Stats& operator+=(const Stats& o) {
+            calls += o.calls;
+            ns += o.ns;
+            flops += o.flops;
+            bytes_moved += o.bytes_moved;
+            bytes_allocated += o.bytes_allocated;
+            return *this;
+        }
+    };
+
+    struct Entry {
+        std::string name;
+        Stats stats;
+    };
+
+    struct Cost {
+        uint64_t flops = 0;
+        uint64_t bytes = 0;
+    };
+
+    enum class Phase { Forward, Backward, Update };
+
+    namespace detail {
+
+        // Bytes pedidos a operator new por este hilo (lo incrementa Profiler.cpp).
+        inline thread_local uint64_t allocated = 0;
+
+        struct ThreadStats {
+            std::mutex mutex;
+            std::vector<Stats> sites;
+        };
+
+        struct Registry {
+            std::mutex mutex;
+            std::vector<std::string> names;
+            std::unordered_map<std::string, size_t> ids;
+            std::vector<std::shared_ptr<ThreadStats>> threads;
+        };
+
+        inline Registry& registry() {
+            static Registry r;
+            return r;
+        }
+
+        // El bloque sobrevive al hilo (el registro guarda otra referencia) para el reporte final.
+        inline ThreadStats& thread_stats() {
+            thread_local std::shared_ptr<ThreadStats> local = [] {
+                auto s = std::make_shared<ThreadStats>();
+                Registry& r = registry();
+                std::lock_guard lock(r.mutex);
+                r.threads.push_back(s);
+                return s;
+            }();
+            return *local;
+        }
+
+    }
+
+    // Identificador estable del sitio con ese nombre (se crea la primera vez).
+    inline size_t site(const std::string& name) {
+        detail::Registry& r = detail::registry();
+        std::lock_guard lock(r.mutex);
+        auto [it, nuevo] = r.ids.try_emplace(name, r.names.size());
+        if (nuevo) r.names.push_back(name);
+        return it->second;
+    }
+
+    inline void record(size_t id, const Stats& s) {
+        detail::ThreadStats& t = detail::thread_stats();
+        std::lock_guard lock(t.mutex);
+        if (t.sites.size() <= id) t.sites.resize(id + 1);
+        t.sites[id] += s;
+    }
+
+    // Mide desde la construcción hasta la destrucción y lo suma al sitio.
+    class Scope {
+    private:
+        size_t id_;
+        Cost cost_;
+        uint64_t allocated0_;
+        std::chrono::steady_clock::time_point t0_;
+
+    public:
+        explicit Scope(size_t id, Cost cost = {})
+                : id_(id), cost_(cost), allocated0_(detail::allocated), t0_(std::chrono::steady_clock::now()) {}
+
+        ~Scope() {
+            auto dt = std::chrono::steady_clock::now() - t0_;
+            record(id_, {1, uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(dt).count()),
+                         cost_.flops, cost_.bytes, detail::allocated - allocated0_});
+        }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+    };
+
+    // Totales de todos los hilos, de mayor a menor tiempo; omite los sitios sin llamadas.
+    inline std::vector<Entry> entries() {
+        detail::Registry& r = detail::registry();
+        std::lock_guard lock(r.mutex);
+        std::vector<Entry> out(r.names.size());
+        for (size_t i = 0; i < out.size(); ++i) out[i].name = r.names[i];
+        for (const auto& t : r.threads) {
+            std::lock_guard tlock(t->mutex);
+            for (size_t i = 0; i < t->sites.size(); ++i) out[i].stats += t->sites[i];
+        }
+        out.erase(std::remove_if(out.begin(), out.end(), [](const Entry& e) { return e.stats.calls == 0; }),
+                  out.end());
+        std::stable_sort(out.begin(), out.end(), [](const Entry& a, const Entry& b) { return a.stats.ns > b.stats.ns; });
+        return out;
+    }
+
+    // Pone los contadores en cero; los sitios siguen registrados.
+    inline void reset() {
+        detail::Registry& r = detail::registry();
+        std::lock_guard lock(r.mutex);
+        for (const auto& t : r.threads) {
+            std::lock_guard tlock(t->mutex);
+            std::fill(t->sites.begin(), t->sites.end(), Stats{});
+        }
+    }
+
+    namespace detail {
+
+        // Columnas que ocupa un texto UTF-8 (no cuenta los bytes de continuación).
+        inline size_t columns(const std::string& s) {
+            return size_t(std::count_if(s.begin(), s.end(), [](char c) { return (c & 0xC0) != 0x80; }));
+        }
+
+    }
+
+    // Tabla ordenada por tiempo total.
+    inline void print(std::ostream& os) {
+        auto list = entries();
+        size_t width = 6;
+        for (const auto& e : list) width = std::max(width, detail::columns(e.name));
+        auto flags = os.flags();
+        auto precision = os.precision();
+        os << std::left << std::setw(int(width)) << "Sitio" << std::right
+           << std::setw(10) << "llamadas" << std::setw(12) << "total ms" << std::setw(12) << "us/llamada"
+           << std::setw(10) << "GFLOP/s" << std::setw(10) << "GB/s" << std::setw(14) << "KB asignados" << "\n";
+        os << std::fixed;
+        for (const auto& e : list) {
+            const Stats& s = e.stats;
+            const double ns = double(std::max<uint64_t>(s.ns, 1));
+            os << e.name << std::string(width - detail::columns(e.name), ' ')
+               << std::setw(10) << s.calls
+               << std::setw(12) << std::setprecision(3) << s.ns / 1e6
+               << std::setw(12) << std::setprecision(3) << s.ns / 1e3 / double(s.calls)
+               << std::setw(10) << std::setprecision(2) << s.flops / ns
+               << std::setw(10) << std::setprecision(2) << s.bytes_moved / ns
+               << std::setw(14) << std::setprecision(1) << s.bytes_allocated / 1024.0 << "\n";
+        }
+        os.flags(flags);
+        os.precision(precision);
+    }
+
+    inline void write_csv(const std::string& path) {
+        std::ofstream out(path);
+        if (!out)
+            throw std::runtime_error("No se pudo escribir el perfil en " + path);
+        out << "sitio,llamadas,ns,flops,bytes_movidos,bytes_asignados\n";
+        for (const auto& e : entries())
+            out << '"' << e.name << "\"," << e.stats.calls << ',' << e.stats.ns << ',' << e.stats.flops << ','
+                << e.stats.bytes_moved << ',' << e.stats.bytes_allocated << "\n";
+    }
+
+    inline void write_json(const std::string& path) {
+        std::ofstream out(path);
+        if (!out)
+            throw std::runtime_error("No se pudo escribir el perfil en " + path);
+        auto list = entries();
+        out << "[\n";
+        for (size_t i = 0; i < list.size(); ++i) {
+            const Stats& s = list[i].stats;
+            out << "  {\"sitio\": \"" << list[i].name << "\", \"llamadas\": " << s.calls << ", \"ns\": " << s.ns
+                << ", \"flops\": " << s.flops << ", \"bytes_movidos\": " << s.bytes_moved
+                << ", \"bytes_asignados\": " << s.bytes_allocated << "}" << (i + 1 < list.size() ? ",\n" : "\n");
+        }
+        out << "]\n";
+    }
+
+    // Sitios forward, backward y update de la capa i, p. ej. "[0] Dense 3x16 forward".
+    template <typename T>
+    std::array<size_t, 3> layer_sites(size_t i, const ILayer<T>& layer) {
+        std::string name = "[" + std::to_string(i) + "] ";
+        switch (layer.kind()) {
+            case LayerKind::Dense: {
+                auto& d = static_cast<const Dense<T>&>(layer);
+                name += "Dense " + std::to_string(d.in_features()) + "x" + std::to_string(d.out_features());
+                break;
+            }
+            case LayerKind::ReLU: name += "ReLU"; break;
+            case LayerKind::Sigmoid: name += "Sigmoid"; break;
+            default: name += "Capa"; break;
+        }
+        return {site(name + " forward"), site(name + " backward"), site(name + " update")};
+    }
+
+    // Estimación de trabajo de una fase sobre rows filas de cols columnas de entrada. Dense:
+    // 2·rows·in·out en el forward y el doble en el backward (dX y dW); el update cuenta 2 FLOPs
+    // y 3 accesos por parámetro (el de SGD). Las capas propias solo cuentan sus activaciones.
+    template <typename T>
+    Cost layer_cost(const ILayer<T>& layer, Phase phase, size_t rows, size_t cols) {
+        const uint64_t s = sizeof(T);
+        const uint64_t r = rows, c = cols;
+        switch (layer.kind()) {
+            case LayerKind::Dense: {
+                auto& d = static_cast<const Dense<T>&>(layer);
+                const uint64_t in = d.in_features(), out = d.out_features(), p = in * out + out;
+                switch (phase) {
+                    case Phase::Forward: return {2 * r * in * out + r * out, s * (r * in + p + r * out)};
+                    case Phase::Backward: return {4 * r * in * out + r * out, s * (2 * r * in + r * out + 2 * p)};
+                    case Phase::Update: return {2 * p, 3 * s * p};
+                }
+                break;
+            }
+            case LayerKind::ReLU:
+            case LayerKind::Sigmoid: {
+                const uint64_t per = layer.kind() == LayerKind::Sigmoid ? 4 : 1;
+                if (phase == Phase::Forward) return {per * r * c, 2 * s * r * c};
+                if (phase == Phase::Backward) return {2 * r * c, 3 * s * r * c};
+                break;
+            }
+            default:
+                if (phase != Phase::Update) return {0, 2 * s * r * c};
+                break;
+        }
+        return {};
+    }
+
+}
+
+#if defined(PONG_PROFILE)
+#define UTEC_PROFILE_CONCAT_(a, b) a##b
+#define UTEC_PROFILE_CONCAT(a, b) UTEC_PROFILE_CONCAT_(a, b)
+// Mide el resto del bloque en el sitio llamado name (se resuelve una vez por línea); el
+// argumento opcional es el Cost de la llamada.
+#define UTEC_PROFILE_SCOPE(name, ...)                                                           \
+    static const size_t UTEC_PROFILE_CONCAT(utec_sitio_, __LINE__) =                            \
+            ::utec::neural_network::profiler::site(name);                                       \
+    ::utec::neural_network::profiler::Scope UTEC_PROFILE_CONCAT(utec_perfil_, __LINE__)(        \
+            UTEC_PROFILE_CONCAT(utec_sitio_, __LINE__) __VA_OPT__(,) __VA_ARGS__)
+// Igual, con un identificador de sitio ya resuelto.
+#define UTEC_PROFILE_SITE(id, ...) \
+    ::utec::neural_network::profiler::Scope UTEC_PROFILE_CONCAT(utec_perfil_, __LINE__)(id __VA_OPT__(,) __VA_ARGS__)
+#else
+#define UTEC_PROFILE_SCOPE(name, ...) ((void)0)
+#define UTEC_PROFILE_SITE(id, ...) ((void)0)
+#endif
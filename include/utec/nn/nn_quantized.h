@@ -0,0 +1,270 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+#include "nn_interfaces.h"
+#include "nn_activation.h"
+#include "aligned_allocator.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define UTEC_INT8_AVX2 1
+#endif
+
+namespace utec::neural_network {
+
+    template <typename T>
+    class NeuralNetwork;
+
+    namespace quant {
+
+        // Capa cuantizada y = x W con W de in x out en int8. Los pesos se guardan en bloques de
+        // OUT_BLOCK salidas y pares de entradas: para el bloque jb y el par p vienen los
+        // OUT_BLOCK pares (W[2p, j], W[2p+1, j]) contiguos, así cada paso del kernel multiplica
+        // un par de entradas por 8 salidas y acumula en int32 sin sumas horizontales. Las
+        // entradas se rellenan a un número par y las salidas a múltiplos de OUT_BLOCK con ceros.
+        inline constexpr size_t OUT_BLOCK = 8;
+
+        inline size_t pairs(size_t in) { return (in + 1) / 2; }
+        inline size_t out_blocks(size_t out) { return (out + OUT_BLOCK - 1) / OUT_BLOCK; }
+
+        inline size_t weight_index(size_t i, size_t j, size_t in) {
+            return ((j / OUT_BLOCK * pairs(in) + i / 2) * OUT_BLOCK + j % OUT_BLOCK) * 2 + i % 2;
+        }
+
+        // acc[j] = sum_i x[i] * W[i, j] para x en int16 (valores int8, 2 * pairs(in) elementos)
+        // y acc con out_blocks(out) * OUT_BLOCK elementos.
+        inline void gemv_i8_scalar(const int16_t* x, const int8_t* w, size_t in, size_t out, int32_t* acc) {
+            const size_t np = pairs(in);
+            for (size_t jb = 0; jb < out_blocks(out); ++jb) {
+                int32_t* a = acc + jb * OUT_BLOCK;
+                std::fill(a, a + OUT_BLOCK, 0);
+                for (size_t p = 0; p < np; ++p) {
+                    const int8_t* wp = w + (jb * np + p) * OUT_BLOCK * 2;
+                    for (size_t jj = 0; jj < OUT_BLOCK; ++jj)
+                        a[jj] += int32_t(x[2 * p]) * wp[2 * jj] + int32_t(x[2 * p + 1]) * wp[2 * jj + 1];
+                }
+            }
+        }
+
+        // Con AVX2: el par de entradas se difunde como int32, los 16 pesos int8 del paso se
+        // extienden a int16 y madd_epi16 suma cada par de productos en int32 (2 * 127 * 127 no
+        // satura).
+        inline void gemv_i8(const int16_t* x, const int8_t* w, size_t in, size_t out, int32_t* acc) {
+#ifdef UTEC_INT8_AVX2
+            const size_t np = pairs(in);
+            for (size_t jb = 0; jb < out_blocks(out); ++jb) {
+                const int8_t* wb = w + jb * np * OUT_BLOCK * 2;
+                __m256i s0 = _mm256_setzero_si256(), s1 = _mm256_setzero_si256();
+                size_t p = 0;
+                for (; p + 1 < np; p += 2) {
+                    int32_t x0, x1;
+                    std::memcpy(&x0, x + 2 * p, 4);
+                    std::memcpy(&x1, x + 2 * p + 2, 4);
+                    __m256i w0 = _mm256_cvtepi8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(wb + p * 16)));
+                    __m256i w1 = _mm256_cvtepi8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(wb + p * 16 + 16)));
+                    s0 = _mm256_add_epi32(s0, _mm256_madd_epi16(_mm256_set1_epi32(x0), w0));
+                    s1 = _mm256_add_epi32(s1, _mm256_madd_epi16(_mm256_set1_epi32(x1), w1));
+                }
+                if (p < np) {
+                    int32_t x0;
+                    std::memcpy(&x0, x + 2 * p, 4);
+                    __m256i w0 = _mm256_cvtepi8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(wb + p * 16)));
+                    s0 = _mm256_add_epi32(s0, _mm256_madd_epi16(_mm256_set1_epi32(x0), w0));
+                }
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(acc + jb * OUT_BLOCK), _mm256_add_epi32(s0, s1));
+            }
+#else
+            gemv_i8_scalar(x, w, in, out, acc);
+#endif
+        }
+
+        // Cuantización simétrica: round(v / scale) saturado a [-127, 127].
+        template <typename T>
+        int8_t quantize(T v, T inv_scale) {
+            T q = std::nearbyint(v * inv_scale);
+            return int8_t(std::clamp(q, T(-127), T(127)));
+        }
+
+    }
+
+    // Red de inferencia con pesos int8 generada por cuantización post-entrenamiento:
+    //  - pesos de cada Dense con una escala por canal de salida (max |W[:, j]| / 127);
+    //  - la entrada de cada Dense con una escala por tensor calibrada como max |x| / 127 sobre
+    //    las muestras de calibración, propagadas por la red en punto flotante;
+    //  - acumulación int32 y desescalado a punto flotante con el bias, y activaciones en
+    //    punto flotante antes de volver a cuantizar para la capa siguiente.
+    template <typename T>
+    class QuantizedNetwork {
+    private:
+        using ConstView = utec::algebra::TensorView<const T>;
+        using View = utec::algebra::TensorView<T>;
+
+        enum class Op { Dense, ReLU, Sigmoid };
+
+        struct Layer {
+            Op op;
+            size_t in = 0, out = 0;
+            std::vector<int8_t, utec::algebra::AlignedAllocator<int8_t>> weights;  // ver quant::weight_index
+            std::vector<T> out_scale;       // escala de entrada * escala del canal
+            std::vector<T> bias;
+            T in_scale = T(1);
+        };
+
+        std::vector<Layer> layers_;
+        size_t input_size_ = 0, output_size_ = 0, max_cols_ = 0;
+
+        QuantizedNetwork() = default;
+
+        // x (cols valores) se transforma capa por capa en los buffers del hilo; devuelve la salida.
+        const T* run(const T* x) const {
+            thread_local std::vector<T> bufs[2];
+            thread_local std::vector<int16_t> xq;
+            thread_local std::vector<int32_t> acc;
+            if (bufs[0].size() < max_cols_) {
+                bufs[0].resize(max_cols_);
+                bufs[1].resize(max_cols_);
+            }
+            if (xq.size() < max_cols_ + 1) xq.resize(max_cols_ + 1);
+            if (acc.size() < quant::out_blocks(max_cols_) * quant::OUT_BLOCK)
+                acc.resize(quant::out_blocks(max_cols_) * quant::OUT_BLOCK);
+
+            const T* cur = x;
+            int next = 0;
+            for (const auto& l : layers_) {
+                T* y = bufs[next].data();
+                if (l.op == Op::Dense) {
+                    const T inv = T(1) / l.in_scale;
+                    for (size_t i = 0; i < l.in; ++i) xq[i] = quant::quantize(cur[i], inv);
+                    xq[l.in] = 0;
+                    quant::gemv_i8(xq.data(), l.weights.data(), l.in, l.out, acc.data());
+                    for (size_t j = 0; j < l.out; ++j) y[j] = T(acc[j]) * l.out_scale[j] + l.bias[j];
+                } else if (l.op == Op::ReLU) {
+                    for (size_t j = 0; j < l.in; ++j) y[j] = detail::relu_op<T>{}(cur[j]);
+                } else {
+                    for (size_t j = 0; j < l.in; ++j) y[j] = detail::sigmoid_op<T>{}(cur[j]);
+                }
+                cur = y;
+                next ^= 1;
+            }
+            return cur;
+        }
+
+    public:
+        // Cuantiza las Dense de net (solo Dense, ReLU y Sigmoid) calibrando las escalas de
+        // activación con las filas de calibration.
+        static QuantizedNetwork quantize(NeuralNetwork<T>& net, const ConstView& calibration) {
+            QuantizedNetwork q;
+            std::vector<ParamRef<T>> params;
+            net.parameters(params);
+            size_t p = 0, cols = calibration.cols();
+            q.input_size_ = cols;
+            for (LayerKind kind : net.layer_kinds()) {
+                Layer l;
+                if (kind == LayerKind::Dense) {
+                    const auto& W = params[p].value;
+                    const auto& b = params[p + 1].value;
+                    p += 2;
+                    l.op = Op::Dense;
+                    l.in = W.shape()[0];
+                    l.out = W.shape()[1];
+                    if (l.in != cols)
+                        throw std::runtime_error("Columnas de calibración incompatibles con la red");
+                    l.weights.assign(quant::out_blocks(l.out) * quant::pairs(l.in) * quant::OUT_BLOCK * 2, 0);
+                    l.out_scale.resize(l.out);
+                    l.bias.assign(b.data(), b.data() + b.size());
+                    for (size_t j = 0; j < l.out; ++j) {
+                        T max_abs = 0;
+                        for (size_t i = 0; i < l.in; ++i) max_abs = std::max(max_abs, std::fabs(W(i, j)));
+                        const T scale = max_abs > T(0) ? max_abs / T(127) : T(1);
+                        for (size_t i = 0; i < l.in; ++i)
+                            l.weights[quant::weight_index(i, j, l.in)] = quant::quantize(W(i, j), T(1) / scale);
+                        l.out_scale[j] = scale;
+                    }
+                    cols = l.out;
+                } else if (kind == LayerKind::ReLU || kind == LayerKind::Sigmoid) {
+                    l.op = kind == LayerKind::ReLU ? Op::ReLU : Op::Sigmoid;
+                    l.in = l.out = cols;
+                } else {
+                    throw std::runtime_error("Solo se pueden cuantizar redes de Dense, ReLU y Sigmoid");
+                }
+                q.max_cols_ = std::max(q.max_cols_, cols);
+                q.layers_.push_back(std::move(l));
+            }
+            q.output_size_ = cols;
+            q.max_cols_ = std::max(q.max_cols_, q.input_size_);
+            q.calibrate(params, calibration);
+            return q;
+        }
+
+        size_t input_size() const { return input_size_; }
+        size_t output_size() const { return output_size_; }
+
+        // Bytes de pesos int8 (con relleno) más escalas y bias.
+        size_t weight_bytes() const {
+            size_t n = 0;
+            for (const auto& l : layers_)
+                n += l.weights.size() + (l.out_scale.size() + l.bias.size()) * sizeof(T);
+            return n;
+        }
+
+        void forward(const T* x, T* y) const {
+            const T* out = run(x);
+            std::copy(out, out + output_size_, y);
+        }
+
+        T score(const T* x) const { return run(x)[0]; }
+
+        void forward_batch(const ConstView& X, const View& Y) const {
+            if (X.cols() != input_size_ || Y.cols() != output_size_ || X.rows() != Y.rows())
+                throw std::runtime_error("Dimensiones incompatibles con la red cuantizada");
+            thread_local std::vector<T> row;
+            row.resize(input_size_);
+            for (size_t i = 0; i < X.rows(); ++i) {
+                for (size_t j = 0; j < input_size_; ++j) row[j] = X(i, j);
+                const T* out = run(row.data());
+                for (size_t j = 0; j < output_size_; ++j) Y(i, j) = out[j];
+            }
+        }
+
+    private:
+        // Forward en punto flotante con los pesos originales, registrando max |x| a la entrada
+        // de cada Dense; después fija la escala de entrada y la combina con la de cada canal.
+        void calibrate(const std::vector<ParamRef<T>>& params, const ConstView& calibration) {
+            std::vector<T> max_in(layers_.size(), T(0));
+            std::vector<T> cur(max_cols_), nxt(max_cols_);
+            for (size_t r = 0; r < calibration.rows(); ++r) {
+                for (size_t j = 0; j < input_size_; ++j) cur[j] = calibration(r, j);
+                size_t p = 0;
+                for (size_t k = 0; k < layers_.size(); ++k) {
+                    const Layer& l = layers_[k];
+                    if (l.op == Op::Dense) {
+                        const auto& W = params[p].value;
+                        p += 2;
+                        for (size_t i = 0; i < l.in; ++i) max_in[k] = std::max(max_in[k], std::fabs(cur[i]));
+                        for (size_t j = 0; j < l.out; ++j) {
+                            T acc = l.bias[j];
+                            for (size_t i = 0; i < l.in; ++i) acc += cur[i] * W(i, j);
+                            nxt[j] = acc;
+                        }
+                    } else {
+                        for (size_t j = 0; j < l.in; ++j)
+                            nxt[j] = l.op == Op::ReLU ? detail::relu_op<T>{}(cur[j]) : detail::sigmoid_op<T>{}(cur[j]);
+                    }
+                    std::swap(cur, nxt);
+                }
+            }
+            for (size_t k = 0; k < layers_.size(); ++k) {
+                Layer& l = layers_[k];
+                if (l.op != Op::Dense) continue;
+                l.in_scale = max_in[k] > T(0) ? max_in[k] / T(127) : T(1);
+                for (auto& s : l.out_scale) s *= l.in_scale;
+            }
+        }
+    };
+
+}
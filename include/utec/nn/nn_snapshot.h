@@ -0,0 +1,256 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+#include "neural_network.h"
+
+namespace utec::neural_network {
+
+    // Copia inmutable de los valores del buffer de parámetros de una red, con el mismo layout
+    // que ParameterBuffer (relleno incluido), y su número de versión.
+    template <typename T>
+    struct WeightSnapshot {
+        uint64_t version = 0;
+        std::vector<T, utec::algebra::AlignedAllocator<T>> values;
+    };
+
+    namespace detail {
+
+        // Offset de W y b de cada Dense dentro del buffer de parámetros, en el orden de
+        // InferencePlan::bind. Solo capas sin estado compartido: cada lector arma su propio plan
+        // y una capa propia quedaría compartida entre hilos.
+        template <typename T>
+        std::vector<size_t> snapshot_layout(const NeuralNetwork<T>& net, const InferencePlan<T>& plan) {
+            for (LayerKind kind : net.layer_kinds())
+                if (kind != LayerKind::Dense && kind != LayerKind::ReLU && kind != LayerKind::Sigmoid)
+                    throw std::runtime_error("Las instantáneas de pesos solo admiten capas Dense, ReLU y Sigmoid");
+            const T* begin = net.parameter_buffer().values();
+            const T* end = begin + net.parameter_buffer().size();
+            std::vector<size_t> offsets;
+            for (const T* p : plan.weights()) {
+                if (std::less<const T*>{}(p, begin) || !std::less<const T*>{}(p, end))
+                    throw std::runtime_error("Pesos fuera del buffer de parámetros de la red");
+                offsets.push_back(size_t(p - begin));
+            }
+            return offsets;
+        }
+
+        template <typename T>
+        void bind_snapshot(InferencePlan<T>& plan, const std::vector<size_t>& offsets, const T* base,
+                           std::vector<const T*>& scratch) {
+            scratch.resize(offsets.size());
+            for (size_t i = 0; i < offsets.size(); ++i) scratch[i] = base + offsets[i];
+            plan.bind(scratch);
+        }
+
+    }
+
+    // Red objetivo congelada para los objetivos TD: una copia propia de los pesos y un plan de
+    // inferencia enlazado a ella. sync() es una sola copia del buffer plano; entre dos sync la
+    // red en vivo puede entrenar sin que cambien los valores que devuelve run().
+    template <typename T>
+    class TargetNetwork {
+    private:
+        using ConstView = utec::algebra::TensorView<const T>;
+
+        std::unique_ptr<InferencePlan<T>> plan_;
+        std::vector<size_t> offsets_;
+        WeightSnapshot<T> weights_;
+
+    public:
+        explicit TargetNetwork(const NeuralNetwork<T>& net, size_t max_rows = 1)
+                : plan_(net.make_plan(max_rows)), offsets_(detail::snapshot_layout(net, *plan_)) {
+            const auto& buffer = net.parameter_buffer();
+            weights_.values.assign(buffer.values(), buffer.values() + buffer.size());
+            std::vector<const T*> scratch;
+            detail::bind_snapshot(*plan_, offsets_, weights_.values.data(), scratch);
+        }
+
+        // Copia los pesos actuales de net, que debe tener la misma topología.
+        void sync(const NeuralNetwork<T>& net) {
+            const auto& buffer = net.parameter_buffer();
+            if (buffer.size() != weights_.values.size())
+                throw std::runtime_error("La red objetivo no corresponde a la topología de la red");
+            std::copy(buffer.values(), buffer.values() + buffer.size(), weights_.values.begin());
+            ++weights_.version;
+        }
+
+        uint64_t version() const { return weights_.version; }
+
+        // La vista devuelta vive en los buffers del plan hasta la siguiente llamada.
+        ConstView run(const ConstView& X) { return plan_->run(X); }
+        T score(const T* x) { return plan_->score(x); }
+    };
+
+    // Publicación de pesos al estilo RCU. El escritor (el learner) copia el buffer de la red a una
+    // instantánea nueva y la publica con un solo intercambio atómico de puntero; los lectores
+    // nunca toman un lock ni esperan al escritor. La recolección es por épocas: cada lector
+    // anota la época global en su slot mientras usa una instantánea, y una instantánea retirada
+    // en la época r se recicla cuando ningún slot activo anota una época menor que r. Las
+    // instantáneas recicladas se reutilizan en las publicaciones siguientes, así que publicar no
+    // reserva memoria en régimen estable.
+    template <typename T>
+    class SnapshotStore {
+    public:
+        static constexpr size_t MAX_READERS = 64;
+
+    private:
+        using ConstView = utec::algebra::TensorView<const T>;
+        using Snapshot = WeightSnapshot<T>;
+
+        static constexpr uint64_t IDLE = ~uint64_t(0);
+
+        struct alignas(64) Slot {
+            std::atomic<uint64_t> epoch{IDLE};
+            std::atomic<bool> used{false};
+        };
+
+        struct Retired {
+            Snapshot* snapshot;
+            uint64_t epoch;
+        };
+
+        const NeuralNetwork<T>& net_;
+        std::vector<size_t> offsets_;
+        size_t size_ = 0;
+
+        std::array<Slot, MAX_READERS> slots_;
+        std::atomic<Snapshot*> current_{nullptr};
+        std::atomic<uint64_t> epoch_{1};
+        std::atomic<uint64_t> version_{0};
+
+        std::mutex writer_mutex_;
+        std::vector<Retired> retired_;
+        std::vector<std::unique_ptr<Snapshot>> free_;
+
+        // Llamar con writer_mutex_ tomado.
+        void reclaim_locked() {
+            uint64_t oldest = IDLE;
+            for (const auto& s : slots_) oldest = std::min(oldest, s.epoch.load(std::memory_order_seq_cst));
+            auto keep = std::partition(retired_.begin(), retired_.end(),
+                                       [oldest](const Retired& r) { return r.epoch > oldest; });
+            for (auto it = keep; it != retired_.end(); ++it) free_.emplace_back(it->snapshot);
+            retired_.erase(keep, retired_.end());
+        }
+
+    public:
+        // Lector de un solo hilo: un slot del almacén y un plan de inferencia propio que se
+        // vuelve a enlazar solo cuando cambia la versión publicada. Cada llamada fija la
+        // instantánea vigente durante el forward y la suelta al terminar.
+        class Reader {
+        private:
+            SnapshotStore& store_;
+            size_t slot_ = 0;
+            std::unique_ptr<InferencePlan<T>> plan_;
+            std::vector<const T*> scratch_;
+            uint64_t version_ = 0;
+
+            struct Pin {
+                Slot& slot;
+                ~Pin() { slot.epoch.store(IDLE, std::memory_order_release); }
+            };
+
+            // La época se anota antes de leer el puntero: si el escritor ya retiró la
+            // instantánea que se lee, su época de retiro es mayor que la anotada.
+            Pin pin() {
+                Slot& slot = store_.slots_[slot_];
+                slot.epoch.store(store_.epoch_.load(std::memory_order_acquire), std::memory_order_seq_cst);
+                const Snapshot* snap = store_.current_.load(std::memory_order_seq_cst);
+                if (snap->version != version_) {
+                    detail::bind_snapshot(*plan_, store_.offsets_, snap->values.data(), scratch_);
+                    version_ = snap->version;
+                }
+                return Pin{slot};
+            }
+
+        public:
+            explicit Reader(SnapshotStore& store, size_t max_rows = 1)
+                    : store_(store), plan_(store.net_.make_plan(max_rows)) {
+                for (slot_ = 0; slot_ < MAX_READERS; ++slot_) {
+                    bool libre = false;
+                    if (store_.slots_[slot_].used.compare_exchange_strong(libre, true, std::memory_order_acquire))
+                        return;
+                }
+                throw std::runtime_error("No quedan lectores libres en el almacén de instantáneas");
+            }
+
+            ~Reader() { store_.slots_[slot_].used.store(false, std::memory_order_release); }
+
+            Reader(const Reader&) = delete;
+            Reader& operator=(const Reader&) = delete;
+
+            // La vista devuelta vive en los buffers del lector hasta la siguiente llamada.
+            ConstView run(const ConstView& X) {
+                Pin p = pin();
+                return plan_->run(X);
+            }
+
+            T score(const T* x) {
+                Pin p = pin();
+                return plan_->score(x);
+            }
+
+            // Versión con la que se evaluó la última llamada.
+            uint64_t version() const { return version_; }
+        };
+
+        // Publica los pesos actuales de net como versión 1. net debe vivir más que el almacén y
+        // no cambiar de topología; los lectores deben destruirse antes que el almacén.
+        explicit SnapshotStore(const NeuralNetwork<T>& net) : net_(net) {
+            offsets_ = detail::snapshot_layout(net, *net.make_plan());
+            size_ = net.parameter_buffer().size();
+            publish();
+        }
+
+        ~SnapshotStore() {
+            delete current_.load();
+            for (auto& r : retired_) delete r.snapshot;
+        }
+
+        SnapshotStore(const SnapshotStore&) = delete;
+        SnapshotStore& operator=(const SnapshotStore&) = delete;
+
+        // Copia los pesos actuales de la red y los publica; devuelve la versión nueva. Llamar
+        // desde el hilo que entrena la red (varios escritores se serializan entre sí).
+        uint64_t publish() {
+            std::lock_guard<std::mutex> lock(writer_mutex_);
+            const auto& buffer = net_.parameter_buffer();
+            if (buffer.size() != size_)
+                throw std::runtime_error("La topología de la red cambió desde que se creó el almacén de instantáneas");
+
+            reclaim_locked();
+            std::unique_ptr<Snapshot> next;
+            if (free_.empty()) {
+                next = std::make_unique<Snapshot>();
+            } else {
+                next = std::move(free_.back());
+                free_.pop_back();
+            }
+            const uint64_t version = version_.load(std::memory_order_relaxed) + 1;
+            next->values.assign(buffer.values(), buffer.values() + size_);
+            next->version = version;
+
+            Snapshot* old = current_.exchange(next.release(), std::memory_order_seq_cst);
+            if (old) retired_.push_back({old, epoch_.fetch_add(1, std::memory_order_seq_cst) + 1});
+            version_.store(version, std::memory_order_release);
+            return version;
+        }
+
+        uint64_t version() const { return version_.load(std::memory_order_acquire); }
+
+        // Instantáneas retiradas que algún lector todavía podría estar usando.
+        size_t pending() {
+            std::lock_guard<std::mutex> lock(writer_mutex_);
+            reclaim_locked();
+            return retired_.size();
+        }
+    };
+
+}
@@ -0,0 +1,169 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+#include "nn_interfaces.h"
+#include "nn_activation.h"
+
+namespace utec::neural_network {
+
+    template <typename T>
+    class NeuralNetwork;
+
+    // Redes de topología fija para inferencia: las dimensiones son parámetros de plantilla,
+    // los pesos viven en std::array dentro del objeto y el forward se resuelve en tiempo de
+    // compilación (sin capas virtuales, formas en tiempo de ejecución ni memoria dinámica), así
+    // que el compilador puede desenrollar y vectorizar toda la red.
+    namespace fixed {
+
+        template <size_t In, size_t Out>
+        struct Dense {
+            static constexpr LayerKind kind = LayerKind::Dense;
+        };
+
+        struct ReLU {
+            static constexpr LayerKind kind = LayerKind::ReLU;
+        };
+
+        struct Sigmoid {
+            static constexpr LayerKind kind = LayerKind::Sigmoid;
+        };
+
+        namespace detail {
+
+            // Cadena de capas a partir de una entrada de N valores. run(x, out) puede modificar x
+            // (las activaciones trabajan en el lugar) y escribe los valores finales en out.
+            template <typename T, size_t N, typename... Layers>
+            struct Chain {
+                static constexpr size_t output_size = N;
+                static constexpr size_t dense_count = 0;
+
+                void run(T* x, T* out) const {
+                    for (size_t j = 0; j < N; ++j) out[j] = x[j];
+                }
+
+                void load(const ParamRef<T>*) {}
+            };
+
+            template <typename T, size_t N, size_t In, size_t Out, typename... Rest>
+            struct Chain<T, N, Dense<In, Out>, Rest...> {
+                static_assert(In == N, "Las dimensiones de Dense no encadenan");
+                using Next = Chain<T, Out, Rest...>;
+                static constexpr size_t output_size = Next::output_size;
+                static constexpr size_t dense_count = 1 + Next::dense_count;
+
+                alignas(64) std::array<T, In * Out> W{};
+                alignas(64) std::array<T, Out> b{};
+                Next next;
+
+                // Acumuladores independientes sobre las filas de W: con uno solo, cada FMA espera
+                // a la anterior y la latencia de la cadena domina en capas tan chicas.
+                static constexpr size_t LANES = In >= 8 ? 4 : 1;
+
+                // y = b + x W con el bucle interno sobre las Out salidas contiguas de cada fila.
+                void run(T* x, T* out) const {
+                    alignas(64) std::array<std::array<T, Out>, LANES> acc{};
+                    for (size_t i = 0; i < In; ++i) {
+                        const T xi = x[i];
+                        const T* w = W.data() + i * Out;
+                        T* a = acc[i % LANES].data();
+                        for (size_t j = 0; j < Out; ++j) a[j] += xi * w[j];
+                    }
+                    alignas(64) std::array<T, Out> y = b;
+                    for (size_t l = 0; l < LANES; ++l)
+                        for (size_t j = 0; j < Out; ++j) y[j] += acc[l][j];
+                    next.run(y.data(), out);
+                }
+
+                void load(const ParamRef<T>* p) {
+                    if (p[0].value.shape() != std::array<size_t, 2>{In, Out} ||
+                        p[1].value.shape() != std::array<size_t, 2>{1, Out})
+                        throw std::runtime_error("Forma de Dense incompatible con la red estática");
+                    std::copy(p[0].value.data(), p[0].value.data() + p[0].value.size(), W.begin());
+                    std::copy(p[1].value.data(), p[1].value.data() + p[1].value.size(), b.begin());
+                    next.load(p + 2);
+                }
+            };
+
+            template <typename T, size_t N, typename... Rest>
+            struct Chain<T, N, ReLU, Rest...> {
+                using Next = Chain<T, N, Rest...>;
+                static constexpr size_t output_size = Next::output_size;
+                static constexpr size_t dense_count = Next::dense_count;
+                Next next;
+
+                void run(T* x, T* out) const {
+                    for (size_t j = 0; j < N; ++j) x[j] = neural_network::detail::relu_op<T>{}(x[j]);
+                    next.run(x, out);
+                }
+
+                void load(const ParamRef<T>* p) { next.load(p); }
+            };
+
+            template <typename T, size_t N, typename... Rest>
+            struct Chain<T, N, Sigmoid, Rest...> {
+                using Next = Chain<T, N, Rest...>;
+                static constexpr size_t output_size = Next::output_size;
+                static constexpr size_t dense_count = Next::dense_count;
+                Next next;
+
+                void run(T* x, T* out) const {
+                    for (size_t j = 0; j < N; ++j) x[j] = neural_network::detail::sigmoid_op<T>{}(x[j]);
+                    next.run(x, out);
+                }
+
+                void load(const ParamRef<T>* p) { next.load(p); }
+            };
+
+            template <size_t In, size_t Out>
+            constexpr size_t first_input(Dense<In, Out>*) { return In; }
+
+        }
+
+        // StaticNetwork<float, Dense<3,16>, ReLU, Dense<16,8>, ReLU, Dense<8,1>>. La primera capa
+        // debe ser Dense para fijar el tamaño de la entrada.
+        template <typename T, typename First, typename... Rest>
+        class StaticNetwork {
+        public:
+            static constexpr size_t input_size = detail::first_input(static_cast<First*>(nullptr));
+
+        private:
+            using Layers = detail::Chain<T, input_size, First, Rest...>;
+            Layers layers_;
+
+        public:
+            static constexpr size_t output_size = Layers::output_size;
+
+            // Pesos tomados de una NeuralNetwork entrenada con exactamente las mismas capas.
+            void load_from(NeuralNetwork<T>& net) {
+                constexpr std::array<LayerKind, 1 + sizeof...(Rest)> kinds{First::kind, Rest::kind...};
+                auto net_kinds = net.layer_kinds();
+                if (!std::equal(kinds.begin(), kinds.end(), net_kinds.begin(), net_kinds.end()))
+                    throw std::runtime_error("Topología incompatible con la red estática");
+                std::vector<ParamRef<T>> params;
+                net.parameters(params);
+                if (params.size() != 2 * Layers::dense_count)
+                    throw std::runtime_error("Topología incompatible con la red estática");
+                layers_.load(params.data());
+            }
+
+            void forward(const T* x, T* y) const {
+                alignas(64) std::array<T, input_size> in;
+                for (size_t j = 0; j < input_size; ++j) in[j] = x[j];
+                layers_.run(in.data(), y);
+            }
+
+            // Primera salida para una entrada de input_size valores.
+            T score(const T* x) const {
+                std::array<T, output_size> y;
+                forward(x, y.data());
+                return y[0];
+            }
+        };
+
+    }
+
+}
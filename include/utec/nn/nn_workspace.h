@@ -0,0 +1,86 @@
+#pragma once
+
+#include <vector>
+#include "tensor_view.h"
+#include "aligned_allocator.h"
+
+namespace utec::neural_network {
+
+    // Arena de activaciones y gradientes para una red. Se planifica para un número máximo de
+    // filas y las columnas de cada capa; un lote con menos filas usa el prefijo de cada buffer,
+    // así que entre pasos no se vuelve a reservar memoria.
+    //
+    //   activación 0      : entrada del lote (la primera capa guarda una vista de ella)
+    //   activación i + 1  : salida de la capa i (comparte buffer con la activación i si la
+    //                       capa corre en el lugar)
+    //   gradiente 0 / 1   : buffers alternados para el backward
+    //   objetivo          : Y del lote (mismas columnas que la salida)
+    template <typename T>
+    class Workspace {
+    private:
+        using View = utec::algebra::TensorView<T>;
+
+        // Cada buffer empieza en una línea de caché.
+        static constexpr size_t ALIGN_ELEMS = 64 / sizeof(T) ? 64 / sizeof(T) : 1;
+
+        std::vector<T, utec::algebra::AlignedAllocator<T>> arena_;
+        size_t rows_ = 0;
+        std::vector<size_t> cols_;
+        std::vector<bool> in_place_;
+        std::vector<size_t> act_offset_;
+        size_t grad_offset_[2] = {0, 0};
+        size_t grad_cols_ = 0;
+        size_t target_offset_ = 0;
+
+        static size_t round_up(size_t n) { return (n + ALIGN_ELEMS - 1) / ALIGN_ELEMS * ALIGN_ELEMS; }
+
+    public:
+        // cols[0] son las columnas de entrada y cols[i + 1] las de salida de la capa i;
+        // in_place[i] indica que la capa i escribe sobre su propia entrada.
+        void plan(size_t rows, const std::vector<size_t>& cols, const std::vector<bool>& in_place) {
+            rows_ = rows;
+            cols_ = cols;
+            in_place_ = in_place;
+            grad_cols_ = 0;
+            act_offset_.resize(cols.size());
+
+            size_t offset = 0;
+            for (size_t i = 0; i < cols.size(); ++i) {
+                grad_cols_ = std::max(grad_cols_, cols[i]);
+                if (i > 0 && in_place[i - 1] && cols[i] == cols[i - 1]) {
+                    act_offset_[i] = act_offset_[i - 1];
+                    continue;
+                }
+                act_offset_[i] = offset;
+                offset += round_up(rows * cols[i]);
+            }
+            for (auto& g : grad_offset_) {
+                g = offset;
+                offset += round_up(rows * grad_cols_);
+            }
+            target_offset_ = offset;
+            offset += round_up(rows * cols.back());
+            arena_.assign(offset, T(0));
+        }
+
+        bool fits(size_t rows, const std::vector<size_t>& cols, const std::vector<bool>& in_place) const {
+            return rows <= rows_ && cols == cols_ && in_place == in_place_;
+        }
+
+        size_t capacity_rows() const { return rows_; }
+        size_t bytes() const { return arena_.size() * sizeof(T); }
+
+        View activation(size_t i, size_t rows) {
+            return {arena_.data() + act_offset_[i], rows, cols_[i]};
+        }
+
+        View gradient(size_t slot, size_t rows, size_t cols) {
+            return {arena_.data() + grad_offset_[slot & 1], rows, cols};
+        }
+
+        View target(size_t rows) {
+            return {arena_.data() + target_offset_, rows, cols_.back()};
+        }
+    };
+
+}
@@ -0,0 +1,261 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <numbers>
+
+// Números aleatorios basados en contador: Philox4x32-10 (Salmon et al., SC'11). Cada bloque de
+// cuatro palabras de 32 bits es una función pura de (clave, contador), así que un flujo es
+// solo un id y una posición: no hay estado compartido entre hilos, cualquier flujo puede
+// saltar a cualquier posición y muchos flujos se generan a la vez en un bucle vectorizable.
+//
+// La clave sale de la semilla global (set_global_seed) y el contador de 128 bits se reparte en
+// la posición del bloque (64 bits bajos) y el id del flujo (64 bits altos), así que flujos con
+// ids distintos nunca comparten bloques. Con la misma semilla y los mismos ids, una corrida
+// en paralelo o por lotes es reproducible bit a bit sin ningún lock.
+
+namespace utec::random {
+
+    struct Key {
+        uint32_t k0, k1;
+    };
+
+    // Familias de ids de flujo: los 16 bits altos del id son la familia y los 48 bajos el
+    // índice dentro de ella (p. ej. el número de entorno o de actor).
+    enum class Domain : uint16_t { Env = 1, VectorEnv, Actor, Agent, Replay, Init, Shuffle, Thread };
+
+    inline constexpr uint64_t stream_id(Domain d, uint64_t index) {
+        return (uint64_t(d) << 48) | (index & ((uint64_t(1) << 48) - 1));
+    }
+
+    namespace detail {
+
+        inline constexpr uint32_t M0 = 0xD2511F53u, M1 = 0xCD9E8D57u;
+        inline constexpr uint32_t W0 = 0x9E3779B9u, W1 = 0xBB67AE85u;
+
+        // Bloques por tanda del generador por lotes: columnas de este largo entran en un
+        // registro AVX-512 (o en dos AVX2) por palabra.
+        inline constexpr size_t LANES = 16;
+
+        // Diez rondas sobre LANES contadores guardados por columnas. Cada carril es
+        // independiente, así que el compilador vectoriza el bucle interno (productos de 32x32
+        // a 64 bits con vpmuludq).
+        inline void philox_lanes(uint32_t* x0, uint32_t* x1, uint32_t* x2, uint32_t* x3, Key key) {
+            uint32_t k0 = key.k0, k1 = key.k1;
+            for (int r = 0; r < 10; ++r) {
+                for (size_t i = 0; i < LANES; ++i) {
+                    const uint64_t p0 = uint64_t(M0) * x0[i];
+                    const uint64_t p1 = uint64_t(M1) * x2[i];
+                    const uint32_t y0 = uint32_t(p1 >> 32) ^ x1[i] ^ k0;
+                    const uint32_t y2 = uint32_t(p0 >> 32) ^ x3[i] ^ k1;
+                    x1[i] = uint32_t(p1);
+                    x3[i] = uint32_t(p0);
+                    x0[i] = y0;
+                    x2[i] = y2;
+                }
+                k0 += W0;
+                k1 += W1;
+            }
+        }
+
+        // Uniforme en [0, 1) con 24 bits de mantisa.
+        inline float to_unit(uint32_t u) { return float(u >> 8) * (1.0f / 16777216.0f); }
+
+        // Uniforme en (0, 1], para el logaritmo de Box-Muller.
+        inline float to_open_unit(uint32_t u) { return float((u >> 8) + 1) * (1.0f / 16777216.0f); }
+
+        inline void box_muller(uint32_t a, uint32_t b, float& z0, float& z1) {
+            const float r = std::sqrt(-2.0f * std::log(to_open_unit(a)));
+            const float t = 2.0f * std::numbers::pi_v<float> * to_unit(b);
+            z0 = r * std::cos(t);
+            z1 = r * std::sin(t);
+        }
+
+        inline std::atomic<uint64_t>& seed_cell() {
+            static std::atomic<uint64_t> seed{0x853C49E6748FEA9Bull};
+            return seed;
+        }
+
+        inline std::atomic<uint64_t>& auto_index(Domain d) {
+            static std::array<std::atomic<uint64_t>, 16> next{};
+            return next[size_t(d) & 15];
+        }
+
+    }
+
+    // Semilla de todos los flujos que no reciben una propia. Fijarla antes de crear entornos,
+    // redes o hilos; los flujos ya creados conservan la clave con la que nacieron.
+    inline void set_global_seed(uint64_t seed) { detail::seed_cell().store(seed, std::memory_order_relaxed); }
+    inline uint64_t global_seed() { return detail::seed_cell().load(std::memory_order_relaxed); }
+
+    inline constexpr Key key_of(uint64_t seed) { return {uint32_t(seed), uint32_t(seed >> 32)}; }
+
+    // Un bloque de Philox4x32-10.
+    inline std::array<uint32_t, 4> philox4x32(std::array<uint32_t, 4> ctr, Key key) {
+        for (int r = 0; r < 10; ++r) {
+            const uint64_t p0 = uint64_t(detail::M0) * ctr[0];
+            const uint64_t p1 = uint64_t(detail::M1) * ctr[2];
+            ctr = {uint32_t(p1 >> 32) ^ ctr[1] ^ key.k0, uint32_t(p1), uint32_t(p0 >> 32) ^ ctr[3] ^ key.k1, uint32_t(p0)};
+            key.k0 += detail::W0;
+            key.k1 += detail::W1;
+        }
+        return ctr;
+    }
+
+    // Primero de n ids nuevos y consecutivos de la familia d, de la mitad alta de sus índices
+    // para no chocar con los que se eligen a mano. Se asignan en orden de llamada:
+    // reproducibles si los objetos se crean siempre en el mismo orden (p. ej. desde un hilo).
+    inline uint64_t next_streams(Domain d, uint64_t n) {
+        return stream_id(d, (uint64_t(1) << 47) | detail::auto_index(d).fetch_add(n, std::memory_order_relaxed));
+    }
+
+    inline uint64_t next_stream(Domain d) { return next_streams(d, 1); }
+
+    // Flujo de números de un solo dueño. Cumple UniformRandomBitGenerator, así que sirve para
+    // std::shuffle y las distribuciones de <random>. Las llamadas sueltas consumen de a una
+    // palabra de un bloque guardado; los lotes empiezan en el bloque siguiente y generan de a
+    // LANES bloques.
+    class Stream {
+    private:
+        Key key_;
+        uint64_t id_;
+        uint64_t block_ = 0;                 // siguiente bloque a generar
+        std::array<uint32_t, 4> buf_{};
+        unsigned used_ = 4;
+        float spare_ = 0;
+        bool has_spare_ = false;
+
+        void refill() {
+            buf_ = philox4x32({uint32_t(block_), uint32_t(block_ >> 32), uint32_t(id_), uint32_t(id_ >> 32)}, key_);
+            ++block_;
+            used_ = 0;
+        }
+
+        // count bloques consecutivos desde block_, de a LANES: f(x0, x1, x2, x3, primero, m)
+        // recibe las cuatro palabras por columnas de los m bloques de la tanda.
+        template <typename F>
+        void blocks(size_t count, F f) {
+            alignas(64) uint32_t x0[detail::LANES], x1[detail::LANES], x2[detail::LANES], x3[detail::LANES];
+            for (size_t done = 0; done < count; done += detail::LANES) {
+                for (size_t i = 0; i < detail::LANES; ++i) {
+                    const uint64_t b = block_ + i;
+                    x0[i] = uint32_t(b);
+                    x1[i] = uint32_t(b >> 32);
+                    x2[i] = uint32_t(id_);
+                    x3[i] = uint32_t(id_ >> 32);
+                }
+                detail::philox_lanes(x0, x1, x2, x3, key_);
+                const size_t m = std::min(detail::LANES, count - done);
+                f(x0, x1, x2, x3, done, m);
+                block_ += m;
+            }
+            used_ = 4;
+            has_spare_ = false;
+        }
+
+    public:
+        using result_type = uint32_t;
+        static constexpr result_type min() { return 0; }
+        static constexpr result_type max() { return 0xFFFFFFFFu; }
+
+        explicit Stream(uint64_t id, uint64_t seed = global_seed()) : key_(key_of(seed)), id_(id) {}
+
+        result_type operator()() {
+            if (used_ == 4) refill();
+            return buf_[used_++];
+        }
+
+        float uniform() { return detail::to_unit((*this)()); }
+        float uniform(float lo, float hi) { return lo + (hi - lo) * uniform(); }
+
+        // Normal estándar por Box-Muller; guarda el segundo valor del par para la siguiente.
+        float normal() {
+            if (has_spare_) {
+                has_spare_ = false;
+                return spare_;
+            }
+            const uint32_t a = (*this)(), b = (*this)();
+            float z0;
+            detail::box_muller(a, b, z0, spare_);
+            has_spare_ = true;
+            return z0;
+        }
+
+        // n uniformes en [lo, hi), en el orden en que los darían las llamadas sueltas desde el
+        // inicio de un bloque.
+        void uniform(float* out, size_t n, float lo = 0.0f, float hi = 1.0f) {
+            const float scale = hi - lo;
+            blocks((n + 3) / 4, [&](const uint32_t* x0, const uint32_t* x1, const uint32_t* x2, const uint32_t* x3,
+                                    size_t first, size_t m) {
+                float tmp[4 * detail::LANES];
+                for (size_t i = 0; i < detail::LANES; ++i) {
+                    tmp[4 * i] = lo + scale * detail::to_unit(x0[i]);
+                    tmp[4 * i + 1] = lo + scale * detail::to_unit(x1[i]);
+                    tmp[4 * i + 2] = lo + scale * detail::to_unit(x2[i]);
+                    tmp[4 * i + 3] = lo + scale * detail::to_unit(x3[i]);
+                }
+                std::copy_n(tmp, std::min(4 * m, n - 4 * first), out + 4 * first);
+            });
+        }
+
+        // n normales con media y desviación dadas (Box-Muller sobre los pares de cada bloque).
+        void normal(float* out, size_t n, float mean = 0.0f, float stddev = 1.0f) {
+            blocks((n + 3) / 4, [&](const uint32_t* x0, const uint32_t* x1, const uint32_t* x2, const uint32_t* x3,
+                                    size_t first, size_t m) {
+                float tmp[4 * detail::LANES];
+                for (size_t i = 0; i < m; ++i) {
+                    detail::box_muller(x0[i], x1[i], tmp[4 * i], tmp[4 * i + 1]);
+                    detail::box_muller(x2[i], x3[i], tmp[4 * i + 2], tmp[4 * i + 3]);
+                }
+                for (size_t j = 0; j < 4 * m; ++j) tmp[j] = mean + stddev * tmp[j];
+                std::copy_n(tmp, std::min(4 * m, n - 4 * first), out + 4 * first);
+            });
+        }
+
+        uint64_t id() const { return id_; }
+
+        // Lleva el flujo al bloque b (descarta lo guardado).
+        void seek(uint64_t b) {
+            block_ = b;
+            used_ = 4;
+            has_spare_ = false;
+        }
+    };
+
+    // Las cuatro palabras del bloque position de cada uno de los flujos first, ..., first + n - 1,
+    // como uniformes en [0, 1) por columnas: out[w * n + i] es la palabra w del flujo first + i,
+    // el mismo valor que daría la llamada w + 1 de un Stream de ese id llevado a ese bloque. Así
+    // n entornos sortean cuatro pasos en un solo bucle vectorizado.
+    inline void uniform_streams(uint64_t first, size_t n, uint64_t position, float* out, uint64_t seed = global_seed()) {
+        alignas(64) uint32_t x0[detail::LANES], x1[detail::LANES], x2[detail::LANES], x3[detail::LANES];
+        const Key key = key_of(seed);
+        for (size_t done = 0; done < n; done += detail::LANES) {
+            for (size_t i = 0; i < detail::LANES; ++i) {
+                const uint64_t id = first + done + i;
+                x0[i] = uint32_t(position);
+                x1[i] = uint32_t(position >> 32);
+                x2[i] = uint32_t(id);
+                x3[i] = uint32_t(id >> 32);
+            }
+            detail::philox_lanes(x0, x1, x2, x3, key);
+            const size_t m = std::min(detail::LANES, n - done);
+            for (size_t i = 0; i < m; ++i) {
+                out[done + i] = detail::to_unit(x0[i]);
+                out[n + done + i] = detail::to_unit(x1[i]);
+                out[2 * n + done + i] = detail::to_unit(x2[i]);
+                out[3 * n + done + i] = detail::to_unit(x3[i]);
+            }
+        }
+    }
+
+    // Flujo propio del hilo que llama, con un id de Domain::Thread asignado en su primer uso.
+    inline Stream& thread_stream() {
+        thread_local Stream stream(next_stream(Domain::Thread));
+        return stream;
+    }
+
+}
@@ -1,37 +1,220 @@
 #pragma once
-#include <queue>
-#include <mutex>
-#include <condition_variable>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <utility>
 
 namespace utec::thread {
 
+    // Cola MPMC acotada sin locks (anillo de Vyukov). Cada celda lleva un número de secuencia:
+    // seq == pos indica celda libre para el productor de la vuelta pos, seq == pos + 1 celda
+    // publicada para el consumidor. Productores y consumidores solo compiten por un CAS sobre su
+    // propio índice. Las variantes bloqueantes duermen con std::atomic::wait y solo pagan la
+    // notificación cuando hay alguien esperando.
     template<typename T>
     class ConcurrentQueue {
     private:
-        std::queue<T> queue_;
-        std::mutex mutex_;
-        std::condition_variable cond_var_;
+        struct Cell {
+            std::atomic<size_t> seq;
+            alignas(T) unsigned char storage[sizeof(T)];
+
+            T* item() { return std::launder(reinterpret_cast<T*>(storage)); }
+        };
+
+        static constexpr size_t CACHE_LINE = 64;
+
+        size_t mask_;
+        std::unique_ptr<Cell[]> cells_;
+        alignas(CACHE_LINE) std::atomic<size_t> enqueue_pos_{0};
+        alignas(CACHE_LINE) std::atomic<size_t> dequeue_pos_{0};
+
+        // Esperas: el contador de época cambia en cada notificación y waiters_ cuenta a los
+        // que se anotaron para dormir desde la última; sin anotados no hay fetch_add ni notify.
+        alignas(CACHE_LINE) std::atomic<uint32_t> items_epoch_{0};
+        std::atomic<uint32_t> item_waiters_{0};
+        alignas(CACHE_LINE) std::atomic<uint32_t> space_epoch_{0};
+        std::atomic<uint32_t> space_waiters_{0};
+
+        static size_t round_up_pow2(size_t n) {
+            size_t p = 2;
+            while (p < n) p <<= 1;
+            return p;
+        }
+
+        static constexpr int SPIN_ROUNDS = 32;
+
+        // Despierta a todos los anotados y reinicia la cuenta: hasta que alguien vuelva a
+        // anotarse, las operaciones siguientes no hacen llamadas al sistema.
+        static void wake(std::atomic<uint32_t>& epoch, std::atomic<uint32_t>& waiters) {
+            // Ordena la publicación de la celda antes de leer waiters_ (ver wait_on).
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (waiters.load(std::memory_order_relaxed) == 0) return;
+            if (waiters.exchange(0, std::memory_order_acq_rel) == 0) return;
+            epoch.fetch_add(1, std::memory_order_release);
+            epoch.notify_all();
+        }
+
+        // Duerme hasta que ready() sea cierto. ready() se reintenta tras anotarse como
+        // esperando, así que una publicación que no vio al esperador ya es visible aquí.
+        template <typename Ready>
+        static void wait_on(std::atomic<uint32_t>& epoch, std::atomic<uint32_t>& waiters, Ready ready) {
+            for (int spin = 0; spin < SPIN_ROUNDS; ++spin) {
+                if (ready()) return;
+                std::this_thread::yield();
+            }
+            while (true) {
+                uint32_t e = epoch.load(std::memory_order_acquire);
+                waiters.fetch_add(1, std::memory_order_seq_cst);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                if (ready()) return;
+                epoch.wait(e, std::memory_order_acquire);
+            }
+        }
+
+        // Reserva hasta n posiciones consecutivas en pos_ cuyas celdas tengan seq == pos + i + offset.
+        size_t claim(std::atomic<size_t>& pos_, size_t offset, size_t n, size_t& first) {
+            size_t pos = pos_.load(std::memory_order_relaxed);
+            while (true) {
+                size_t k = 0;
+                bool stale = false;
+                for (; k < n; ++k) {
+                    size_t seq = cells_[(pos + k) & mask_].seq.load(std::memory_order_acquire);
+                    auto diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + k + offset);
+                    if (diff != 0) {
+                        stale = k == 0 && diff > 0;     // otro hilo ya tomó pos: releer
+                        break;
+                    }
+                }
+                if (stale) {
+                    pos = pos_.load(std::memory_order_relaxed);
+                    continue;
+                }
+                if (k == 0) return 0;
+                if (pos_.compare_exchange_weak(pos, pos + k, std::memory_order_relaxed)) {
+                    first = pos;
+                    return k;
+                }
+            }
+        }
+
+        template <typename U>
+        void publish(size_t pos, U&& item) {
+            Cell& c = cells_[pos & mask_];
+            new (c.storage) T(std::forward<U>(item));
+            c.seq.store(pos + 1, std::memory_order_release);
+        }
+
+        T consume(size_t pos) {
+            Cell& c = cells_[pos & mask_];
+            T item(std::move(*c.item()));
+            c.item()->~T();
+            c.seq.store(pos + mask_ + 1, std::memory_order_release);
+            return item;
+        }
 
     public:
+        explicit ConcurrentQueue(size_t capacity = 1024)
+                : mask_(round_up_pow2(capacity) - 1), cells_(new Cell[mask_ + 1]) {
+            for (size_t i = 0; i <= mask_; ++i) cells_[i].seq.store(i, std::memory_order_relaxed);
+        }
+
+        ~ConcurrentQueue() {
+            while (try_pop()) {}
+        }
+
+        ConcurrentQueue(const ConcurrentQueue&) = delete;
+        ConcurrentQueue& operator=(const ConcurrentQueue&) = delete;
+
+        size_t capacity() const { return mask_ + 1; }
+
+        // Aproximado bajo concurrencia.
+        size_t size_approx() const {
+            size_t head = dequeue_pos_.load(std::memory_order_relaxed);
+            size_t tail = enqueue_pos_.load(std::memory_order_relaxed);
+            return tail > head ? tail - head : 0;
+        }
+
+        bool empty() const { return size_approx() == 0; }
+
+        template <typename U>
+        bool try_push(U&& item) {
+            size_t pos;
+            if (claim(enqueue_pos_, 0, 1, pos) == 0) return false;
+            publish(pos, std::forward<U>(item));
+            wake(items_epoch_, item_waiters_);
+            return true;
+        }
+
+        bool try_pop(T& out) {
+            size_t pos;
+            if (claim(dequeue_pos_, 1, 1, pos) == 0) return false;
+            out = consume(pos);
+            wake(space_epoch_, space_waiters_);
+            return true;
+        }
+
+        std::optional<T> try_pop() {
+            size_t pos;
+            if (claim(dequeue_pos_, 1, 1, pos) == 0) return std::nullopt;
+            std::optional<T> out(consume(pos));
+            wake(space_epoch_, space_waiters_);
+            return out;
+        }
+
+        // Mueve hasta n elementos desde first con una sola reserva; devuelve cuántos entraron.
+        template <typename It>
+        size_t push_bulk(It first, size_t n) {
+            size_t pos;
+            size_t k = claim(enqueue_pos_, 0, n, pos);
+            for (size_t i = 0; i < k; ++i, ++first) publish(pos + i, std::move(*first));
+            if (k) wake(items_epoch_, item_waiters_);
+            return k;
+        }
+
+        // Saca hasta n elementos hacia out; devuelve cuántos.
+        template <typename It>
+        size_t pop_bulk(It out, size_t n) {
+            size_t pos;
+            size_t k = claim(dequeue_pos_, 1, n, pos);
+            for (size_t i = 0; i < k; ++i, ++out) *out = consume(pos + i);
+            if (k) wake(space_epoch_, space_waiters_);
+            return k;
+        }
+
+        // Bloqueantes: esperan lugar o un elemento.
         void push(const T& item) {
-            {
-                std::lock_guard<std::mutex> lock(mutex_);
-                queue_.push(item);
-            }
-            cond_var_.notify_one();
+            wait_on(space_epoch_, space_waiters_, [&] { return try_push(item); });
+        }
+
+        void push(T&& item) {
+            wait_on(space_epoch_, space_waiters_, [&] { return try_push(std::move(item)); });
         }
 
         T pop() {
-            std::unique_lock<std::mutex> lock(mutex_);
-            cond_var_.wait(lock, [this] { return !queue_.empty(); });
-            T item = queue_.front();
-            queue_.pop();
-            return item;
+            std::optional<T> item;
+            wait_on(items_epoch_, item_waiters_, [&] { return bool(item = try_pop()); });
+            return std::move(*item);
         }
 
-        bool empty() const {
-            std::lock_guard<std::mutex> lock(mutex_);
-            return queue_.empty();
+        // Espera acotada (sondeo con retroceso: std::atomic::wait no admite plazos).
+        template <typename Rep, typename Period>
+        bool pop_for(T& out, std::chrono::duration<Rep, Period> timeout) {
+            auto deadline = std::chrono::steady_clock::now() + timeout;
+            auto pause = std::chrono::microseconds(1);
+            while (!try_pop(out)) {
+                if (std::chrono::steady_clock::now() >= deadline) return false;
+                std::this_thread::sleep_for(pause);
+                pause = std::min(pause * 2, std::chrono::microseconds(1000));
+            }
+            return true;
         }
     };
 
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "utec/thread/ThreadPool.h"
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+namespace utec::thread::intra_op {
+
+    // Paralelismo dentro de una operación (GEMM, reducciones de bias, optimizadores) sobre un
+    // pool compartido. Cada operación se reparte en trozos disjuntos de su salida y cada
+    // elemento se calcula siempre en el mismo orden, así que el resultado es idéntico bit a
+    // bit con cualquier número de hilos.
+
+    inline std::atomic<size_t>& thread_setting() {
+        static std::atomic<size_t> n{std::max<size_t>(1, std::thread::hardware_concurrency())};
+        return n;
+    }
+
+    // Hilos por operación, contando al que llama; 1 deja todo en serie. El pool se crea en el
+    // primer uso con max(threads(), núcleos) - 1 workers, así que subirlo por encima de los
+    // núcleos solo tiene efecto antes de la primera operación paralela.
+    inline void set_threads(size_t n) { thread_setting().store(std::max<size_t>(1, n)); }
+    inline size_t threads() { return thread_setting().load(std::memory_order_relaxed); }
+
+    inline ThreadPool& pool() {
+        static ThreadPool p(std::max<size_t>(threads(), std::thread::hardware_concurrency()) - 1);
+        return p;
+    }
+
+    // f(i0, i1) sobre [0, n) en trozos de grain. Corre en serie (f(0, n)) si hay un solo hilo,
+    // un solo trozo o si work, el costo estimado de la operación, no llega a min_work.
+    template <typename F>
+    void for_tiles(size_t n, size_t grain, size_t work, size_t min_work, F&& f) {
+        const size_t t = threads();
+        if (t <= 1 || n <= grain || work < min_work) {
+            f(size_t(0), n);
+            return;
+        }
+        pool().parallel_for(0, n, grain, f, t - 1);
+    }
+
+}
@@ -3,23 +3,270 @@
 #include "utec/thread/ThreadPool.h"
 #include "utec/agent/PongAgent.h"
 #include "utec/agent/State.h"
+#include "utec/nn/nn_snapshot.h"
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <mutex>
 
 namespace utec::thread {
 
+    // Parámetros del modo por lotes: el lote se despacha al llegar a max_batch estados o cuando
+    // el más antiguo lleva max_wait esperando, lo que ocurra primero.
+    struct BatchingConfig {
+        size_t max_batch = 64;
+        std::chrono::microseconds max_wait{200};
+    };
+
+    struct ExecutorStats {
+        size_t requests = 0;
+        size_t batches = 0;
+        double mean_batch = 0;
+        double p50_us = 0;
+        double p99_us = 0;
+        double throughput = 0;     // solicitudes por segundo entre la primera y la última
+    };
+
+    // Dos modos. Por solicitud: cada infer_async es una tarea del pool que llama a act()
+    // (serializado, porque la red guarda estado entre forward y backward). Por lotes: un hilo
+    // dedicado junta los estados pendientes, hace un solo forward con act_batch y cumple las
+    // promesas en bloque; solo ese hilo toca la red.
+    // Construido sobre un SnapshotStore en vez de un agente, cada worker (o el despachador)
+    // evalúa con su propio lector de la última versión publicada: sin mutex entre solicitudes
+    // y sin esperar nunca al hilo que entrena.
     template<typename T>
     class ParallelExecutor {
     private:
-        ThreadPool pool_;
-        utec::nn::PongAgent<T>& agent_;
+        using Clock = std::chrono::steady_clock;
+
+        struct Request {
+            utec::nn::State state;
+            std::promise<int> result;
+            Clock::time_point arrival;
+        };
+
+        using Reader = typename utec::neural_network::SnapshotStore<T>::Reader;
+
+        utec::nn::PongAgent<T>* agent_ = nullptr;
+        std::mutex agent_mutex_;
+        std::unique_ptr<ThreadPool> pool_;
+
+        // Con SnapshotStore: un lector por worker del pool y uno más, con spare_mutex_, para
+        // tareas que corra un hilo ajeno al pool; en modo por lotes, solo el del despachador.
+        std::vector<std::unique_ptr<Reader>> readers_;
+        std::mutex spare_mutex_;
+
+        BatchingConfig config_;
+        bool batching_ = false;
+        std::vector<Request> pending_, in_flight_;
+        std::mutex pending_mutex_;
+        std::condition_variable pending_cv_;
+        bool stop_ = false;
+        std::thread batcher_;
+
+        // Latencias en un anillo de tamaño fijo: las estadísticas cubren las últimas
+        // LATENCY_WINDOW solicitudes sin crecer con el tiempo de ejecución.
+        static constexpr size_t LATENCY_WINDOW = 1 << 16;
+        mutable std::mutex stats_mutex_;
+        std::vector<double> latencies_us_;
+        size_t requests_ = 0, batches_ = 0;
+        Clock::time_point first_arrival_, last_done_;
+
+        utec::algebra::Tensor<T,2> obs_;
+        std::vector<int> actions_;
+
+        // Llamar con stats_mutex_ tomado.
+        void record_locked(Clock::time_point arrival, Clock::time_point done) {
+            if (requests_ == 0) first_arrival_ = arrival;
+            double us = std::chrono::duration<double, std::micro>(done - arrival).count();
+            if (latencies_us_.size() < LATENCY_WINDOW) latencies_us_.push_back(us);
+            else latencies_us_[requests_ % LATENCY_WINDOW] = us;
+            ++requests_;
+            last_done_ = done;
+        }
+
+        void run_batch() {
+            // act_batch normaliza cada fila por su cuenta; las instantáneas reciben la entrada ya
+            // codificada, la misma con la que entrena el learner.
+            const size_t n = in_flight_.size();
+            for (size_t i = 0; i < n; ++i) {
+                const utec::nn::State& s = in_flight_[i].state;
+                if (agent_) {
+                    obs_(i, 0) = s.ball_x;
+                    obs_(i, 1) = s.ball_y;
+                    obs_(i, 2) = s.paddle_y;
+                } else {
+                    utec::nn::PongAgent<T>::encode(s, &obs_(i, 0));
+                }
+            }
+            std::exception_ptr error;
+            try {
+                auto obs = std::as_const(obs_).view().slice_rows(0, n);
+                if (agent_) {
+                    agent_->act_batch(obs, actions_.data());
+                } else {
+                    auto q = readers_[0]->run(obs);
+                    for (size_t i = 0; i < n; ++i) actions_[i] = utec::nn::PongAgent<T>::to_action(q(i, 0));
+                }
+            } catch (...) {
+                error = std::current_exception();
+            }
+            // Las estadísticas se anotan antes de cumplir las promesas: quien ya tiene su
+            // resultado ve el lote contado.
+            auto done = Clock::now();
+            {
+                std::lock_guard<std::mutex> lock(stats_mutex_);
+                for (auto& r : in_flight_) record_locked(r.arrival, done);
+                ++batches_;
+            }
+            for (size_t i = 0; i < n; ++i) {
+                if (error) in_flight_[i].result.set_exception(error);
+                else in_flight_[i].result.set_value(actions_[i]);
+            }
+            in_flight_.clear();
+        }
+
+        void batcher_loop() {
+            std::unique_lock<std::mutex> lock(pending_mutex_);
+            while (true) {
+                pending_cv_.wait(lock, [this] { return stop_ || !pending_.empty(); });
+                if (pending_.empty()) return;
+
+                auto deadline = pending_.front().arrival + config_.max_wait;
+                pending_cv_.wait_until(lock, deadline, [this] {
+                    return stop_ || pending_.size() >= config_.max_batch;
+                });
+
+                // Se despachan a lo sumo max_batch; el resto espera la siguiente vuelta con su
+                // propio plazo. Los vectores se intercambian para reutilizar su capacidad.
+                if (pending_.size() <= config_.max_batch) {
+                    std::swap(pending_, in_flight_);
+                } else {
+                    auto first = pending_.begin(), last = first + config_.max_batch;
+                    in_flight_.insert(in_flight_.end(), std::make_move_iterator(first), std::make_move_iterator(last));
+                    pending_.erase(first, last);
+                }
+                lock.unlock();
+                run_batch();
+                lock.lock();
+            }
+        }
+
+        int act_snapshot(const utec::nn::State& s) {
+            T input[3];
+            utec::nn::PongAgent<T>::encode(s, input);
+            const size_t w = pool_->worker_index();
+            if (w < pool_->size()) return utec::nn::PongAgent<T>::to_action(readers_[w]->score(input));
+            std::lock_guard<std::mutex> lock(spare_mutex_);
+            return utec::nn::PongAgent<T>::to_action(readers_.back()->score(input));
+        }
+
+        explicit ParallelExecutor(BatchingConfig config)
+                : config_(config), batching_(true),
+                  obs_(std::max<size_t>(config.max_batch, 1), 3),
+                  actions_(std::max<size_t>(config.max_batch, 1)) {
+            if (config_.max_batch == 0) config_.max_batch = 1;
+            pending_.reserve(config_.max_batch);
+            in_flight_.reserve(config_.max_batch);
+            latencies_us_.reserve(LATENCY_WINDOW);
+        }
 
     public:
         ParallelExecutor(size_t threads, utec::nn::PongAgent<T>& agent)
-                : pool_(threads), agent_(agent) {}
+                : agent_(&agent), pool_(std::make_unique<ThreadPool>(threads)) {}
+
+        ParallelExecutor(utec::nn::PongAgent<T>& agent, BatchingConfig config)
+                : ParallelExecutor(config) {
+            agent_ = &agent;
+            batcher_ = std::thread([this] { batcher_loop(); });
+        }
+
+        ParallelExecutor(size_t threads, utec::neural_network::SnapshotStore<T>& store)
+                : pool_(std::make_unique<ThreadPool>(threads)) {
+            for (size_t i = 0; i <= pool_->size(); ++i) readers_.push_back(std::make_unique<Reader>(store));
+        }
+
+        ParallelExecutor(utec::neural_network::SnapshotStore<T>& store, BatchingConfig config)
+                : ParallelExecutor(config) {
+            readers_.push_back(std::make_unique<Reader>(store, config_.max_batch));
+            batcher_ = std::thread([this] { batcher_loop(); });
+        }
+
+        // Al destruirse se termina todo lo pendiente antes de liberar las estadísticas, buffers y
+        // lectores que usan los hilos.
+        ~ParallelExecutor() {
+            if (!batching_) {
+                pool_.reset();
+                return;
+            }
+            {
+                std::lock_guard<std::mutex> lock(pending_mutex_);
+                stop_ = true;
+            }
+            pending_cv_.notify_one();
+            if (batcher_.joinable()) batcher_.join();
+        }
+
+        ParallelExecutor(const ParallelExecutor&) = delete;
+        ParallelExecutor& operator=(const ParallelExecutor&) = delete;
+
+        bool batching() const { return batching_; }
 
         std::future<int> infer_async(const utec::nn::State& s) {
-            return pool_.enqueue([this, s]() {
-                return agent_.act(s);
-            });
+            if (!batching_) {
+                auto arrival = Clock::now();
+                return pool_->enqueue([this, s, arrival]() {
+                    int a;
+                    if (agent_) {
+                        std::lock_guard<std::mutex> lock(agent_mutex_);
+                        a = agent_->act(s);
+                    } else {
+                        a = act_snapshot(s);
+                    }
+                    std::lock_guard<std::mutex> lock(stats_mutex_);
+                    record_locked(arrival, Clock::now());
+                    return a;
+                });
+            }
+
+            std::future<int> res;
+            bool full;
+            {
+                std::lock_guard<std::mutex> lock(pending_mutex_);
+                pending_.push_back({s, std::promise<int>(), Clock::now()});
+                res = pending_.back().result.get_future();
+                full = pending_.size() == 1 || pending_.size() >= config_.max_batch;
+            }
+            // Basta despertar al despachador al abrir un lote (para fijar el plazo) o al llenarlo.
+            if (full) pending_cv_.notify_one();
+            return res;
+        }
+
+        ExecutorStats stats() const {
+            std::lock_guard<std::mutex> lock(stats_mutex_);
+            ExecutorStats st;
+            st.requests = requests_;
+            st.batches = batching_ ? batches_ : requests_;
+            if (requests_ == 0) return st;
+            st.mean_batch = double(st.requests) / double(std::max<size_t>(st.batches, 1));
+
+            std::vector<double> lat = latencies_us_;
+            auto percentile = [&](double q) {
+                auto it = lat.begin() + size_t(q * double(lat.size() - 1));
+                std::nth_element(lat.begin(), it, lat.end());
+                return *it;
+            };
+            st.p50_us = percentile(0.50);
+            st.p99_us = percentile(0.99);
+            double secs = std::chrono::duration<double>(last_done_ - first_arrival_).count();
+            st.throughput = secs > 0 ? double(requests_) / secs : 0;
+            return st;
+        }
+
+        void reset_stats() {
+            std::lock_guard<std::mutex> lock(stats_mutex_);
+            latencies_us_.clear();
+            requests_ = batches_ = 0;
         }
     };
 
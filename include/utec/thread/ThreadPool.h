@@ -1,69 +1,373 @@
 #pragma once
 #include <vector>
+#include <algorithm>
 #include <thread>
-#include <queue>
+#include <deque>
 #include <mutex>
 #include <condition_variable>
 #include <functional>
 #include <future>
 #include <type_traits>
+#include <atomic>
+#include <memory>
+#include <new>
+#include <tuple>
+#include <cstdint>
+#include <cstddef>
 
 namespace utec::thread {
 
+    namespace detail {
+
+        // Tarea intrusiva: el callable vive dentro del nodo si cabe en INLINE_BYTES, así que
+        // cada tarea cuesta una sola reserva (el nodo) en vez de shared_ptr + packaged_task +
+        // std::function. Admite callables que solo se pueden mover.
+        class Job {
+        private:
+            static constexpr size_t INLINE_BYTES = 64;
+
+            alignas(std::max_align_t) unsigned char storage_[INLINE_BYTES];
+            void* target_ = nullptr;
+            void (*invoke_)(void*) = nullptr;
+            void (*destroy_)(void*, bool) = nullptr;
+            bool inline_ = false;
+
+        public:
+            template <typename F>
+            explicit Job(F&& f) {
+                using Fn = std::decay_t<F>;
+                if constexpr (sizeof(Fn) <= INLINE_BYTES && alignof(Fn) <= alignof(std::max_align_t)) {
+                    target_ = new (storage_) Fn(std::forward<F>(f));
+                    inline_ = true;
+                } else {
+                    target_ = new Fn(std::forward<F>(f));
+                }
+                invoke_ = [](void* p) { (*static_cast<Fn*>(p))(); };
+                destroy_ = [](void* p, bool in_place) {
+                    if (in_place) static_cast<Fn*>(p)->~Fn();
+                    else delete static_cast<Fn*>(p);
+                };
+            }
+
+            Job(const Job&) = delete;
+            Job& operator=(const Job&) = delete;
+
+            ~Job() { destroy_(target_, inline_); }
+
+            void run() { invoke_(target_); }
+        };
+
+        // Deque de Chase-Lev (versión de Lê et al. para el modelo de memoria de C11): el dueño
+        // empuja y saca por abajo sin locks; los ladrones roban por arriba con un CAS. El
+        // arreglo crece al llenarse y los viejos se conservan hasta destruir el deque, porque un
+        // ladrón puede estar leyéndolos.
+        class WorkStealingDeque {
+        private:
+            struct Array {
+                int64_t capacity;
+                std::unique_ptr<std::atomic<Job*>[]> slots;
+
+                explicit Array(int64_t cap) : capacity(cap), slots(new std::atomic<Job*>[cap]) {}
+
+                Job* get(int64_t i) const { return slots[i & (capacity - 1)].load(std::memory_order_relaxed); }
+                void put(int64_t i, Job* j) { slots[i & (capacity - 1)].store(j, std::memory_order_relaxed); }
+            };
+
+            alignas(64) std::atomic<int64_t> top_{0};
+            alignas(64) std::atomic<int64_t> bottom_{0};
+            std::atomic<Array*> array_;
+            std::vector<std::unique_ptr<Array>> arrays_;
+
+        public:
+            explicit WorkStealingDeque(int64_t capacity = 256) {
+                arrays_.push_back(std::make_unique<Array>(capacity));
+                array_.store(arrays_.back().get(), std::memory_order_relaxed);
+            }
+
+            // Solo el hilo dueño.
+            void push(Job* job) {
+                int64_t b = bottom_.load(std::memory_order_relaxed);
+                int64_t t = top_.load(std::memory_order_acquire);
+                Array* a = array_.load(std::memory_order_relaxed);
+                if (b - t > a->capacity - 1) {
+                    auto bigger = std::make_unique<Array>(a->capacity * 2);
+                    for (int64_t i = t; i < b; ++i) bigger->put(i, a->get(i));
+                    a = bigger.get();
+                    arrays_.push_back(std::move(bigger));
+                    array_.store(a, std::memory_order_release);
+                }
+                a->put(b, job);
+                // Publica el slot (y el nodo) para el ladrón que lea bottom_ con acquire.
+                bottom_.store(b + 1, std::memory_order_release);
+            }
+
+            // Solo el hilo dueño.
+            Job* pop() {
+                int64_t b = bottom_.load(std::memory_order_relaxed) - 1;
+                Array* a = array_.load(std::memory_order_relaxed);
+                bottom_.store(b, std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                int64_t t = top_.load(std::memory_order_relaxed);
+                if (t > b) {
+                    bottom_.store(b + 1, std::memory_order_relaxed);
+                    return nullptr;
+                }
+                Job* job = a->get(b);
+                if (t == b) {
+                    // Último elemento: se disputa con los ladrones.
+                    if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                                      std::memory_order_relaxed))
+                        job = nullptr;
+                    bottom_.store(b + 1, std::memory_order_relaxed);
+                }
+                return job;
+            }
+
+            // Cualquier hilo.
+            Job* steal() {
+                int64_t t = top_.load(std::memory_order_acquire);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                int64_t b = bottom_.load(std::memory_order_acquire);
+                if (t >= b) return nullptr;
+                Array* a = array_.load(std::memory_order_acquire);
+                Job* job = a->get(t);
+                if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                                  std::memory_order_relaxed))
+                    return nullptr;
+                return job;
+            }
+        };
+
+        // Worker que corre en el hilo actual (pool nulo fuera de cualquier pool).
+        struct WorkerSlot {
+            const void* pool = nullptr;
+            size_t index = 0;
+        };
+
+    }
+
+    // Pool con robo de trabajo: cada worker tiene su deque de Chase-Lev; lo que encola un
+    // worker va a su propio deque y lo que llega de afuera entra por una cola de inyección.
+    // Un worker sin trabajo prueba su deque, la cola de inyección y luego roba a víctimas al
+    // azar antes de dormirse.
     class ThreadPool {
     private:
-        std::vector<std::thread> workers_;
-        std::queue<std::function<void()>> tasks_;
+        struct Worker {
+            detail::WorkStealingDeque deque;
+            uint32_t rng;
+            std::thread thread;
+        };
+
+        std::vector<std::unique_ptr<Worker>> workers_;
+
+        std::mutex inject_mutex_;
+        std::deque<detail::Job*> inject_;
+
+        // Tareas encoladas y aún no tomadas; un worker solo duerme si es 0, comprobado bajo
+        // sleep_mutex_ después de anotarse en sleeping_ (ver submit).
+        std::atomic<size_t> queued_{0};
+        std::atomic<size_t> sleeping_{0};
+        std::atomic<bool> stop_{false};
+        std::mutex sleep_mutex_;
+        std::condition_variable sleep_cv_;
 
-        std::mutex queue_mutex_;
-        std::condition_variable condition_;
-        bool stop_ = false;
+        static constexpr int SPIN_ROUNDS = 64;
+
+        inline static thread_local detail::WorkerSlot current_;
+
+        Worker* local_worker() const {
+            return current_.pool == this ? workers_[current_.index].get() : nullptr;
+        }
+
+        void submit(detail::Job* job) {
+            // Se cuenta antes de publicar para que quien la tome nunca baje el contador de 0.
+            queued_.fetch_add(1, std::memory_order_seq_cst);
+            if (Worker* w = local_worker()) {
+                w->deque.push(job);
+            } else {
+                std::lock_guard<std::mutex> lock(inject_mutex_);
+                inject_.push_back(job);
+            }
+            if (sleeping_.load(std::memory_order_seq_cst) > 0) {
+                std::lock_guard<std::mutex> lock(sleep_mutex_);
+                sleep_cv_.notify_one();
+            }
+        }
+
+        detail::Job* take_injected() {
+            std::lock_guard<std::mutex> lock(inject_mutex_);
+            if (inject_.empty()) return nullptr;
+            detail::Job* job = inject_.front();
+            inject_.pop_front();
+            return job;
+        }
+
+        detail::Job* steal_from_others(uint32_t& rng, size_t self) {
+            const size_t n = workers_.size();
+            rng ^= rng << 13;
+            rng ^= rng >> 17;
+            rng ^= rng << 5;
+            size_t start = rng % n;
+            for (size_t k = 0; k < n; ++k) {
+                size_t victim = (start + k) % n;
+                if (victim == self) continue;
+                if (detail::Job* job = workers_[victim]->deque.steal()) return job;
+            }
+            return nullptr;
+        }
+
+        // Busca una tarea para el hilo actual: deque propio, cola de inyección y robo.
+        detail::Job* find_job() {
+            Worker* w = local_worker();
+            detail::Job* job = w ? w->deque.pop() : nullptr;
+            if (!job) job = take_injected();
+            if (!job) {
+                thread_local uint32_t external_rng = 0x9E3779B9u;
+                job = w ? steal_from_others(w->rng, current_.index)
+                        : steal_from_others(external_rng, workers_.size());
+            }
+            if (job) queued_.fetch_sub(1, std::memory_order_relaxed);
+            return job;
+        }
+
+        static void execute(detail::Job* job) {
+            job->run();
+            delete job;
+        }
+
+        void worker_loop(size_t index) {
+            current_ = {this, index};
+            while (true) {
+                detail::Job* job = nullptr;
+                for (int spin = 0; spin < SPIN_ROUNDS && !job; ++spin) {
+                    job = find_job();
+                    if (!job && queued_.load(std::memory_order_relaxed) == 0) break;
+                }
+                if (job) {
+                    execute(job);
+                    continue;
+                }
+                std::unique_lock<std::mutex> lock(sleep_mutex_);
+                sleeping_.fetch_add(1, std::memory_order_seq_cst);
+                sleep_cv_.wait(lock, [this] {
+                    return stop_.load() || queued_.load(std::memory_order_seq_cst) > 0;
+                });
+                sleeping_.fetch_sub(1, std::memory_order_relaxed);
+                if (stop_.load() && queued_.load() == 0) return;
+            }
+        }
+
+        // Ayuda a vaciar el pool hasta que done() sea cierto; evita bloquear un worker
+        // esperando tareas que tendría que ejecutar él mismo.
+        template <typename Pred>
+        void help_until(Pred done) {
+            while (!done()) {
+                if (detail::Job* job = find_job()) execute(job);
+                else std::this_thread::yield();
+            }
+        }
 
     public:
         explicit ThreadPool(size_t threads) {
+            if (threads == 0) threads = 1;
+            workers_.reserve(threads);
             for (size_t i = 0; i < threads; ++i) {
-                workers_.emplace_back([this]() {
-                    while (true) {
-                        std::function<void()> task;
-                        {
-                            std::unique_lock<std::mutex> lock(queue_mutex_);
-                            condition_.wait(lock, [this] { return stop_ || !tasks_.empty(); });
-                            if (stop_ && tasks_.empty()) return;
-                            task = std::move(tasks_.front());
-                            tasks_.pop();
-                        }
-                        task();
-                    }
-                });
+                workers_.push_back(std::make_unique<Worker>());
+                workers_.back()->rng = 0x9E3779B9u * uint32_t(i + 1) | 1u;
             }
+            for (size_t i = 0; i < threads; ++i)
+                workers_[i]->thread = std::thread([this, i]() { worker_loop(i); });
         }
 
+        // Termina las tareas pendientes antes de cerrar.
         ~ThreadPool() {
             {
-                std::unique_lock<std::mutex> lock(queue_mutex_);
+                std::lock_guard<std::mutex> lock(sleep_mutex_);
                 stop_ = true;
             }
-            condition_.notify_all();
-            for (auto& t : workers_) t.join();
+            sleep_cv_.notify_all();
+            for (auto& w : workers_) w->thread.join();
         }
 
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        size_t size() const { return workers_.size(); }
+
+        // Índice en [0, size()) del worker que llama, o size() si no es un hilo de este pool.
+        size_t worker_index() const { return current_.pool == this ? current_.index : workers_.size(); }
+
         template<class F, class... Args>
         auto enqueue(F&& f, Args&&... args)
         -> std::future<typename std::invoke_result<F, Args...>::type>
         {
             using return_type = typename std::invoke_result<F, Args...>::type;
 
-            auto task = std::make_shared<std::packaged_task<return_type()>>(
-                    std::bind(std::forward<F>(f), std::forward<Args>(args)...)
-            );
+            std::promise<return_type> promise;
+            std::future<return_type> res = promise.get_future();
+            submit(new detail::Job(
+                    [promise = std::move(promise), fn = std::forward<F>(f),
+                     bound = std::make_tuple(std::forward<Args>(args)...)]() mutable {
+                        try {
+                            if constexpr (std::is_void_v<return_type>) {
+                                std::apply(fn, bound);
+                                promise.set_value();
+                            } else {
+                                promise.set_value(std::apply(fn, bound));
+                            }
+                        } catch (...) {
+                            promise.set_exception(std::current_exception());
+                        }
+                    }));
+            return res;
+        }
+
+        // Fork-join sobre [begin, end) en trozos de grain: f(i0, i1) procesa un trozo. Los
+        // trozos se reparten con un contador atómico entre el hilo que llama y hasta
+        // min(size(), max_helpers) ayudantes; la llamada vuelve cuando todos terminaron y
+        // relanza la primera excepción.
+        template <typename F>
+        void parallel_for(size_t begin, size_t end, size_t grain, F&& f, size_t max_helpers = SIZE_MAX) {
+            if (end <= begin) return;
+            if (grain == 0) grain = 1;
+            const size_t chunks = (end - begin + grain - 1) / grain;
+            if (chunks == 1) {
+                f(begin, end);
+                return;
+            }
 
-            std::future<return_type> res = task->get_future();
-            {
-                std::lock_guard<std::mutex> lock(queue_mutex_);
-                tasks_.emplace([task]() { (*task)(); });
+            struct Shared {
+                std::atomic<size_t> next{0};
+                std::atomic<size_t> finished{0};
+                std::atomic<bool> failed{false};
+                std::exception_ptr error;
+            } shared;
+
+            auto body = [&]() {
+                size_t c;
+                while ((c = shared.next.fetch_add(1, std::memory_order_relaxed)) < chunks) {
+                    size_t i0 = begin + c * grain;
+                    try {
+                        f(i0, std::min(end, i0 + grain));
+                    } catch (...) {
+                        if (!shared.failed.exchange(true)) shared.error = std::current_exception();
+                    }
+                }
+            };
+
+            const size_t helpers = std::min({chunks - 1, workers_.size(), max_helpers});
+            if (helpers == 0) {
+                f(begin, end);
+                return;
             }
-            condition_.notify_one();
-            return res;
+            for (size_t h = 0; h < helpers; ++h)
+                submit(new detail::Job([&shared, &body]() {
+                    body();
+                    shared.finished.fetch_add(1, std::memory_order_release);
+                }));
+            body();
+            help_until([&] { return shared.finished.load(std::memory_order_acquire) == helpers; });
+            if (shared.error) std::rethrow_exception(shared.error);
         }
     };
 
@@ -1,22 +1,48 @@
 #include "utec/agent/PongAgentTrainable.h"
 #include "utec/agent/EnvGym.h"
+#include "utec/agent/ActorLearner.h"
+#include "utec/agent/PolicyQuantization.h"
+#include "utec/metrics/Metrics.h"
+#include "utec/random/Philox.h"
 #include "neural_network.h"
 #include <iostream>
 #include <fstream>
-#include <cstdlib>
+#include <random>
+#include <string>
 
 using namespace utec;
 
-int main() {
+// Uso: Pong_AI [--pipeline [--actores N]] [--exportar-texto] [--int8] [--semilla N]
+// --pipeline entrena con actores en hilos propios y un learner (ActorLearner); sin la opción,
+// actuar y aprender se alternan en un solo hilo. --exportar-texto escribe además pesos.txt.
+// --int8 cuantiza la política entrenada e informa cuánto se aparta de la de punto flotante.
+// Compilado con PONG_PROFILE, al terminar imprime el perfil por capa y lo guarda en
+// perfil.csv y perfil.json. Las métricas de entrenamiento se vuelcan cada segundo a
+// metricas.csv y metricas.jsonl, con un resumen en consola cada 5 s. Todo lo aleatorio (pesos
+// iniciales, entornos, exploración, replay) sale de flujos Philox de una sola semilla: con
+// --semilla N la corrida se repite igual; sin ella se sortea una y se imprime.
+int main(int argc, char** argv) {
     using T = float;
-    srand(time(nullptr));
 
-    // Inicialización aleatoria
-    auto init_random = [](auto& W) {
-        std::default_random_engine gen(std::random_device{}());
-        std::uniform_real_distribution<float> dist(-0.5, 0.5);
-        for (auto& w : W) w = dist(gen);
-    };
+    bool pipeline = false;
+    bool exportar_texto = false;
+    bool int8 = false;
+    size_t actores = 0;
+    uint64_t semilla = std::random_device{}();
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--pipeline") pipeline = true;
+        else if (arg == "--exportar-texto") exportar_texto = true;
+        else if (arg == "--int8") int8 = true;
+        else if (arg == "--actores" && i + 1 < argc) actores = std::stoul(argv[++i]);
+        else if (arg == "--semilla" && i + 1 < argc) semilla = std::stoull(argv[++i]);
+    }
+    random::set_global_seed(semilla);
+    std::cout << "🎲 Semilla: " << semilla << "\n";
+
+    // Inicialización aleatoria: un solo flujo en el orden de las capas, generado por lotes.
+    random::Stream init_rng(random::stream_id(random::Domain::Init, 0));
+    auto init_random = [&](auto& W) { init_rng.uniform(W.data(), W.size(), -0.5f, 0.5f); };
 
     // Red neuronal
     neural_network::NeuralNetwork<T> net;
@@ -26,60 +52,127 @@ int main() {
     net.add_layer(std::make_unique<neural_network::ReLU<T>>());
     net.add_layer(std::make_unique<neural_network::Dense<T>>(8, 1, init_random, init_random));
 
-    if (std::ifstream("pesos.txt").good()) {
-        net.load_model("pesos.txt");
-        std::cout << "📦 Pesos anteriores cargados desde pesos.txt\n";
+    // pesos.bin guarda la topología y lanza si no coincide; pesos.txt queda como respaldo
+    // para modelos guardados con la versión en texto.
+    if (std::ifstream("pesos.bin").good()) {
+        net.load_model("pesos.bin");
+        std::cout << "📦 Pesos anteriores cargados desde pesos.bin\n";
+    } else if (std::ifstream("pesos.txt").good()) {
+        net.import_text("pesos.txt");
+        std::cout << "📦 Pesos anteriores importados desde pesos.txt\n";
     } else {
-        std::cout << "📁 No se encontró pesos.txt, se iniciará desde cero.\n";
+        std::cout << "📁 No se encontró pesos.bin, se iniciará desde cero.\n";
     }
 
+    // Plan de inferencia fusionado para act(): lee los pesos en vivo, así que sigue al
+    // entrenamiento sin recompilar.
+    net.compile();
+
 
     nn::PongAgentTrainable<T> agent(
-            [&](const algebra::Tensor<T,2>& x) {
-                return net.predict(x);
+            [&](const T* x) {
+                return net.score(x);
             },
             net,
             0.95,  // gamma
             0.005  // learning rate
     );
 
-    nn::EnvGym env;
+    // Objetivos TD del replay con una red objetivo que se sincroniza cada 100 minibatches.
+    agent.use_target_network(100);
+
     const int episodios = 3000;
     const int bloque = 100;
-    std::ofstream winrate_csv("winrate.csv");
-    winrate_csv << "Bloque,Winrate\n";
     int victorias_bloque = 0;
+    int episodio = 0;
 
-    for (int episodio = 0; episodio < episodios; ++episodio) {
-        auto s = env.reset();
-
-        int a = (float(rand()) / RAND_MAX < 0.1f) ? rand() % 2 : agent.act(s);
-        float total_reward = 0;
-        bool done = false;
-
-        while (!done) {
-            float r;
-            auto s_next = env.step(a, r, done);
-            int a_next = (float(rand()) / RAND_MAX < 0.1f) ? rand() % 2 : agent.act(s_next);
-            agent.learnOnPolicy(s, a, r, s_next, a_next);
-            s = s_next;
-            a = a_next;
-            total_reward += r;
-        }
+    // El bucle de entrenamiento solo suma en buffers por hilo; la escritura a disco y a
+    // consola corre en el hilo de fondo de Metrics.
+    metrics::MetricsConfig metricas_config;
+    metricas_config.csv_path = "metricas.csv";
+    metricas_config.jsonl_path = "metricas.jsonl";
+    metricas_config.console = &std::cout;
+    metrics::Metrics metricas(metricas_config);
+    auto episodios_metrica = metricas.counter("episodios");
+    auto recompensa = metricas.histogram("recompensa", metrics::linear_bounds(-1, 0.5, 5));
+    // Un evento por bloque: si varios bloques terminan dentro del mismo volcado, todos quedan.
+    auto winrate = metricas.series("winrate");
 
+    auto registrar = [&](float total_reward) {
         if (total_reward > 0) ++victorias_bloque;
-        std::cout << "Episodio " << episodio << " | Recompensa: " << total_reward << "\n";
+        episodios_metrica.add();
+        recompensa.record(total_reward);
 
-        if ((episodio + 1) % bloque == 0) {
-            float winrate = 100.0f * victorias_bloque / bloque;
-            std::cout << "🔥 Winrate: " << winrate << "%\n";
-            winrate_csv << (episodio + 1) << "," << winrate << "\n";
+        if (++episodio % bloque == 0) {
+            winrate.record(100.0 * victorias_bloque / bloque);
             victorias_bloque = 0;
         }
+    };
+
+    if (pipeline) {
+        nn::ActorLearnerConfig config;
+        if (actores > 0) config.actors = actores;
+        std::cout << "🧵 Pipeline actor-learner con " << config.actors << " actores\n";
+        nn::ActorLearner<T> trainer(net, agent, config);
+        trainer.use_metrics(&metricas);
+        trainer.run(episodios, registrar);
+        std::cout << "Pasos del learner: " << trainer.learner_steps()
+                  << " | Publicaciones de pesos: " << trainer.published() << "\n";
+    } else {
+        // Experiencia acumulada: cada transición entra al replay (con prioridades) y el
+        // aprendizaje corre por minibatches en vez de una transición a la vez.
+        nn::ReplayBuffer<T> replay(20000, 3, true);
+        nn::ReplayBuffer<T>::Batch minibatch(64, 3);
+        random::Stream rng_replay(random::stream_id(random::Domain::Replay, 0));
+        random::Stream explorar(random::stream_id(random::Domain::Agent, 0));
+        const int aprender_cada = 4;
+        int pasos = 0;
+        auto pasos_metrica = metricas.counter("pasos");
+        auto perdida = metricas.histogram("pérdida", metrics::exponential_bounds(1e-4, 2.0, 20));
+
+        nn::EnvGym env(0);
+
+        while (episodio < episodios) {
+            auto s = env.reset();
+
+            int a = explorar.uniform() < 0.1f ? int(explorar() % 3) - 1 : agent.act(s);
+            float total_reward = 0;
+            bool done = false;
+
+            while (!done) {
+                float r;
+                auto s_next = env.step(a, r, done);
+                int a_next = explorar.uniform() < 0.1f ? int(explorar() % 3) - 1 : agent.act(s_next);
+                agent.remember(replay, s, a, r, s_next, done);
+                pasos_metrica.add();
+                if (replay.size() >= minibatch.size() && ++pasos % aprender_cada == 0)
+                    perdida.record(agent.learnFromReplay(replay, minibatch, rng_replay));
+                s = s_next;
+                a = a_next;
+                total_reward += r;
+            }
+
+            registrar(total_reward);
+        }
     }
 
-    winrate_csv.close();
-    net.save_model("pesos.txt");
-    std::cout << "✅ Pesos actualizados guardados en pesos.txt\n";
+    if constexpr (neural_network::profiler::enabled) {
+        neural_network::profiler::print(std::cout);
+        neural_network::profiler::write_csv("perfil.csv");
+        neural_network::profiler::write_json("perfil.json");
+    }
+    net.save_model("pesos.bin");
+    std::cout << "✅ Pesos actualizados guardados en pesos.bin\n";
+    if (exportar_texto) {
+        net.export_text("pesos.txt");
+        std::cout << "📝 Copia en texto exportada a pesos.txt\n";
+    }
+
+    if (int8) {
+        auto calibracion = nn::record_states(net, 4096, 1);
+        auto evaluacion = nn::record_states(net, 4096, 2);
+        auto cuantizada = nn::quantize_policy(net, calibracion);
+        nn::compare_policies(net, cuantizada, evaluacion).print(std::cout);
+    }
     return 0;
 }
\ No newline at end of file
@@ -1,12 +1,14 @@
 #include "utec/agent/EnvGym.h"
-#include <cstdlib>
 #include <cmath>
 
 namespace utec::nn {
 
+    EnvGym::EnvGym(uint64_t id, uint64_t seed)
+            : rng_(utec::random::stream_id(utec::random::Domain::Env, id), seed) {}
+
     State EnvGym::reset() {
         paddle_y_ = 0.5f;
-        ball_y_ = static_cast<float>(rand()) / RAND_MAX;
+        ball_y_ = rng_.uniform();
         return {0.5f, ball_y_, paddle_y_};
     }
 
@@ -15,7 +17,7 @@ namespace utec::nn {
         if (paddle_y_ < 0) paddle_y_ = 0;
         if (paddle_y_ > 1) paddle_y_ = 1;
 
-        ball_y_ = static_cast<float>(rand()) / RAND_MAX;
+        ball_y_ = rng_.uniform();
 
         reward = std::fabs(ball_y_ - paddle_y_) < 0.2f ? +1.f : -1.f;
         done = true;
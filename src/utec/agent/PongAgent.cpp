@@ -1,22 +1,54 @@
 #include "utec/agent/PongAgent.h"
+#include <stdexcept>
 
 namespace utec::nn {
 
     template<typename T>
     int PongAgent<T>::act(const State& s) {
-        using Tensor2D = utec::algebra::Tensor<T,2>;
-        Tensor2D input(1, 3);
-        input(0, 0) = s.ball_x;
-        input(0, 1) = s.ball_y;
-        input(0, 2) = s.paddle_y;
+        T val;
+        if (score_fn) {
+            T input[3];
+            encode(s, input);
+            val = score_fn(input);
+        } else {
+            using Tensor2D = utec::algebra::Tensor<T,2>;
+            Tensor2D input(1, 3);
+            encode(s, input.data());
 
-        auto output = forward_fn(input);
+            val = forward_fn(input)(0,0);
+        }
+        return to_action(val);
+    }
+
+    template<typename T>
+    void PongAgent<T>::act_batch(const utec::algebra::Tensor<T,2>& obs, std::vector<int>& actions) {
+        actions.resize(obs.shape()[0]);
+        act_batch(obs.view(), actions.data());
+    }
 
-        T val = output(0,0);
-        if (val > T(0.1)) return +1;
-        if (val < T(-0.1)) return -1;
-        return 0;
+    // Las filas de obs son estados sin normalizar (ball_x, ball_y, paddle_y); cada una pasa por
+    // encode como en act.
+    template<typename T>
+    void PongAgent<T>::act_batch(const utec::algebra::TensorView<const T>& obs, int* actions) {
+        const size_t n = obs.rows();
+        if (score_fn) {
+            T input[3];
+            for (size_t i = 0; i < n; ++i) {
+                encode({float(obs(i, 0)), float(obs(i, 1)), float(obs(i, 2))}, input);
+                actions[i] = to_action(score_fn(input));
+            }
+            return;
+        }
+        if (!forward_fn)
+            throw std::runtime_error("El agente no tiene una función de evaluación por lotes");
+        utec::algebra::Tensor<T,2> input(n, 3);
+        for (size_t i = 0; i < n; ++i)
+            encode({float(obs(i, 0)), float(obs(i, 1)), float(obs(i, 2))}, &input(i, 0));
+        auto output = forward_fn(input);
+        for (size_t i = 0; i < n; ++i)
+            actions[i] = to_action(output(i, 0));
     }
+
     template class PongAgent<float>;
     template class PongAgent<double>;
 
@@ -0,0 +1,96 @@
+#include "utec/agent/VectorEnvGym.h"
+#include <algorithm>
+#include <stdexcept>
+
+namespace utec::nn {
+
+    VectorEnvGym::VectorEnvGym(size_t n)
+            : n_(n), ball_y_(n, 0.5f), paddle_y_(n, 0.5f),
+              first_stream_(utec::random::next_streams(utec::random::Domain::VectorEnv, n)),
+              seed_(utec::random::global_seed()), noise_(4 * n), obs_(n, 3), final_obs_(n, 3) {
+        write_observations(obs_);
+    }
+
+    VectorEnvGym::VectorEnvGym(size_t n, uint64_t id, uint64_t seed)
+            : n_(n), ball_y_(n, 0.5f), paddle_y_(n, 0.5f),
+              first_stream_(utec::random::stream_id(utec::random::Domain::VectorEnv, id << 24)),
+              seed_(seed), noise_(4 * n), obs_(n, 3), final_obs_(n, 3) {
+        if (n > (size_t(1) << 24) || id >= (uint64_t(1) << 23))
+            throw std::runtime_error("Demasiados entornos o id fuera de rango para VectorEnvGym");
+        write_observations(obs_);
+    }
+
+    // Columna de N uniformes del siguiente sorteo; cada cuatro se genera un bloque nuevo.
+    const float* VectorEnvGym::next_noise() {
+        const uint64_t word = draws_ % 4;
+        if (word == 0) utec::random::uniform_streams(first_stream_, n_, draws_ / 4, noise_.data(), seed_);
+        ++draws_;
+        return noise_.data() + word * n_;
+    }
+
+    void VectorEnvGym::write_observations(utec::algebra::Tensor<float, 2>& out) const {
+        float* o = out.data();
+        for (size_t i = 0; i < n_; ++i) {
+            o[3 * i] = 0.5f;
+            o[3 * i + 1] = ball_y_[i];
+            o[3 * i + 2] = paddle_y_[i];
+        }
+    }
+
+    const utec::algebra::Tensor<float, 2>& VectorEnvGym::reset() {
+        const size_t n = n_;
+        float* ball = ball_y_.data();
+        float* paddle = paddle_y_.data();
+        const float* noise = next_noise();
+        for (size_t i = 0; i < n; ++i) {
+            paddle[i] = 0.5f;
+            ball[i] = noise[i];
+        }
+        write_observations(obs_);
+        return obs_;
+    }
+
+    const utec::algebra::Tensor<float, 2>& VectorEnvGym::step(const std::vector<int>& actions,
+                                                              std::vector<float>& rewards,
+                                                              std::vector<uint8_t>& dones) {
+        const size_t n = n_;
+        if (actions.size() != n)
+            throw std::runtime_error("Cantidad de acciones distinta al número de entornos");
+        rewards.resize(n);
+        dones.resize(n);
+
+        float* ball = ball_y_.data();
+        float* paddle = paddle_y_.data();
+        const int* a = actions.data();
+        float* r = rewards.data();
+        uint8_t* d = dones.data();
+
+        // Misma dinámica que EnvGym::step, sin ramas para que el bucle se vectorice.
+        const float* noise = next_noise();
+        for (size_t i = 0; i < n; ++i) {
+            float p = paddle[i] + 0.1f * static_cast<float>(a[i]);
+            p = p < 0.f ? 0.f : p;
+            p = p > 1.f ? 1.f : p;
+            float b = noise[i];
+            float diff = b - p;
+            r[i] = (diff < 0.2f && diff > -0.2f) ? 1.f : -1.f;
+            paddle[i] = p;
+            ball[i] = b;
+        }
+        // Los episodios duran un solo paso, como en EnvGym.
+        std::fill(d, d + n, uint8_t(1));
+        write_observations(final_obs_);
+
+        // Auto-reset de los entornos terminados; se sortea siempre para no romper el bucle.
+        noise = next_noise();
+        for (size_t i = 0; i < n; ++i) {
+            float fresh = noise[i];
+            float keep = d[i] ? 0.f : 1.f;
+            paddle[i] = keep * paddle[i] + (1.f - keep) * 0.5f;
+            ball[i] = keep * ball[i] + (1.f - keep) * fresh;
+        }
+        write_observations(obs_);
+        return obs_;
+    }
+
+}
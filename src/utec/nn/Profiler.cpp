@@ -0,0 +1,49 @@
+#include "utec/nn/nn_profiler.h"
+
+#if defined(PONG_PROFILE)
+
+#include <cstdlib>
+#include <new>
+#if defined(_WIN32)
+#include <malloc.h>
+#endif
+
+// Reemplazo de operator new para que el perfilador cuente los bytes pedidos por cada hilo.
+// Las formas de arreglo y nothrow por defecto delegan en estas.
+
+namespace {
+
+    void* allocate(std::size_t n, std::size_t align) {
+        utec::neural_network::profiler::detail::allocated += n;
+        if (n == 0) n = 1;
+#if defined(_WIN32)
+        void* p = align > alignof(std::max_align_t) ? _aligned_malloc(n, align) : std::malloc(n);
+#else
+        void* p = align > alignof(std::max_align_t) ? std::aligned_alloc(align, (n + align - 1) / align * align)
+                                                    : std::malloc(n);
+#endif
+        if (!p) throw std::bad_alloc();
+        return p;
+    }
+
+    void release(void* p, std::size_t align) noexcept {
+#if defined(_WIN32)
+        if (align > alignof(std::max_align_t)) {
+            _aligned_free(p);
+            return;
+        }
+#endif
+        (void)align;
+        std::free(p);
+    }
+
+}
+
+void* operator new(std::size_t n) { return allocate(n, alignof(std::max_align_t)); }
+void* operator new(std::size_t n, std::align_val_t a) { return allocate(n, std::size_t(a)); }
+void operator delete(void* p) noexcept { release(p, alignof(std::max_align_t)); }
+void operator delete(void* p, std::size_t) noexcept { release(p, alignof(std::max_align_t)); }
+void operator delete(void* p, std::align_val_t a) noexcept { release(p, std::size_t(a)); }
+void operator delete(void* p, std::size_t, std::align_val_t a) noexcept { release(p, std::size_t(a)); }
+
+#endif
@@ -0,0 +1,96 @@
+#include "utec/agent/ActorLearner.h"
+#include "test_util.h"
+#include <iostream>
+
+using namespace utec;
+
+using T = float;
+
+static void armar(neural_network::NeuralNetwork<T>& net) {
+    auto init = [](auto& W) {
+        std::mt19937 gen(3);
+        std::uniform_real_distribution<float> dist(-0.5f, 0.5f);
+        for (auto& w : W) w = dist(gen);
+    };
+    net.add_layer(std::make_unique<neural_network::Dense<T>>(3, 16, init, init));
+    net.add_layer(std::make_unique<neural_network::ReLU<T>>());
+    net.add_layer(std::make_unique<neural_network::Dense<T>>(16, 1, init, init));
+    net.compile();
+}
+
+int main() {
+    // Dos entornos con la misma semilla dan la misma secuencia, independiente de rand().
+    {
+        nn::EnvGym a(42), b(42);
+        srand(1);
+        nn::State sa = a.reset();
+        srand(2);
+        nn::State sb = b.reset();
+        bool iguales = sa.ball_y == sb.ball_y;
+        for (int i = 0; i < 50; ++i) {
+            float ra, rb;
+            bool da, db;
+            sa = a.step(i % 3 - 1, ra, da);
+            sb = b.step(i % 3 - 1, rb, db);
+            iguales = iguales && sa.ball_y == sb.ball_y && sa.paddle_y == sb.paddle_y && ra == rb;
+        }
+        check(iguales, "EnvGym con semilla propia es reproducible");
+    }
+
+    {
+        neural_network::NeuralNetwork<T> net;
+        armar(net);
+        const T antes = net.score(std::array<T,3>{0.5f, 0.3f, 0.5f}.data());
+        nn::PongAgentTrainable<T> learner([&](const T* x) { return net.score(x); }, net, 0.95f, 0.01f);
+
+        nn::ActorLearnerConfig config;
+        config.actors = 3;
+        config.queue_capacity = 256;
+        config.batch_size = 32;
+        config.publish_every = 4;
+        config.seed = 7;
+        nn::ActorLearner<T> trainer(net, learner, config);
+
+        size_t episodios = 0;
+        bool recompensas_validas = true;
+        trainer.run(3000, [&](T r) {
+            ++episodios;
+            recompensas_validas = recompensas_validas && (r == 1.0f || r == -1.0f);
+        });
+
+        check(episodios == 3000, "on_episode se llama una vez por episodio");
+        check(recompensas_validas, "recompensa de episodio de EnvGym");
+        check(trainer.transitions() >= 3000, "el learner recibe todas las transiciones");
+        check(trainer.learner_steps() > 0, "el learner entrena por minibatches");
+        check(trainer.published() == 1 + trainer.learner_steps() / config.publish_every,
+              "publicación cada publish_every pasos");
+        check(net.score(std::array<T,3>{0.5f, 0.3f, 0.5f}.data()) != antes, "el learner actualiza la red");
+
+        // Un segundo run reutiliza la cola y el replay.
+        trainer.run(500);
+        check(trainer.transitions() >= 3500, "segundo run");
+    }
+
+    {
+        neural_network::NeuralNetwork<T> net;
+        armar(net);
+        nn::PongAgentTrainable<T> learner([&](const T* x) { return net.score(x); }, net);
+        nn::ActorLearnerConfig config;
+        config.actors = 2;
+        config.seed = 1;
+        nn::ActorLearner<T> trainer(net, learner, config);
+        bool lanzo = false;
+        size_t vistos = 0;
+        try {
+            trainer.run(1000, [&](T) {
+                if (++vistos == 10) throw std::runtime_error("fallo en on_episode");
+            });
+        } catch (const std::runtime_error&) {
+            lanzo = true;
+        }
+        check(lanzo && vistos == 10, "un error del learner detiene a los actores y se relanza");
+    }
+
+    if (fallos == 0) std::cout << "Todas las pruebas de actor-learner pasaron\n";
+    return fallos == 0 ? 0 : 1;
+}
@@ -9,12 +9,20 @@ int main() {
     using T = float;
 
     neural_network::NeuralNetwork<T> net;
-    net.add_layer(std::make_unique<neural_network::Dense<T>>(3, 6));
+    net.add_layer(std::make_unique<neural_network::Dense<T>>(3, 16));
     net.add_layer(std::make_unique<neural_network::ReLU<T>>());
-    net.add_layer(std::make_unique<neural_network::Dense<T>>(6, 1));
-
-    net.load_model("pesos.txt");
-    std::cout << "Modelo cargado desde pesos.txt\n";
+    net.add_layer(std::make_unique<neural_network::Dense<T>>(16, 8));
+    net.add_layer(std::make_unique<neural_network::ReLU<T>>());
+    net.add_layer(std::make_unique<neural_network::Dense<T>>(8, 1));
+
+    // Misma topología que main.cpp; el plan lee los pesos directo del archivo mapeado.
+    try {
+        net.map_model("pesos.bin");
+    } catch (const std::exception& e) {
+        std::cerr << "No se pudo cargar pesos.bin: " << e.what() << "\n";
+        return 1;
+    }
+    std::cout << "Modelo mapeado desde pesos.bin\n";
 
     nn::PongAgent<T> agent([&](const algebra::Tensor<T,2>& x) {
         return net.predict(x);
@@ -0,0 +1,79 @@
+#include "utec/thread/ConcurrentQueue.h"
+#include "test_util.h"
+#include <iostream>
+#include <memory>
+#include <numeric>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace utec;
+
+int main() {
+    // Un hilo: FIFO, capacidad redondeada a potencia de dos, try_* en cola llena o vacía.
+    thread::ConcurrentQueue<int> q(6);
+    check(q.capacity() == 8 && q.empty(), "capacidad y cola vacía");
+    int v = -1;
+    check(!q.try_pop(v), "try_pop en cola vacía");
+    for (int i = 0; i < 8; ++i) q.try_push(i);
+    check(!q.try_push(99) && q.size_approx() == 8, "try_push en cola llena");
+    bool fifo = true;
+    for (int i = 0; i < 8; ++i) fifo &= q.try_pop(v) && v == i;
+    check(fifo && q.empty(), "orden FIFO");
+
+    // Lotes: entran solo los que caben y salen en orden.
+    std::vector<int> in(12);
+    std::iota(in.begin(), in.end(), 100);
+    q.try_push(1);
+    size_t entraron = q.push_bulk(in.begin(), in.size());
+    std::vector<int> out(16, 0);
+    size_t salieron = q.pop_bulk(out.begin(), out.size());
+    check(entraron == 7 && salieron == 8 && out[0] == 1 && out[1] == 100 && out[7] == 106, "push_bulk/pop_bulk");
+
+    // Tipos que solo se mueven.
+    thread::ConcurrentQueue<std::unique_ptr<std::string>> mq(4);
+    mq.push(std::make_unique<std::string>("hola"));
+    check(mq.try_push(std::make_unique<std::string>("chau")), "push de unique_ptr");
+    auto a = mq.pop();
+    auto b = mq.try_pop();
+    check(a && *a == "hola" && b && *b && **b == "chau", "pop de unique_ptr");
+    mq.push(std::make_unique<std::string>("queda"));   // el destructor libera lo pendiente
+
+    // pop_for vence sin elementos.
+    auto t0 = std::chrono::steady_clock::now();
+    check(!q.pop_for(v, std::chrono::milliseconds(5)) &&
+          std::chrono::steady_clock::now() - t0 >= std::chrono::milliseconds(5), "pop_for con plazo");
+
+    // MPMC bloqueante sobre una cola chica: cada valor sale exactamente una vez.
+    const int productores = 4, consumidores = 4, por_productor = 20000;
+    thread::ConcurrentQueue<int> mpmc(64);
+    std::vector<std::vector<int>> vistos(consumidores);
+    std::vector<std::thread> hilos;
+    for (int p = 0; p < productores; ++p)
+        hilos.emplace_back([&, p] {
+            for (int i = 0; i < por_productor; ++i) mpmc.push(p * por_productor + i);
+        });
+    for (int c = 0; c < consumidores; ++c)
+        hilos.emplace_back([&, c] {
+            int buf[16];
+            size_t objetivo = size_t(productores * por_productor / consumidores);
+            while (vistos[c].size() < objetivo) {
+                if (c % 2 == 0) {
+                    vistos[c].push_back(mpmc.pop());
+                } else {
+                    size_t k = mpmc.pop_bulk(buf, std::min<size_t>(16, objetivo - vistos[c].size()));
+                    vistos[c].insert(vistos[c].end(), buf, buf + k);
+                    if (k == 0) std::this_thread::yield();
+                }
+            }
+        });
+    for (auto& h : hilos) h.join();
+    std::vector<int> cuenta(productores * por_productor, 0);
+    for (auto& vs : vistos)
+        for (int x : vs) ++cuenta[x];
+    check(std::all_of(cuenta.begin(), cuenta.end(), [](int c) { return c == 1; }) && mpmc.empty(),
+          "MPMC sin pérdidas ni duplicados");
+
+    if (fallos == 0) std::cout << "Todas las pruebas de la cola pasaron\n";
+    return fallos == 0 ? 0 : 1;
+}
@@ -0,0 +1,124 @@
+#include "neural_network.h"
+#include "test_util.h"
+#include <cmath>
+#include <iostream>
+#include <random>
+
+using namespace utec;
+
+template <typename T>
+static T max_diff(const algebra::TensorView<const T>& a, const algebra::TensorView<const T>& b) {
+    T d = 0;
+    for (size_t i = 0; i < a.size(); ++i) d = std::max(d, std::fabs(a.data()[i] - b.data()[i]));
+    return d;
+}
+
+template <typename T>
+struct Red {
+    neural_network::NeuralNetwork<T> net;
+    std::vector<neural_network::Dense<T>*> densas;
+
+    explicit Red(unsigned semilla) {
+        std::mt19937 rng(semilla);
+        std::normal_distribution<T> dist(T(0), T(0.3));
+        auto init = [&](auto& W) { for (auto& v : W) v = dist(rng); };
+        size_t dims[] = {5, 40, 24, 3};
+        for (size_t k = 0; k < 3; ++k) {
+            auto d = std::make_unique<neural_network::Dense<T>>(dims[k], dims[k + 1], init, init);
+            densas.push_back(d.get());
+            net.add_layer(std::move(d));
+            if (k < 2) net.add_layer(std::make_unique<neural_network::ReLU<T>>());
+        }
+        net.add_layer(std::make_unique<neural_network::Sigmoid<T>>());
+    }
+};
+
+// K réplicas sobre el mismo lote dan los mismos pesos que el entrenamiento en serie, salvo el
+// orden de las sumas de punto flotante.
+template <typename T, typename Opt, typename Loss>
+static void test_equivalencia(const std::string& nombre, size_t replicas, size_t filas, T tol) {
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<T> dist(T(-1), T(1));
+    algebra::Tensor<T,2> X(filas, 5), Y(filas, 3);
+    for (auto& v : X) v = dist(rng);
+    for (auto& v : Y) v = (dist(rng) + T(1)) / T(2);
+
+    Red<T> serie(3), paralelo(3);
+    paralelo.net.set_data_parallel(replicas);
+    Opt opt_serie(T(0.05)), opt_paralelo(T(0.05));
+
+    T peor_perdida = 0;
+    for (int paso = 0; paso < 20; ++paso) {
+        T a = serie.net.template train_batch<Loss>(X.view(), Y.view(), opt_serie);
+        T b = paralelo.net.template train_batch<Loss>(X.view(), Y.view(), opt_paralelo);
+        peor_perdida = std::max(peor_perdida, std::fabs(a - b));
+    }
+    check(peor_perdida < tol, nombre + ": pérdida");
+
+    T peor = 0;
+    for (size_t k = 0; k < serie.densas.size(); ++k) {
+        peor = std::max(peor, max_diff(serie.densas[k]->weights(), paralelo.densas[k]->weights()));
+        peor = std::max(peor, max_diff(serie.densas[k]->bias(), paralelo.densas[k]->bias()));
+    }
+    check(peor < tol, nombre + ": pesos");
+}
+
+struct SinClon : neural_network::ILayer<float> {
+    algebra::Tensor<float,2> forward(const algebra::Tensor<float,2>& x) override { return x; }
+    algebra::Tensor<float,2> backward(const algebra::Tensor<float,2>& g) override { return g; }
+};
+
+int main() {
+    thread::intra_op::set_threads(4);
+
+    test_equivalencia<double, neural_network::SGD<double>, MSELoss<double>>(
+            "SGD/MSE con 4 réplicas", 4, 64, 1e-12);
+    test_equivalencia<double, neural_network::SGD<double>, MSELoss<double>>(
+            "SGD/MSE con 3 réplicas y tramos desiguales", 3, 50, 1e-10);
+    test_equivalencia<double, neural_network::SGD<double>, BCELoss<double>>(
+            "SGD/BCE con 5 réplicas", 5, 37, 1e-12);
+    test_equivalencia<double, neural_network::SGD<double>, MSELoss<double>>(
+            "más réplicas que filas", 8, 5, 1e-12);
+    test_equivalencia<float, neural_network::SGD<float>, MSELoss<float>>(
+            "float con 4 réplicas", 4, 128, 1e-4f);
+    test_equivalencia<double, neural_network::Adam<double>, MSELoss<double>>(
+            "Adam/MSE con 4 réplicas", 4, 64, 1e-9);
+    test_equivalencia<double, neural_network::Adam<double>, BCELoss<double>>(
+            "Adam/BCE con 3 réplicas", 3, 50, 1e-9);
+
+    // train() reparte cada minibatch barajado; con una sola época y lote completo el orden de
+    // las filas no cambia el gradiente.
+    {
+        std::mt19937 rng(11);
+        std::uniform_real_distribution<double> dist(-1, 1);
+        algebra::Tensor<double,2> X(96, 5), Y(96, 3);
+        for (auto& v : X) v = dist(rng);
+        for (auto& v : Y) v = (dist(rng) + 1) / 2;
+        Red<double> serie(5), paralelo(5);
+        paralelo.net.set_data_parallel(4);
+        serie.net.train(X, Y, 1, 96, 0.1);
+        paralelo.net.train(X, Y, 1, 96, 0.1);
+        check(max_diff(serie.densas[0]->weights(), paralelo.densas[0]->weights()) < 1e-12, "train() en paralelo");
+        paralelo.net.train(X, Y, 3, 16, 0.1);
+        check(paralelo.net.predict(X).shape()[0] == 96, "train() con minibatches");
+    }
+
+    {
+        neural_network::NeuralNetwork<float> net;
+        net.add_layer(std::make_unique<neural_network::Dense<float>>(2, 2));
+        net.add_layer(std::make_unique<SinClon>());
+        net.set_data_parallel(2);
+        algebra::Tensor<float,2> X(4, 2), Y(4, 2);
+        neural_network::SGD<float> sgd(0.1f);
+        bool lanzo = false;
+        try {
+            net.train_batch(X.view(), Y.view(), sgd);
+        } catch (const std::runtime_error&) {
+            lanzo = true;
+        }
+        check(lanzo, "una capa sin clone() no admite réplicas");
+    }
+
+    if (fallos == 0) std::cout << "Todas las pruebas de paralelismo de datos pasaron\n";
+    return fallos == 0 ? 0 : 1;
+}
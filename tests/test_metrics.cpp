@@ -0,0 +1,173 @@
+#include "utec/metrics/Metrics.h"
+#include "test_util.h"
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace utec;
+
+static std::vector<std::string> lineas(const std::string& path) {
+    std::ifstream in(path);
+    std::vector<std::string> out;
+    for (std::string l; std::getline(in, l);) out.push_back(l);
+    return out;
+}
+
+static bool contiene(const std::string& s, const std::string& parte) { return s.find(parte) != std::string::npos; }
+
+int main() {
+    // Sin hilo de fondo (flush_every = 0): los volcados son los explícitos y el del destructor.
+    metrics::MetricsConfig manual;
+    manual.flush_every = std::chrono::milliseconds(0);
+
+    // Contadores desde varios hilos, cada uno en su buffer.
+    {
+        metrics::Metrics m(manual);
+        auto pasos = m.counter("pasos");
+        check(m.counter("pasos").id() == pasos.id(), "el mismo nombre da la misma métrica");
+        std::vector<std::thread> hilos;
+        for (int h = 0; h < 4; ++h)
+            hilos.emplace_back([&] {
+                for (int i = 0; i < 10000; ++i) pasos.add();
+                pasos.add(5);
+            });
+        for (auto& t : hilos) t.join();
+        check(m.totals().counters[pasos.id()] == 4 * 10005, "suma de contadores entre hilos");
+    }
+
+    // Medidores e histogramas.
+    {
+        metrics::Metrics m(manual);
+        auto winrate = m.gauge("winrate");
+        auto otro = m.gauge("sin_asignar");
+        winrate.set(40);
+        winrate.set(42.5);
+        auto t = m.totals();
+        check(t.gauges[winrate.id()] == 42.5 && std::isnan(t.gauges[otro.id()]), "medidor con el último valor");
+
+        auto h = m.histogram("recompensa", {0, 1, 2});
+        for (double v : {-1.0, 0.5, 1.0, 1.5, 3.0, 7.0}) h.record(v);
+        const auto ht = m.totals().histograms[h.id()];
+        check(ht.count == 6 && ht.sum == 12.0 && ht.min == -1.0 && ht.max == 7.0, "conteo, suma, mínimo y máximo");
+        check(ht.buckets == std::vector<uint64_t>({1, 2, 1, 2}), "cubos con límite superior inclusivo");
+
+        bool lanzo = false;
+        try {
+            m.histogram("recompensa", {0, 5});
+        } catch (const std::runtime_error&) {
+            lanzo = true;
+        }
+        check(lanzo, "mismo nombre con otros límites");
+        lanzo = false;
+        try {
+            m.histogram("desordenado", {2, 1});
+        } catch (const std::runtime_error&) {
+            lanzo = true;
+        }
+        check(lanzo, "límites no crecientes");
+        lanzo = false;
+        try {
+            for (size_t i = 0; i <= metrics::Metrics::MAX_COUNTERS; ++i) m.counter("c" + std::to_string(i));
+        } catch (const std::runtime_error&) {
+            lanzo = true;
+        }
+        check(lanzo, "límite de contadores");
+    }
+
+    // CSV y JSON lines por ventana, y consola limitada a un resumen por console_every.
+    {
+        std::ostringstream consola;
+        metrics::MetricsConfig config = manual;
+        config.csv_path = "test_metricas.csv";
+        config.jsonl_path = "test_metricas.jsonl";
+        config.console = &consola;
+        config.console_every = std::chrono::hours(1);
+        {
+            metrics::Metrics m(config);
+            auto episodios = m.counter("episodios");
+            auto perdida = m.histogram("pérdida", metrics::exponential_bounds(0.25, 2, 4));
+            auto winrate = m.gauge("winrate");
+            episodios.add(3);
+            for (double v : {0.1, 0.2, 0.3, 0.4}) perdida.record(v);
+            m.flush();
+            episodios.add(2);
+            winrate.set(50);
+            m.flush();
+            m.flush();
+            check(consola.str().empty(), "la consola respeta console_every");
+        }
+        check(contiene(consola.str(), "episodios 5") && contiene(consola.str(), "winrate 50"),
+              "resumen final en consola");
+
+        auto csv = lineas("test_metricas.csv");
+        check(!csv.empty() && csv[0] == "segundos,metrica,tipo,valor,por_segundo,conteo,media,min,max,p50,p90",
+              "encabezado del CSV");
+        int histogramas = 0, contadores = 0;
+        for (const auto& l : csv) {
+            if (contiene(l, ",histograma,")) {
+                ++histogramas;
+                check(contiene(l, ",4,0.25,0.1,0.4,0.25,0.4"), "fila del histograma: ventana y percentiles");
+            }
+            if (contiene(l, "\"episodios\",contador,")) ++contadores;
+        }
+        check(histogramas == 1, "un histograma sin muestras en la ventana no se escribe");
+        check(contadores == 4, "una fila por contador en cada volcado");
+
+        auto json = lineas("test_metricas.jsonl");
+        check(json.size() == 4, "una línea JSON por volcado");
+        check(json.size() == 4 && contiene(json[3], "\"eventos\": []"), "volcado sin eventos");
+        check(json.size() == 4 && contiene(json[0], "\"episodios\": {\"total\": 3") &&
+              contiene(json[0], "\"pérdida\": {\"conteo\": 4") && contiene(json[1], "\"winrate\": 50") &&
+              contiene(json[1], "\"histogramas\": {}"), "contenido del JSON");
+        std::remove("test_metricas.csv");
+        std::remove("test_metricas.jsonl");
+    }
+
+    // Cada evento de una serie sale en su propia fila, aunque varios caigan en la misma ventana.
+    {
+        metrics::MetricsConfig config = manual;
+        config.csv_path = "test_metricas_eventos.csv";
+        config.jsonl_path = "test_metricas_eventos.jsonl";
+        {
+            metrics::Metrics m(config);
+            auto winrate = m.series("winrate");
+            check(m.series("winrate").id() == winrate.id(), "el mismo nombre da la misma serie");
+            for (double v : {40.0, 45.0, 52.0}) winrate.record(v);
+            m.flush();
+            winrate.record(60.0);
+        }
+        std::vector<std::string> filas;
+        for (const auto& l : lineas("test_metricas_eventos.csv"))
+            if (contiene(l, ",\"winrate\",evento,")) filas.push_back(l);
+        check(filas.size() == 4 && contiene(filas[0], ",40,") && contiene(filas[1], ",45,") &&
+              contiene(filas[2], ",52,") && contiene(filas[3], ",60,"), "una fila por evento, en orden");
+        auto json = lineas("test_metricas_eventos.jsonl");
+        check(json.size() == 2 && contiene(json[0], "\"valor\": 52") && !contiene(json[0], "\"valor\": 60") &&
+              contiene(json[1], "\"valor\": 60"), "eventos en el volcado siguiente a registrarlos");
+        std::remove("test_metricas_eventos.csv");
+        std::remove("test_metricas_eventos.jsonl");
+    }
+
+    // Con el hilo de fondo los volcados llegan solos.
+    {
+        metrics::MetricsConfig config;
+        config.jsonl_path = "test_metricas_fondo.jsonl";
+        config.flush_every = std::chrono::milliseconds(5);
+        {
+            metrics::Metrics m(config);
+            auto c = m.counter("pasos");
+            c.add();
+            std::this_thread::sleep_for(std::chrono::milliseconds(60));
+            check(lineas("test_metricas_fondo.jsonl").size() >= 2, "volcados periódicos");
+        }
+        std::remove("test_metricas_fondo.jsonl");
+    }
+
+    if (fallos == 0) std::cout << "Todas las pruebas de métricas pasaron\n";
+    return fallos == 0 ? 0 : 1;
+}
@@ -0,0 +1,140 @@
+#include "neural_network.h"
+#include "test_util.h"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <random>
+
+using namespace utec;
+
+template <typename T>
+static bool iguales(const algebra::Tensor<T,2>& a, const algebra::Tensor<T,2>& b) {
+    return a.shape() == b.shape() && std::memcmp(a.data(), b.data(), a.size() * sizeof(T)) == 0;
+}
+
+static std::vector<char> leer(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    return std::vector<char>(std::istreambuf_iterator<char>(in), {});
+}
+
+static void escribir(const std::string& path, const std::vector<char>& bytes) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(bytes.data(), std::streamsize(bytes.size()));
+}
+
+int main() {
+    using T = float;
+    const std::string archivo = "test_modelo.bin";
+
+    algebra::Tensor<T,2> X(17, 3);
+    {
+        std::mt19937 rng(5);
+        std::uniform_real_distribution<T> dist(T(-1), T(1));
+        for (auto& v : X) v = dist(rng);
+    }
+
+    neural_network::NeuralNetwork<T> origen;
+    armar(origen, {3, 16, 8, 1}, 1, false, 1);
+    origen.save_model(archivo);
+    auto esperado = origen.predict(X);
+
+    // Ida y vuelta exacta.
+    {
+        neural_network::NeuralNetwork<T> net;
+        armar(net, {3, 16, 8, 1}, 2, false, 1);
+        net.load_model(archivo);
+        check(iguales(net.predict(X), esperado), "save_model/load_model conservan los pesos bit a bit");
+    }
+
+    // Encabezado y alineación de los blobs.
+    {
+        neural_network::model_file::MappedModel m(archivo);
+        check(m.version() == neural_network::model_file::VERSION, "versión");
+        check(m.dtype() == neural_network::model_file::DType::Float32, "tipo de dato");
+        check(m.layers() == 5, "una entrada por capa");
+        check(m.layer(2).in == 16 && m.layer(2).out == 8, "forma de la segunda Dense");
+        bool alineados = true;
+        for (const T* p : m.parameters<T>())
+            alineados = alineados && reinterpret_cast<uintptr_t>(p) % 64 == 0;
+        check(alineados, "blobs alineados a 64 bytes");
+    }
+
+    // Topologías y tipos incompatibles se rechazan en vez de cargar basura.
+    {
+        neural_network::NeuralNetwork<T> chica;
+        armar(chica, {3, 6, 1}, 3, false, 1);
+        check(lanza([&] { chica.load_model(archivo); }), "topología distinta (3-6-1)");
+
+        neural_network::NeuralNetwork<T> sin_relu;
+        sin_relu.add_layer(std::make_unique<neural_network::Dense<T>>(3, 16));
+        sin_relu.add_layer(std::make_unique<neural_network::Dense<T>>(16, 8));
+        sin_relu.add_layer(std::make_unique<neural_network::Dense<T>>(8, 1));
+        check(lanza([&] { sin_relu.load_model(archivo); }), "mismas Dense sin activaciones");
+
+        neural_network::NeuralNetwork<double> doble;
+        armar(doble, {3, 16, 8, 1}, 3, false, 1);
+        check(lanza([&] { doble.load_model(archivo); }), "tipo de dato distinto");
+    }
+
+    // Archivos dañados.
+    {
+        auto bytes = leer(archivo);
+        auto dañado = bytes;
+        dañado[dañado.size() - 70] ^= 0x10;
+        escribir("test_modelo_mal.bin", dañado);
+        neural_network::NeuralNetwork<T> net;
+        armar(net, {3, 16, 8, 1}, 4, false, 1);
+        check(lanza([&] { net.load_model("test_modelo_mal.bin"); }), "checksum detecta un byte cambiado");
+
+        escribir("test_modelo_mal.bin", std::vector<char>(bytes.begin(), bytes.end() - 8));
+        check(lanza([&] { net.load_model("test_modelo_mal.bin"); }), "archivo truncado");
+
+        auto magia = bytes;
+        magia[0] = 'X';
+        escribir("test_modelo_mal.bin", magia);
+        check(lanza([&] { net.load_model("test_modelo_mal.bin"); }), "número mágico");
+
+        check(lanza([&] { net.load_model("no_existe.bin"); }), "archivo inexistente");
+        std::remove("test_modelo_mal.bin");
+    }
+
+    // Inferencia directa sobre el archivo mapeado; entrenar las capas no la cambia.
+    {
+        neural_network::NeuralNetwork<T> net;
+        armar(net, {3, 16, 8, 1}, 6, false, 1);
+        net.map_model(archivo, X.shape()[0]);
+        check(net.mapped(), "map_model");
+        check(iguales(net.predict(X), esperado), "inferencia sobre el modelo mapeado");
+        T x[3] = {0.1f, 0.2f, 0.3f};
+        algebra::Tensor<T,2> fila(1, 3);
+        std::copy(x, x + 3, fila.data());
+        check(net.score(x) == origen.predict(fila)(0, 0), "score sobre el modelo mapeado");
+
+        neural_network::SGD<T> sgd(0.1f);
+        algebra::Tensor<T,2> Y(17, 1);
+        net.train_batch(X.view(), Y.view(), sgd);
+        check(iguales(net.predict(X), esperado), "el plan mapeado no ve el entrenamiento");
+
+        neural_network::NeuralNetwork<T> otro;
+        armar(otro, {3, 16, 8, 1}, 7, false, 1);
+        otro.save_model("test_modelo_otro.bin");
+        net.load_model("test_modelo_otro.bin");
+        check(!net.mapped() && iguales(net.predict(X), otro.predict(X)), "load_model vuelve a los pesos de las capas");
+        std::remove("test_modelo_otro.bin");
+    }
+
+    // Exportación en texto con todos los dígitos significativos.
+    {
+        origen.export_text("test_modelo.txt");
+        neural_network::NeuralNetwork<T> net;
+        armar(net, {3, 16, 8, 1}, 8, false, 1);
+        net.import_text("test_modelo.txt");
+        check(iguales(net.predict(X), esperado), "export_text/import_text sin pérdida");
+        std::remove("test_modelo.txt");
+    }
+
+    std::remove(archivo.c_str());
+    if (fallos == 0) std::cout << "Todas las pruebas del formato de modelo pasaron\n";
+    return fallos == 0 ? 0 : 1;
+}
@@ -0,0 +1,232 @@
+#include "neural_network.h"
+#include "test_util.h"
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <random>
+
+using namespace utec;
+
+// Adam elemento a elemento, con la fórmula del artículo y un estado por tensor.
+struct AdamReferencia {
+    double lr = 0.01, b1 = 0.9, b2 = 0.999, eps = 1e-8;
+    std::vector<double> m, v;
+    int t = 0;
+
+    void update(double* p, const double* g, size_t n) {
+        if (m.empty()) m.assign(n, 0), v.assign(n, 0);
+        ++t;
+        for (size_t i = 0; i < n; ++i) {
+            m[i] = b1 * m[i] + (1 - b1) * g[i];
+            v[i] = b2 * v[i] + (1 - b2) * g[i] * g[i];
+            const double m_hat = m[i] / (1 - std::pow(b1, t));
+            const double v_hat = v[i] / (1 - std::pow(b2, t));
+            p[i] -= lr * m_hat / (std::sqrt(v_hat) + eps);
+        }
+    }
+};
+
+int main() {
+    // Buffer plano: cada tramo alineado a 64 bytes y el relleno en cero.
+    {
+        neural_network::ParameterBuffer<float> buf;
+        size_t a = buf.add(3, 5), b = buf.add(1, 5), c = buf.add(5, 1);
+        check(buf.segments() == 3, "tres tramos");
+        bool alineados = true;
+        for (size_t i : {a, b, c}) {
+            alineados = alineados && reinterpret_cast<uintptr_t>(buf.value(i).data()) % 64 == 0 &&
+                        reinterpret_cast<uintptr_t>(buf.grad(i).data()) % 64 == 0;
+            alineados = alineados && buf.grad(i).data() - buf.grads() == buf.value(i).data() - buf.values();
+        }
+        check(alineados, "tramos alineados y con el mismo offset en valores y gradientes");
+        check(buf.value(2).shape() == std::array<size_t, 2>{5, 1} && buf.size() == 32 + 5, "formas y tamaño");
+    }
+
+    // Las Dense de una red viven en un solo buffer, en orden, y add_layer conserva los pesos.
+    {
+        neural_network::NeuralNetwork<float> net;
+        auto d1 = std::make_unique<neural_network::Dense<float>>(3, 16);
+        auto* p1 = d1.get();
+        net.add_layer(std::move(d1));
+        net.add_layer(std::make_unique<neural_network::ReLU<float>>());
+        auto d2 = std::make_unique<neural_network::Dense<float>>(16, 1, [](auto& W) { W.fill(0.25f); },
+                                                                  [](auto& b) { b.fill(-1.0f); });
+        auto* p2 = d2.get();
+        net.add_layer(std::move(d2));
+        const auto& buf = net.parameter_buffer();
+        const float* base = buf.values();
+        auto dentro = [&](const float* p) { return p >= base && p < base + buf.size(); };
+        check(dentro(p1->weights().data()) && dentro(p1->bias().data()) && dentro(p2->weights().data()) &&
+              dentro(p2->bias().data()), "los parámetros de las Dense están en el buffer de la red");
+        check(p1->weights().data() < p1->bias().data() && p1->bias().data() < p2->weights().data(),
+              "orden de capas y de parámetros");
+        check(p1->weights()(2, 15) == 0.1f && p2->weights()(7, 0) == 0.25f && p2->bias()(0, 0) == -1.0f,
+              "los valores sobreviven al empaquetado");
+
+        algebra::Tensor<float,2> X(8, 3), Y(8, 1);
+        X.fill(0.5f);
+        Y.fill(1.0f);
+        neural_network::Adam<float> adam(0.01f);
+        for (int paso = 0; paso < 4; ++paso) net.train_batch(X.view(), Y.view(), adam);
+        check(adam.steps(buf) == 4, "un solo paso de Adam por train_batch");
+        bool relleno = true;
+        for (const float* q = p1->weights().data() + 48; q < p1->bias().data(); ++q) relleno = relleno && *q == 0;
+        for (const float* q = p2->bias().data() + 1; q < base + buf.size(); ++q) relleno = relleno && *q == 0;
+        check(relleno, "el relleno entre tramos queda en cero");
+    }
+
+    // Adam fusionado sobre la red = Adam de referencia por tensor, con estado propio para W y b.
+    {
+        std::mt19937 rng(5);
+        std::normal_distribution<double> dist(0, 0.5);
+        auto init = [&](auto& W) { for (auto& v : W) v = dist(rng); };
+        neural_network::NeuralNetwork<double> net;
+        auto d = std::make_unique<neural_network::Dense<double>>(4, 3, init, init);
+        auto* densa = d.get();
+        net.add_layer(std::move(d));
+        algebra::Tensor<double,2> X(16, 4), Y(16, 3);
+        for (auto& v : X) v = dist(rng);
+        for (auto& v : Y) v = dist(rng);
+
+        algebra::Tensor<double,2> W(densa->weights()), b(densa->bias());
+        AdamReferencia ref_W, ref_b;
+        neural_network::Adam<double> adam(0.01);
+        double peor = 0;
+        for (int paso = 0; paso < 5; ++paso) {
+            // Gradiente de la referencia con los mismos pesos: el de la red antes de su paso.
+            algebra::Tensor<double,2> pred(net.forward_batch(X.view()));
+            MSELoss<double> loss(pred, Y);
+            const auto grad = loss.loss_gradient();
+            net.backward_batch(grad.view());
+            std::vector<neural_network::ParamRef<double>> params;
+            net.parameters(params);
+            algebra::Tensor<double,2> dW(params[0].grad), db(params[1].grad);
+            net.update(adam);
+            ref_W.update(W.data(), dW.data(), W.size());
+            ref_b.update(b.data(), db.data(), b.size());
+            for (size_t i = 0; i < W.size(); ++i) peor = std::max(peor, std::fabs(W.data()[i] - densa->weights().data()[i]));
+            for (size_t i = 0; i < b.size(); ++i) peor = std::max(peor, std::fabs(b.data()[i] - densa->bias().data()[i]));
+        }
+        check(peor < 1e-12, "Adam fusionado coincide con la referencia (" + std::to_string(peor) + ")");
+    }
+
+    // Con tensores el estado lo guarda quien llama: dos tensores de distinto tamaño con el mismo Adam.
+    {
+        algebra::Tensor<double,2> p1(2, 3), g1(2, 3), p2(1, 7), g2(1, 7);
+        p1.fill(1);
+        g1.fill(0.5);
+        p2.fill(-1);
+        g2.fill(-0.25);
+        algebra::Tensor<double,2> r1 = p1, r2 = p2;
+        AdamReferencia a1, a2;
+        neural_network::Adam<double> adam(0.01);
+        neural_network::Adam<double>::State s1, s2;
+        for (int paso = 0; paso < 3; ++paso) {
+            adam.update(p1, g1, s1);
+            adam.update(p2, g2, s2);
+            a1.update(r1.data(), g1.data(), r1.size());
+            a2.update(r2.data(), g2.data(), r2.size());
+        }
+        double peor = 0;
+        for (size_t i = 0; i < p1.size(); ++i) peor = std::max(peor, std::fabs(p1.data()[i] - r1.data()[i]));
+        for (size_t i = 0; i < p2.size(); ++i) peor = std::max(peor, std::fabs(p2.data()[i] - r2.data()[i]));
+        check(peor < 1e-12 && adam.steps(s1) == 3 && adam.steps(s2) == 3, "estado de Adam por tensor");
+        check(lanza([&] { adam.update(p1, g1); }), "Adam sin estado lanza");
+    }
+
+    // Memoria liberada y reutilizada: un vector nuevo (que el asignador suele poner en la misma
+    // dirección) con un estado nuevo no hereda los momentos del anterior.
+    {
+        neural_network::Adam<double> adam(0.01);
+        bool desde_cero = true;
+        for (int ronda = 0; ronda < 4; ++ronda) {
+            std::vector<double> p(16, 0.0), g(16, 0.5), ref(16, 0.0);
+            neural_network::Adam<double>::State s;
+            AdamReferencia a;
+            desde_cero = desde_cero && adam.steps(s) == 0;
+            for (int paso = 0; paso < 2; ++paso) {
+                adam.update(p.data(), g.data(), p.size(), s);
+                a.update(ref.data(), g.data(), ref.size());
+            }
+            for (size_t i = 0; i < p.size(); ++i) desde_cero = desde_cero && std::fabs(p[i] - ref[i]) < 1e-12;
+        }
+        check(desde_cero, "memoria reutilizada empieza sin estado de Adam");
+    }
+
+    // Con un ParameterBuffer el estado vive en el buffer: uno nuevo del mismo tamaño (que el
+    // asignador suele poner en la misma dirección) no hereda los momentos del anterior.
+    {
+        neural_network::Adam<double> adam(0.01);
+        bool desde_cero = true;
+        for (int ronda = 0; ronda < 4; ++ronda) {
+            neural_network::ParameterBuffer<double> buf;
+            buf.add(2, 8);
+            std::fill(buf.grads(), buf.grads() + buf.size(), 0.5);
+            std::vector<double> ref(buf.size(), 0.0);
+            AdamReferencia a;
+            desde_cero = desde_cero && adam.steps(buf) == 0;
+            for (int paso = 0; paso < 2; ++paso) {
+                adam.update(buf);
+                a.update(ref.data(), buf.grads(), ref.size());
+            }
+            for (size_t i = 0; i < buf.size(); ++i) desde_cero = desde_cero && std::fabs(buf.values()[i] - ref[i]) < 1e-12;
+        }
+        check(desde_cero, "buffer nuevo empieza sin estado de Adam");
+
+        neural_network::NeuralNetwork<double> net;
+        net.add_layer(std::make_unique<neural_network::Dense<double>>(3, 4));
+        algebra::Tensor<double,2> X(2, 3), dY(2, 4);
+        X.fill(1);
+        dY.fill(1);
+        for (int paso = 0; paso < 3; ++paso) {
+            net.forward_batch(X.view());
+            net.backward_batch(dY.view());
+            net.update(adam);
+        }
+        neural_network::Adam<double> otro(0.01);
+        check(adam.steps(net.parameter_buffer()) == 3 && otro.steps(net.parameter_buffer()) == 0,
+              "pasos de Adam en el buffer de la red");
+        net.add_layer(std::make_unique<neural_network::ReLU<double>>());
+        net.add_layer(std::make_unique<neural_network::Dense<double>>(4, 2));
+        check(adam.steps(net.parameter_buffer()) == 0, "add_layer reempaqueta sin estado viejo");
+    }
+
+    // La ruta SIMD y la escalar dan los mismos bits, con cualquier cola.
+    {
+        std::mt19937 rng(9);
+        std::normal_distribution<float> dist(0, 1);
+        const size_t n = 45;
+        std::vector<float> g(n), p(n), m(n), v(n);
+        for (size_t i = 0; i < n; ++i) {
+            g[i] = dist(rng);
+            p[i] = dist(rng);
+            m[i] = 0.1f * dist(rng);
+            v[i] = std::fabs(dist(rng));
+        }
+        auto p2 = p, m2 = m, v2 = v;
+        neural_network::detail::AdamStep<float> c{0.9f, 0.999f, 0.1f, 0.001f, 0.003f, 1e-8f};
+        neural_network::detail::adam(p.data(), g.data(), m.data(), v.data(), n, c);
+        neural_network::detail::adam_scalar(p2.data(), g.data(), m2.data(), v2.data(), n, c);
+        check(p == p2 && m == m2 && v == v2, "Adam SIMD = escalar");
+        auto q = p, q2 = p;
+        neural_network::detail::sgd(q.data(), g.data(), n, 0.01f);
+        neural_network::detail::sgd_scalar(q2.data(), g.data(), n, 0.01f);
+        check(q == q2, "SGD SIMD = escalar");
+    }
+
+    // Una Dense suelta se actualiza de una pasada sobre su propio buffer.
+    {
+        neural_network::Dense<float> suelta(3, 2);
+        algebra::Tensor<float,2> X(4, 3), dY(4, 2);
+        X.fill(1);
+        dY.fill(1);
+        suelta.forward(X);
+        suelta.backward(dY);
+        neural_network::SGD<float> sgd(0.5f);
+        suelta.update_params(sgd);
+        check(suelta.weights()(0, 0) == 0.1f - 0.5f * 4 && suelta.bias()(0, 1) == -0.5f * 4, "Dense suelta");
+    }
+
+    if (fallos == 0) std::cout << "Todas las pruebas del optimizador pasaron\n";
+    return fallos == 0 ? 0 : 1;
+}
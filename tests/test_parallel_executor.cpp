@@ -0,0 +1,83 @@
+#include "utec/thread/ParallelExecutor.h"
+#include "test_util.h"
+#include <atomic>
+#include <iostream>
+
+using namespace utec;
+
+static nn::State estado(int i) {
+    return {50.f, float(i * 37 % 100), float(i * 11 % 100)};
+}
+
+// La red recibe el estado normalizado por encode.
+static int esperada(int i) {
+    float x[3];
+    nn::PongAgent<float>::encode(estado(i), x);
+    float v = x[1] - x[2];
+    return v > 0.1f ? 1 : (v < -0.1f ? -1 : 0);
+}
+
+int main() {
+    std::atomic<int> llamadas{0};
+    nn::PongAgent<float> agente([&](const algebra::Tensor<float,2>& x) {
+        ++llamadas;
+        algebra::Tensor<float,2> out(x.shape()[0], 1);
+        for (size_t i = 0; i < x.shape()[0]; ++i) out(i, 0) = x(i, 1) - x(i, 2);
+        return out;
+    });
+
+    const int hilos = 4, por_hilo = 500;
+
+    // Varios productores a la vez: cada futuro recibe la acción de su propio estado y el
+    // despachador agrupa en lotes de a lo sumo max_batch.
+    {
+        thread::ParallelExecutor<float> exec(agente, {32, std::chrono::microseconds(500)});
+        std::atomic<int> errores{0};
+        std::vector<std::thread> clientes;
+        for (int h = 0; h < hilos; ++h)
+            clientes.emplace_back([&, h] {
+                std::vector<std::future<int>> futuros;
+                for (int i = 0; i < por_hilo; ++i) futuros.push_back(exec.infer_async(estado(h * por_hilo + i)));
+                for (int i = 0; i < por_hilo; ++i)
+                    if (futuros[i].get() != esperada(h * por_hilo + i)) ++errores;
+            });
+        for (auto& c : clientes) c.join();
+
+        auto st = exec.stats();
+        check(errores == 0, "acciones por lotes correctas");
+        check(st.requests == size_t(hilos * por_hilo), "todas las solicitudes contadas");
+        check(st.batches == size_t(llamadas.load()) && st.batches < st.requests,
+              "un forward por lote (" + std::to_string(st.batches) + " lotes)");
+        check(st.mean_batch <= 32.0 && st.p50_us <= st.p99_us && st.throughput > 0, "estadísticas coherentes");
+    }
+
+    // Una solicitud sola se despacha al vencer el plazo.
+    {
+        thread::ParallelExecutor<float> exec(agente, {64, std::chrono::microseconds(1000)});
+        auto f = exec.infer_async(estado(3));
+        check(f.wait_for(std::chrono::seconds(2)) == std::future_status::ready && f.get() == esperada(3),
+              "lote incompleto se despacha por tiempo");
+    }
+
+    // Lo pendiente se despacha al destruir el ejecutor.
+    std::future<int> tardio;
+    {
+        thread::ParallelExecutor<float> exec(agente, {64, std::chrono::seconds(10)});
+        tardio = exec.infer_async(estado(5));
+    }
+    check(tardio.wait_for(std::chrono::seconds(0)) == std::future_status::ready && tardio.get() == esperada(5),
+          "destructor vacía la cola");
+
+    // Modo por solicitud.
+    {
+        thread::ParallelExecutor<float> exec(2, agente);
+        std::vector<std::future<int>> futuros;
+        for (int i = 0; i < 100; ++i) futuros.push_back(exec.infer_async(estado(i)));
+        bool ok = true;
+        for (int i = 0; i < 100; ++i) ok &= futuros[i].get() == esperada(i);
+        check(ok && exec.stats().requests == 100, "modo por solicitud");
+    }
+
+    if (fallos == 0) std::cout << "Todas las pruebas del ejecutor pasaron\n";
+    return fallos == 0 ? 0 : 1;
+}
@@ -0,0 +1,118 @@
+#include "neural_network.h"
+#include "test_util.h"
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <thread>
+
+using namespace utec;
+namespace profiler = neural_network::profiler;
+
+static const profiler::Stats* buscar(const std::vector<profiler::Entry>& lista, const std::string& nombre) {
+    for (const auto& e : lista)
+        if (e.name == nombre) return &e.stats;
+    return nullptr;
+}
+
+int main() {
+    using T = float;
+    check(profiler::enabled, "TestProfiler se compila con PONG_PROFILE");
+
+    neural_network::NeuralNetwork<T> net;
+    auto init = [](auto& W) { for (auto& w : W) w = 0.1f; };
+    net.add_layer(std::make_unique<neural_network::Dense<T>>(3, 16, init, init));
+    net.add_layer(std::make_unique<neural_network::ReLU<T>>());
+    net.add_layer(std::make_unique<neural_network::Dense<T>>(16, 1, init, init));
+
+    algebra::Tensor<T,2> X(8, 3), Y(8, 1);
+    X.fill(0.5f);
+    Y.fill(1.0f);
+    neural_network::SGD<T> sgd(0.01f);
+
+    profiler::reset();
+    const size_t pasos = 5;
+    for (size_t i = 0; i < pasos; ++i) net.train_batch(X.view(), Y.view(), sgd);
+
+    {
+        auto lista = profiler::entries();
+        const auto* fwd = buscar(lista, "[0] Dense 3x16 forward");
+        const auto* bwd = buscar(lista, "[2] Dense 16x1 backward");
+        const auto* relu = buscar(lista, "[1] ReLU forward");
+        const auto* loss = buscar(lista, "pérdida");
+        const auto* opt = buscar(lista, "optimizador");
+        check(fwd && fwd->calls == pasos, "un forward por paso en la primera Dense");
+        check(fwd && fwd->flops == pasos * (2 * 8 * 3 * 16 + 8 * 16), "FLOPs del forward de Dense");
+        check(fwd && fwd->bytes_moved == pasos * sizeof(T) * (8 * 3 + 3 * 16 + 16 + 8 * 16), "bytes del forward de Dense");
+        check(bwd && bwd->calls == pasos, "backward de la última Dense");
+        check(relu && relu->calls == pasos && relu->flops == pasos * 8 * 16, "forward de ReLU");
+        check(loss && loss->calls == pasos, "tiempo de la pérdida");
+        check(opt && opt->calls == pasos && opt->flops == pasos * 2 * net.parameter_buffer().size(),
+              "una pasada del optimizador por paso sobre el buffer de parámetros");
+        check(buscar(lista, "[0] Dense 3x16 update") == nullptr, "las Dense no se actualizan por separado");
+        bool ordenada = true;
+        for (size_t i = 1; i < lista.size(); ++i) ordenada = ordenada && lista[i - 1].stats.ns >= lista[i].stats.ns;
+        check(ordenada, "entradas ordenadas por tiempo");
+    }
+
+    // Bytes pedidos a operator new dentro del sitio.
+    {
+        profiler::reset();
+        {
+            UTEC_PROFILE_SCOPE("asignación");
+            std::vector<char> v(1 << 20);
+            v[0] = 1;
+        }
+        const auto* s = buscar(profiler::entries(), "asignación");
+        check(s && s->calls == 1 && s->bytes_allocated >= (1u << 20), "bytes asignados");
+    }
+
+    // Varios hilos acumulan en el mismo sitio, incluso si ya terminaron.
+    {
+        profiler::reset();
+        std::vector<std::thread> hilos;
+        for (int h = 0; h < 4; ++h)
+            hilos.emplace_back([] {
+                for (int i = 0; i < 100; ++i) {
+                    UTEC_PROFILE_SCOPE("hilos", profiler::Cost{10, 20});
+                }
+            });
+        for (auto& h : hilos) h.join();
+        const auto* s = buscar(profiler::entries(), "hilos");
+        check(s && s->calls == 400 && s->flops == 4000 && s->bytes_moved == 8000, "suma de varios hilos");
+    }
+
+    // Réplicas en paralelo de datos comparten los sitios de la red.
+    {
+        profiler::reset();
+        net.set_data_parallel(2);
+        net.train_batch(X.view(), Y.view(), sgd);
+        auto lista = profiler::entries();
+        const auto* fwd = buscar(lista, "[0] Dense 3x16 forward");
+        check(fwd && fwd->calls == 2, "un forward por réplica");
+        check(buscar(lista, "all-reduce") != nullptr, "tiempo del all-reduce");
+        net.set_data_parallel(1);
+    }
+
+    // Tabla y volcados.
+    {
+        profiler::reset();
+        net.train_batch(X.view(), Y.view(), sgd);
+        std::ostringstream tabla;
+        profiler::print(tabla);
+        check(tabla.str().find("[2] Dense 16x1 backward") != std::string::npos, "tabla con las capas");
+        check(tabla.str().find("asignación") == std::string::npos, "la tabla omite sitios sin llamadas");
+
+        profiler::write_csv("perfil_test.csv");
+        profiler::write_json("perfil_test.json");
+        std::ifstream csv("perfil_test.csv"), json("perfil_test.json");
+        std::string cabecera, contenido((std::istreambuf_iterator<char>(json)), std::istreambuf_iterator<char>());
+        std::getline(csv, cabecera);
+        check(cabecera == "sitio,llamadas,ns,flops,bytes_movidos,bytes_asignados", "cabecera CSV");
+        check(contenido.front() == '[' && contenido.find("\"sitio\": \"pérdida\"") != std::string::npos, "JSON");
+        std::remove("perfil_test.csv");
+        std::remove("perfil_test.json");
+    }
+
+    if (fallos == 0) std::cout << "Todas las pruebas del perfilador pasaron\n";
+    return fallos == 0 ? 0 : 1;
+}
@@ -0,0 +1,100 @@
+#include "utec/agent/PolicyQuantization.h"
+#include "test_util.h"
+#include <cmath>
+#include <iostream>
+#include <random>
+
+using namespace utec;
+
+int main() {
+    using T = float;
+    namespace quant = neural_network::quant;
+
+    // El kernel SIMD da exactamente el producto entero, con entradas impares y salidas que no
+    // llenan el último bloque.
+    {
+        std::mt19937 rng(1);
+        std::uniform_int_distribution<int> dist(-127, 127);
+        bool ok = true;
+        for (size_t in : {1, 3, 4, 16, 33})
+            for (size_t out : {1, 8, 13, 40}) {
+                std::vector<int8_t> W(in * out);
+                for (auto& v : W) v = int8_t(dist(rng));
+                std::vector<int8_t> w(quant::out_blocks(out) * quant::pairs(in) * quant::OUT_BLOCK * 2, 0);
+                for (size_t i = 0; i < in; ++i)
+                    for (size_t j = 0; j < out; ++j) w[quant::weight_index(i, j, in)] = W[i * out + j];
+                std::vector<int16_t> x(in + 1, 0);
+                for (size_t i = 0; i < in; ++i) x[i] = int16_t(i % 5 == 0 ? -127 : dist(rng));
+                std::vector<int32_t> a(quant::out_blocks(out) * quant::OUT_BLOCK), b(a.size());
+                quant::gemv_i8(x.data(), w.data(), in, out, a.data());
+                quant::gemv_i8_scalar(x.data(), w.data(), in, out, b.data());
+                for (size_t j = 0; j < out; ++j) {
+                    int32_t ref = 0;
+                    for (size_t i = 0; i < in; ++i) ref += int32_t(x[i]) * W[i * out + j];
+                    ok = ok && a[j] == ref && b[j] == ref;
+                }
+            }
+        check(ok, "gemv_i8 coincide con el producto entero");
+    }
+
+    // Política 3-16-8-1 calibrada con estados de EnvGym.
+    {
+        neural_network::NeuralNetwork<T> net;
+        armar(net, {3, 16, 8, 1}, 2);
+        auto calibracion = nn::record_states(net, 2048, 3);
+        auto evaluacion = nn::record_states(net, 2048, 4);
+        auto q = nn::quantize_policy(net, calibracion);
+        check(q.input_size() == 3 && q.output_size() == 1, "dimensiones de la red cuantizada");
+
+        auto reporte = nn::compare_policies(net, q, evaluacion);
+        check(reporte.samples == 2048, "muestras evaluadas");
+        check(reporte.agreement() > 0.97, "acciones iguales en más del 97% de los estados");
+        check(reporte.mean_abs_error < 0.01, "error medio del puntaje");
+        check(reporte.int8_bytes < reporte.float_bytes, "pesos más chicos");
+
+        // act_with acepta la red cuantizada como política.
+        nn::State s{50.f, 20.f, 70.f};
+        T x[3];
+        nn::PongAgent<T>::encode(s, x);
+        check(nn::PongAgent<T>::act_with(q, s) == nn::PongAgent<T>::to_action(q.score(x)), "act_with con la red cuantizada");
+    }
+
+    // Varias salidas, sigmoide y capas más anchas.
+    {
+        neural_network::NeuralNetwork<double> net;
+        armar(net, {7, 40, 20, 3}, 5, true);
+        std::mt19937 rng(6);
+        std::normal_distribution<double> dist(0, 1);
+        algebra::Tensor<double,2> X(512, 7);
+        for (auto& v : X) v = dist(rng);
+        auto q = neural_network::QuantizedNetwork<double>::quantize(net, std::as_const(X).view());
+        auto ref = net.predict(X);
+        algebra::Tensor<double,2> Y(512, 3);
+        q.forward_batch(std::as_const(X).view(), Y.view());
+        double peor = 0;
+        for (size_t i = 0; i < 512; ++i)
+            for (size_t j = 0; j < 3; ++j) peor = std::max(peor, std::fabs(Y(i, j) - ref(i, j)));
+        check(peor < 0.02, "error acotado con sigmoide y varias salidas");
+    }
+
+    {
+        struct Propia : neural_network::ILayer<T> {
+            algebra::Tensor<T,2> forward(const algebra::Tensor<T,2>& x) override { return x; }
+            algebra::Tensor<T,2> backward(const algebra::Tensor<T,2>& g) override { return g; }
+        };
+        neural_network::NeuralNetwork<T> net;
+        net.add_layer(std::make_unique<neural_network::Dense<T>>(3, 4));
+        net.add_layer(std::make_unique<Propia>());
+        algebra::Tensor<T,2> X(4, 3);
+        bool lanzo = false;
+        try {
+            neural_network::QuantizedNetwork<T>::quantize(net, std::as_const(X).view());
+        } catch (const std::runtime_error&) {
+            lanzo = true;
+        }
+        check(lanzo, "capas propias no se cuantizan");
+    }
+
+    if (fallos == 0) std::cout << "Todas las pruebas de cuantización pasaron\n";
+    return fallos == 0 ? 0 : 1;
+}
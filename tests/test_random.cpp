@@ -0,0 +1,150 @@
+#include "utec/random/Philox.h"
+#include "utec/agent/EnvGym.h"
+#include "utec/agent/VectorEnvGym.h"
+#include "test_util.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <numeric>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace utec;
+
+int main() {
+    // Vectores de prueba conocidos de Philox4x32-10 (Random123).
+    check(random::philox4x32({0, 0, 0, 0}, {0, 0}) ==
+          std::array<uint32_t, 4>{0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8}, "KAT contador y clave en cero");
+    check(random::philox4x32({~0u, ~0u, ~0u, ~0u}, {~0u, ~0u}) ==
+          std::array<uint32_t, 4>{0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd}, "KAT todo en uno");
+    check(random::philox4x32({0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344}, {0xa4093822, 0x299f31d0}) ==
+          std::array<uint32_t, 4>{0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1}, "KAT dígitos de pi");
+
+    // Los lotes dan los mismos valores que las llamadas sueltas, también en tamaños que no
+    // llenan una tanda.
+    {
+        random::Stream a(5, 9), b(5, 9);
+        std::vector<float> lote(1003);
+        a.uniform(lote.data(), lote.size());
+        bool iguales = true, rango = true;
+        for (float v : lote) {
+            iguales &= v == b.uniform();
+            rango &= v >= 0.0f && v < 1.0f;
+        }
+        check(iguales, "uniformes por lote iguales a los sueltos");
+        check(rango, "uniformes en [0, 1)");
+
+        random::Stream c(5, 9);
+        c.seek(1003 / 4 + 1);
+        check(a() == c(), "el lote avanza el flujo por bloques completos");
+
+        random::Stream d(5, 9), e(5, 9);
+        std::vector<float> normales(7);
+        d.normal(normales.data(), normales.size(), 1.0f, 2.0f);
+        bool normales_ok = true;
+        for (float v : normales) normales_ok &= std::fabs(v - (1.0f + 2.0f * e.normal())) < 1e-5f;
+        check(normales_ok, "normales por lote iguales a las sueltas");
+    }
+
+    // Flujos distintos no comparten valores; misma semilla e id, misma secuencia.
+    {
+        random::Stream a(random::stream_id(random::Domain::Env, 0), 1), b(random::stream_id(random::Domain::Env, 1), 1);
+        random::Stream c(random::stream_id(random::Domain::Env, 0), 2);
+        int iguales_ab = 0, iguales_ac = 0;
+        for (int i = 0; i < 1000; ++i) {
+            uint32_t va = a(), vb = b(), vc = c();
+            iguales_ab += va == vb;
+            iguales_ac += va == vc;
+        }
+        check(iguales_ab < 3 && iguales_ac < 3, "flujos y semillas distintas son independientes");
+        check(random::next_stream(random::Domain::Env) != random::next_stream(random::Domain::Env),
+              "ids automáticos distintos");
+    }
+
+    // Momentos de las normales por lote.
+    {
+        random::Stream s(11, 3);
+        std::vector<float> z(200000);
+        s.normal(z.data(), z.size());
+        double media = std::accumulate(z.begin(), z.end(), 0.0) / double(z.size());
+        double var = 0;
+        for (float v : z) var += (v - media) * (v - media);
+        var /= double(z.size());
+        check(std::fabs(media) < 0.01 && std::fabs(var - 1.0) < 0.02, "media 0 y varianza 1");
+    }
+
+    // uniform_streams coincide con un Stream de cada id llevado al mismo bloque.
+    {
+        const size_t n = 37;
+        std::vector<float> out(4 * n);
+        random::uniform_streams(100, n, 6, out.data(), 42);
+        bool ok = true;
+        for (size_t i = 0; i < n; ++i) {
+            random::Stream s(100 + i, 42);
+            s.seek(6);
+            for (size_t w = 0; w < 4; ++w) ok &= out[w * n + i] == s.uniform();
+        }
+        check(ok, "uniform_streams igual a los flujos individuales");
+    }
+
+    // La semilla global fija entornos y redes creados después; los hilos no cambian el
+    // resultado porque cada entorno tiene su flujo.
+    {
+        random::set_global_seed(77);
+        auto correr = [](size_t id) {
+            nn::EnvGym env(id);
+            std::vector<float> ys;
+            ys.push_back(env.reset().ball_y);
+            for (int i = 0; i < 100; ++i) {
+                float r;
+                bool done;
+                ys.push_back(env.step(i % 3 - 1, r, done).ball_y);
+            }
+            return ys;
+        };
+        std::vector<std::vector<float>> en_hilos(4);
+        std::vector<std::thread> hilos;
+        for (size_t h = 0; h < 4; ++h) hilos.emplace_back([&, h] { en_hilos[h] = correr(h); });
+        for (auto& t : hilos) t.join();
+        bool iguales = true;
+        for (size_t h = 0; h < 4; ++h) iguales &= en_hilos[h] == correr(h);
+        check(iguales, "entornos reproducibles en hilos con la semilla global");
+
+        random::set_global_seed(78);
+        check(correr(0) != en_hilos[0], "otra semilla global, otra secuencia");
+
+        nn::VectorEnvGym a(16, 3, 5), b(16, 3, 5), c(16, 4, 5);
+        std::vector<int> acciones(16, 0);
+        std::vector<float> r;
+        std::vector<uint8_t> d;
+        a.reset();
+        b.reset();
+        c.reset();
+        bool igual = true, distinto = false;
+        for (int paso = 0; paso < 9; ++paso) {
+            a.step(acciones, r, d);
+            b.step(acciones, r, d);
+            c.step(acciones, r, d);
+            for (size_t i = 0; i < 16; ++i) {
+                igual &= a.observations()(i, 1) == b.observations()(i, 1);
+                distinto |= a.observations()(i, 1) != c.observations()(i, 1);
+            }
+        }
+        check(igual && distinto, "VectorEnvGym depende solo de id y semilla");
+    }
+
+    // Stream sirve como generador de <random> y de std::shuffle.
+    {
+        std::vector<int> v(50), w(50);
+        std::iota(v.begin(), v.end(), 0);
+        std::iota(w.begin(), w.end(), 0);
+        random::Stream a(3, 1), b(3, 1);
+        std::shuffle(v.begin(), v.end(), a);
+        std::shuffle(w.begin(), w.end(), b);
+        check(v == w && !std::is_sorted(v.begin(), v.end()), "std::shuffle reproducible");
+    }
+
+    if (fallos == 0) std::cout << "Todas las pruebas de Philox pasaron\n";
+    return fallos == 0 ? 0 : 1;
+}
@@ -0,0 +1,152 @@
+#include "utec/agent/PongAgentTrainable.h"
+#include "test_util.h"
+#include <cmath>
+#include <iostream>
+
+using namespace utec;
+
+// La transición i guarda s = (i, i+1, i+2), s' = -s, a = i % 3 - 1, r = i, done = i par.
+static void llenar(nn::ReplayBuffer<float>& rb, int desde, int hasta) {
+    for (int i = desde; i < hasta; ++i) {
+        float s[3] = {float(i), float(i + 1), float(i + 2)};
+        float sn[3] = {-s[0], -s[1], -s[2]};
+        rb.push(s, i % 3 - 1, float(i), sn, i % 2 == 0);
+    }
+}
+
+static bool lote_consistente(const nn::ReplayBuffer<float>::Batch& b, int minimo) {
+    bool ok = true;
+    for (size_t k = 0; k < b.size(); ++k) {
+        int i = int(b.rewards[k]);
+        ok &= i >= minimo && b.states(k, 0) == float(i) && b.states(k, 2) == float(i + 2) &&
+              b.next_states(k, 1) == -float(i + 1) && b.actions[k] == i % 3 - 1 &&
+              b.dones[k] == (i % 2 == 0);
+    }
+    return ok;
+}
+
+int main() {
+    std::mt19937 rng(9);
+
+    // Anillo: con 25 inserciones sobre capacidad 16 solo quedan las 16 últimas.
+    nn::ReplayBuffer<float> uniforme(16);
+    llenar(uniforme, 0, 25);
+    check(uniforme.size() == 16, "tamaño acotado por la capacidad");
+    nn::ReplayBuffer<float>::Batch lote(64, 3);
+    uniforme.sample(lote, rng);
+    check(lote_consistente(lote, 9), "muestreo uniforme devuelve transiciones vigentes y completas");
+
+    // Árbol de sumas: la hoja encontrada respeta los prefijos.
+    nn::SumTree<double> arbol(5);
+    const double p[] = {1, 0, 3, 2, 4};
+    for (size_t i = 0; i < 5; ++i) arbol.set(i, p[i]);
+    check(arbol.total() == 10, "total del árbol de sumas");
+    check(arbol.find(0.5) == 0 && arbol.find(1.0) == 2 && arbol.find(3.9) == 2 &&
+          arbol.find(4.0) == 3 && arbol.find(9.99) == 4, "búsqueda por masa acumulada");
+
+    // Prioridades: tras subir el error de una transición, aparece mucho más seguido y con
+    // menor peso de importancia.
+    nn::ReplayBuffer<float> prio(32, 3, true, 1.0f);
+    llenar(prio, 0, 32);
+    nn::ReplayBuffer<float>::Batch todo(32, 3);
+    prio.sample(todo, rng);
+    check(lote_consistente(todo, 0), "muestreo por prioridad devuelve transiciones completas");
+    std::vector<float> td(32, 0.01f);
+    for (size_t k = 0; k < 32; ++k)
+        if (todo.indices[k] == 7) td[k] = 10.f;
+    prio.update_priorities(todo, td.data());
+    size_t veces_7 = 0;
+    float peso_7 = 1, peso_min = 1;
+    for (int r = 0; r < 50; ++r) {
+        prio.sample(todo, rng);
+        for (size_t k = 0; k < 32; ++k) {
+            peso_min = std::min(peso_min, todo.weights[k]);
+            if (todo.indices[k] == 7) {
+                ++veces_7;
+                peso_7 = todo.weights[k];
+            }
+        }
+    }
+    check(veces_7 > 50 * 32 / 4, "prioridad alta se muestrea más (" + std::to_string(veces_7) + ")");
+    check(peso_7 == peso_min && peso_7 < 1, "peso de importancia menor para la prioridad alta");
+
+    // Paso de aprendizaje: con done en todas las transiciones el objetivo es r, y la pérdida
+    // del lote baja al repetir pasos.
+    neural_network::NeuralNetwork<float> net;
+    net.add_layer(std::make_unique<neural_network::Dense<float>>(3, 8));
+    net.add_layer(std::make_unique<neural_network::ReLU<float>>());
+    net.add_layer(std::make_unique<neural_network::Dense<float>>(8, 1));
+    nn::PongAgentTrainable<float> agente([&](const float* x) { return net.score(x); }, net, 0.95f, 0.05f);
+    nn::ReplayBuffer<float> memoria(256, 3, false);
+    for (int i = 0; i < 256; ++i) {
+        nn::State s{float(i % 100), float(i * 7 % 100), 50.f};
+        agente.remember(memoria, s, 0, s.ball_y > 50 ? 1.f : -1.f, s, true);
+    }
+    nn::ReplayBuffer<float>::Batch grande(128, 3);
+    float primera = agente.learnFromReplay(memoria, grande, rng);
+    float ultima = primera;
+    for (int paso = 0; paso < 300; ++paso) ultima = agente.learnFromReplay(memoria, grande, rng);
+    check(ultima < primera, "la pérdida del replay baja (" + std::to_string(primera) + " -> " +
+          std::to_string(ultima) + ")");
+
+    // Paso TD de una transición sobre una red lineal 3 -> 1: un solo paso de SGD con el
+    // gradiente de (Q(s) - (r + gamma Q(s')))^2.
+    {
+        neural_network::NeuralNetwork<float> lineal;
+        auto d = std::make_unique<neural_network::Dense<float>>(3, 1, [](auto& W) { W.fill(0.5f); },
+                                                                [](auto& b) { b.fill(0.1f); });
+        auto* densa = d.get();
+        lineal.add_layer(std::move(d));
+        nn::PongAgentTrainable<float> td([&](const float* x) { return lineal.score(x); }, lineal, 0.9f, 0.1f);
+        nn::State s{20, 40, 60}, s_next{30, 50, 60};
+        const float q = 0.5f * (0.2f + 0.4f + 0.6f) + 0.1f, q_next = 0.5f * (0.3f + 0.5f + 0.6f) + 0.1f;
+        const float error = 1.0f + 0.9f * q_next - q;
+        float devuelto = td.learnOnPolicy(s, 0, 1.0f, s_next, 1);
+        check(std::fabs(devuelto - error) < 1e-6f, "error TD devuelto");
+        bool ok = std::fabs(densa->bias()(0, 0) - (0.1f + 0.1f * 2 * error)) < 1e-6f;
+        const float x[3] = {0.2f, 0.4f, 0.6f};
+        for (size_t i = 0; i < 3; ++i) ok = ok && std::fabs(densa->weights()(i, 0) - (0.5f + 0.1f * 2 * error * x[i])) < 1e-6f;
+        check(ok, "paso TD = un paso de SGD sobre Q(s)");
+
+        algebra::Tensor<float,2> xs(1, 3);
+        xs = {0.2f, 0.4f, 0.6f};
+        const float q2 = lineal.predict(xs)(0, 0);
+        check(std::fabs(td.learnOnPolicy(s, 0, -1.0f, s_next, 0, true) - (-1.0f - q2)) < 1e-6f, "sin bootstrap si done");
+    }
+
+    // Con una salida por acción solo se mueve la columna de a.
+    {
+        neural_network::NeuralNetwork<float> tres;
+        auto d = std::make_unique<neural_network::Dense<float>>(3, 3);
+        auto* densa = d.get();
+        tres.add_layer(std::move(d));
+        nn::PongAgentTrainable<float> td([&](const float* x) { return tres.score(x); }, tres, 0.9f, 0.1f);
+        td.learnOnPolicy({20, 40, 60}, +1, 1.0f, {30, 50, 60}, -1);
+        bool ok = true;
+        for (size_t i = 0; i < 3; ++i)
+            ok = ok && densa->weights()(i, 0) == 0.1f && densa->weights()(i, 1) == 0.1f && densa->weights()(i, 2) != 0.1f;
+        check(ok && densa->bias()(0, 2) != 0, "la acción elige la columna de Q");
+    }
+
+    // Lo mismo desde el replay: todas las transiciones con a = 0 solo mueven la columna 1.
+    {
+        neural_network::NeuralNetwork<float> tres;
+        auto d = std::make_unique<neural_network::Dense<float>>(3, 3);
+        auto* densa = d.get();
+        tres.add_layer(std::move(d));
+        nn::PongAgentTrainable<float> td([&](const float* x) { return tres.score(x); }, tres, 0.9f, 0.1f);
+        nn::ReplayBuffer<float> replay(16, 3, false);
+        for (int i = 0; i < 16; ++i)
+            td.remember(replay, {float(i), 50, 50}, 0, 1.0f, {float(i + 1), 50, 50}, i % 2 == 0);
+        nn::ReplayBuffer<float>::Batch lote(8, 3);
+        td.learnFromReplay(replay, lote, rng);
+        bool ok = true;
+        for (size_t i = 0; i < 3; ++i)
+            ok = ok && densa->weights()(i, 0) == 0.1f && densa->weights()(i, 2) == 0.1f && densa->weights()(i, 1) != 0.1f;
+        check(ok && densa->bias()(0, 0) == 0 && densa->bias()(0, 2) == 0 && densa->bias()(0, 1) != 0,
+              "el replay actualiza solo la columna de la acción muestreada");
+    }
+
+    if (fallos == 0) std::cout << "Todas las pruebas de replay pasaron\n";
+    return fallos == 0 ? 0 : 1;
+}
@@ -0,0 +1,207 @@
+#include "utec/agent/PongAgentTrainable.h"
+#include "utec/thread/ParallelExecutor.h"
+#include "nn_snapshot.h"
+#include "test_util.h"
+#include <atomic>
+#include <cmath>
+#include <iostream>
+#include <thread>
+
+using namespace utec;
+using T = float;
+using Store = neural_network::SnapshotStore<T>;
+
+static void armar(neural_network::NeuralNetwork<T>& net) {
+    std::mt19937 gen(5);
+    std::uniform_real_distribution<float> dist(-0.5f, 0.5f);
+    auto init = [&](auto& W) { for (auto& w : W) w = dist(gen); };
+    net.add_layer(std::make_unique<neural_network::Dense<T>>(3, 16, init, init));
+    net.add_layer(std::make_unique<neural_network::ReLU<T>>());
+    net.add_layer(std::make_unique<neural_network::Dense<T>>(16, 1, init, init));
+    net.compile();
+}
+
+static void entrenar(neural_network::NeuralNetwork<T>& net, neural_network::SGD<T>& sgd, int pasos) {
+    algebra::Tensor<T,2> X(8, 3), Y(8, 1);
+    for (size_t i = 0; i < 8; ++i) {
+        X(i, 0) = T(i) / 8;
+        X(i, 1) = 0.5f;
+        X(i, 2) = 1 - T(i) / 8;
+        Y(i, 0) = T(i % 3) - 1;
+    }
+    for (int k = 0; k < pasos; ++k) net.train_batch(X.view(), Y.view(), sgd);
+}
+
+struct SinClon : neural_network::ILayer<T> {
+    algebra::Tensor<T,2> forward(const algebra::Tensor<T,2>& x) override { return x; }
+    algebra::Tensor<T,2> backward(const algebra::Tensor<T,2>& g) override { return g; }
+};
+
+int main() {
+    const T x[3] = {0.3f, 0.6f, 0.2f};
+    neural_network::SGD<T> sgd(0.05f);
+
+    // Un lector ve la versión publicada, no la red en vivo.
+    {
+        neural_network::NeuralNetwork<T> net;
+        armar(net);
+        Store store(net);
+        Store::Reader lector(store);
+        const T v1 = net.score(x);
+        check(store.version() == 1 && lector.score(x) == v1 && lector.version() == 1, "versión inicial");
+
+        entrenar(net, sgd, 5);
+        check(net.score(x) != v1 && lector.score(x) == v1, "entrenar sin publicar no cambia al lector");
+
+        check(store.publish() == 2, "publicar incrementa la versión");
+        check(lector.score(x) == net.score(x) && lector.version() == 2, "el lector toma la versión nueva");
+
+        // Sin lectores fijando una instantánea las retiradas se reciclan y se reutilizan.
+        for (int i = 0; i < 10; ++i) store.publish();
+        check(store.pending() == 0, "recolección sin lectores activos");
+    }
+
+    // Lectores concurrentes con un escritor que entrena y publica: cada lectura corresponde a
+    // una versión completa y las versiones vistas por cada lector no retroceden.
+    {
+        neural_network::NeuralNetwork<T> net;
+        armar(net);
+        Store store(net);
+        const int versiones = 200;
+        std::vector<T> esperado(versiones + 2);
+        esperado[1] = net.score(x);
+
+        std::atomic<bool> listo{false};
+        std::atomic<int> errores{0}, lecturas{0};
+        std::vector<std::thread> lectores;
+        for (int h = 0; h < 3; ++h)
+            lectores.emplace_back([&] {
+                Store::Reader lector(store);
+                uint64_t previa = 0;
+                std::vector<std::pair<uint64_t, T>> vistas;
+                while (!listo.load()) {
+                    T v = lector.score(x);
+                    if (lector.version() < previa) ++errores;
+                    previa = lector.version();
+                    vistas.push_back({previa, v});
+                    ++lecturas;
+                }
+                // esperado[] queda completo cuando listo es true.
+                for (const auto& [ver, v] : vistas)
+                    if (v != esperado[ver]) ++errores;
+            });
+
+        for (int i = 0; i < versiones; ++i) {
+            entrenar(net, sgd, 1);
+            const T v = net.score(x);
+            esperado[store.version() + 1] = v;
+            store.publish();
+        }
+        while (lecturas.load() < 1000) std::this_thread::yield();
+        listo.store(true);
+        for (auto& t : lectores) t.join();
+        check(errores == 0, "lecturas consistentes con su versión");
+        check(store.version() == versiones + 1 && store.pending() == 0, "todo lo retirado se recicla");
+    }
+
+    // La red objetivo queda congelada hasta sync().
+    {
+        neural_network::NeuralNetwork<T> net;
+        armar(net);
+        neural_network::TargetNetwork<T> objetivo(net);
+        const T v0 = net.score(x);
+        entrenar(net, sgd, 5);
+        check(objetivo.score(x) == v0, "red objetivo congelada");
+        objetivo.sync(net);
+        check(objetivo.score(x) == net.score(x) && objetivo.version() == 1, "sync copia los pesos");
+    }
+
+    // learnFromReplay sincroniza la red objetivo cada N pasos.
+    {
+        neural_network::NeuralNetwork<T> net;
+        armar(net);
+        nn::PongAgentTrainable<T> agente([&](const T* s) { return net.score(s); }, net, 0.9f, 0.01f);
+        agente.use_target_network(3);
+        nn::ReplayBuffer<T> replay(64);
+        nn::ReplayBuffer<T>::Batch lote(16, 3);
+        std::mt19937 rng(1);
+        for (int i = 0; i < 32; ++i) {
+            T s[3] = {T(i) / 32, 0.5f, 0.5f}, sn[3] = {T(i + 1) / 32, 0.5f, 0.5f};
+            replay.push(s, i % 3 - 1, T(i % 2), sn, false);
+        }
+        for (int i = 0; i < 2; ++i) agente.learnFromReplay(replay, lote, rng);
+        check(agente.target_network()->version() == 0 && agente.target_network()->score(x) != net.score(x),
+              "la red objetivo no sigue cada paso");
+        agente.learnFromReplay(replay, lote, rng);
+        check(agente.target_network()->version() == 1 && agente.target_network()->score(x) == net.score(x),
+              "sincronización cada 3 pasos");
+        agente.use_target_network(0);
+        check(agente.target_network() == nullptr, "desactivar la red objetivo");
+    }
+
+    // El ejecutor sobre un almacén de instantáneas, en sus dos modos.
+    {
+        neural_network::NeuralNetwork<T> net;
+        armar(net);
+        Store store(net);
+        std::vector<nn::State> estados;
+        for (int i = 0; i < 200; ++i) estados.push_back({float(i % 10) * 10, float(i % 7) * 14, float(i % 5) * 20});
+        // Los lectores ven el estado codificado, como el learner.
+        auto esperada = [&](const nn::State& s) {
+            T in[3];
+            nn::PongAgent<T>::encode(s, in);
+            return nn::PongAgent<T>::to_action(net.score(in));
+        };
+
+        bool ok = true;
+        {
+            thread::ParallelExecutor<T> exec(2, store);
+            std::vector<std::future<int>> futuros;
+            for (const auto& s : estados) futuros.push_back(exec.infer_async(s));
+            for (size_t i = 0; i < estados.size(); ++i) ok &= futuros[i].get() == esperada(estados[i]);
+        }
+        check(ok, "ejecutor por solicitud con lectores");
+
+        ok = true;
+        {
+            thread::ParallelExecutor<T> exec(store, {16, std::chrono::microseconds(200)});
+            std::vector<std::future<int>> futuros;
+            for (const auto& s : estados) futuros.push_back(exec.infer_async(s));
+            for (size_t i = 0; i < estados.size(); ++i) ok &= futuros[i].get() == esperada(estados[i]);
+            check(exec.stats().batches < estados.size(), "el ejecutor agrupa en lotes");
+        }
+        check(ok, "ejecutor por lotes con lectores");
+    }
+
+    // Capas propias y demasiados lectores.
+    {
+        neural_network::NeuralNetwork<T> net;
+        net.add_layer(std::make_unique<neural_network::Dense<T>>(3, 2));
+        net.add_layer(std::make_unique<SinClon>());
+        bool lanzo = false;
+        try {
+            Store store(net);
+        } catch (const std::runtime_error&) {
+            lanzo = true;
+        }
+        check(lanzo, "una capa propia no admite instantáneas");
+
+        neural_network::NeuralNetwork<T> otra;
+        armar(otra);
+        Store store(otra);
+        std::vector<std::unique_ptr<Store::Reader>> lectores;
+        lanzo = false;
+        try {
+            for (size_t i = 0; i <= Store::MAX_READERS; ++i) lectores.push_back(std::make_unique<Store::Reader>(store));
+        } catch (const std::runtime_error&) {
+            lanzo = true;
+        }
+        check(lanzo && lectores.size() == Store::MAX_READERS, "límite de lectores");
+        lectores.pop_back();
+        lectores.push_back(std::make_unique<Store::Reader>(store));
+        check(lectores.size() == Store::MAX_READERS, "un slot liberado se reutiliza");
+    }
+
+    if (fallos == 0) std::cout << "Todas las pruebas de instantáneas de pesos pasaron\n";
+    return fallos == 0 ? 0 : 1;
+}
@@ -0,0 +1,82 @@
+#include "utec/agent/PongAgent.h"
+#include "neural_network.h"
+#include "test_util.h"
+#include <cmath>
+#include <iostream>
+#include <random>
+
+using namespace utec;
+
+template <typename T, typename Static>
+static T max_diff(neural_network::NeuralNetwork<T>& net, const Static& fija, size_t in, size_t out) {
+    std::mt19937 rng(9);
+    std::uniform_real_distribution<T> dist(T(-2), T(2));
+    algebra::Tensor<T,2> X(200, in);
+    for (auto& v : X) v = dist(rng);
+    auto esperado = net.predict(X);
+    T peor = 0;
+    std::vector<T> y(out);
+    for (size_t i = 0; i < 200; ++i) {
+        fija.forward(&X(i, 0), y.data());
+        for (size_t j = 0; j < out; ++j) peor = std::max(peor, std::fabs(y[j] - esperado(i, j)));
+    }
+    return peor;
+}
+
+int main() {
+    using namespace neural_network::fixed;
+
+    {
+        neural_network::NeuralNetwork<float> net;
+        armar(net, {3, 16, 8, 1}, 1);
+        nn::PongPolicy<float> politica;
+        static_assert(nn::PongPolicy<float>::input_size == 3 && nn::PongPolicy<float>::output_size == 1);
+        politica.load_from(net);
+        check(max_diff(net, politica, 3, 1) < 1e-5f, "PongPolicy coincide con NeuralNetwork");
+
+        net.compile();
+        nn::PongAgent<float> agente([&](const float* x) { return net.score(x); });
+        std::mt19937 rng(4);
+        std::uniform_real_distribution<float> dist(0, 1);
+        bool iguales = true;
+        for (int i = 0; i < 1000; ++i) {
+            nn::State s{dist(rng), dist(rng), dist(rng)};
+            iguales = iguales && nn::PongAgent<float>::act_with(politica, s) == agente.act(s);
+        }
+        check(iguales, "act_with decide igual que act");
+    }
+
+    {
+        neural_network::NeuralNetwork<double> net;
+        armar(net, {5, 12, 4}, 2, true);
+        StaticNetwork<double, Dense<5, 12>, ReLU, Dense<12, 4>, Sigmoid> fija;
+        fija.load_from(net);
+        check(max_diff(net, fija, 5, 4) < 1e-12, "varias salidas y sigmoide en double");
+    }
+
+    {
+        neural_network::NeuralNetwork<float> chica;
+        armar(chica, {3, 6, 1}, 3);
+        nn::PongPolicy<float> politica;
+        bool lanzo = false;
+        try {
+            politica.load_from(chica);
+        } catch (const std::runtime_error&) {
+            lanzo = true;
+        }
+        check(lanzo, "topología distinta (3-6-1)");
+
+        neural_network::NeuralNetwork<float> con_sigmoide;
+        armar(con_sigmoide, {3, 16, 8, 1}, 3, true);
+        lanzo = false;
+        try {
+            politica.load_from(con_sigmoide);
+        } catch (const std::runtime_error&) {
+            lanzo = true;
+        }
+        check(lanzo, "activaciones distintas");
+    }
+
+    if (fallos == 0) std::cout << "Todas las pruebas de la red estática pasaron\n";
+    return fallos == 0 ? 0 : 1;
+}
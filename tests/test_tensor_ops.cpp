@@ -0,0 +1,309 @@
+#include "tensor.h"
+#include "nn_dense.h"
+#include "nn_optimizer.h"
+#include "test_util.h"
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <random>
+
+using namespace utec;
+
+template <typename T>
+static void llenar(algebra::Tensor<T,2>& t, std::mt19937& rng) {
+    std::uniform_real_distribution<double> dist(-1.0, 1.0);
+    for (auto& v : t) v = static_cast<T>(dist(rng));
+}
+
+template <typename T>
+static algebra::Tensor<T,2> producto_ingenuo(const algebra::Tensor<T,2>& a, const algebra::Tensor<T,2>& b) {
+    auto [m, k] = a.shape();
+    size_t n = b.shape()[1];
+    algebra::Tensor<T,2> r(m, n);
+    for (size_t i = 0; i < m; ++i)
+        for (size_t j = 0; j < n; ++j) {
+            double acc = 0;
+            for (size_t p = 0; p < k; ++p)
+                acc += double(a(i, p)) * double(b(p, j));
+            r(i, j) = static_cast<T>(acc);
+        }
+    return r;
+}
+
+template <typename T>
+static double error_maximo(const algebra::Tensor<T,2>& a, const algebra::Tensor<T,2>& b) {
+    double err = 0;
+    auto it = b.cbegin();
+    for (auto v : a) err = std::max(err, std::fabs(double(v) - double(*it++)));
+    return err;
+}
+
+template <typename T>
+static void test_matrix_product(const char* tipo, double tol) {
+    std::mt19937 rng(42);
+    // Formas de la red (1x3x16, 16x8, 8x1), bordes de los micro-kernels y bloques KC/MC.
+    const size_t formas[][3] = {
+            {1, 3, 16}, {1, 16, 8}, {1, 8, 1}, {64, 3, 16}, {64, 16, 8},
+            {5, 7, 13}, {6, 16, 16}, {7, 17, 33}, {97, 300, 45}, {200, 260, 130}
+    };
+    for (auto& f : formas) {
+        algebra::Tensor<T,2> a(f[0], f[1]), b(f[1], f[2]);
+        llenar(a, rng);
+        llenar(b, rng);
+        auto c = algebra::matrix_product(a, b);
+        auto ref = producto_ingenuo(a, b);
+        check(c.shape() == ref.shape(), std::string("forma matrix_product ") + tipo);
+        check(error_maximo(c, ref) < tol * double(f[1]),
+              std::string("matrix_product ") + tipo + " " + std::to_string(f[0]) + "x" +
+              std::to_string(f[1]) + "x" + std::to_string(f[2]));
+    }
+}
+
+template <typename T>
+static void test_transpuestas(const char* tipo, double tol) {
+    std::mt19937 rng(3);
+    // (batch, in, out) de Dense::backward más tamaños que pasan por la ruta empaquetada.
+    const size_t formas[][3] = {{1, 3, 16}, {1, 16, 8}, {64, 8, 1}, {7, 17, 33}, {150, 70, 90}};
+    for (auto& f : formas) {
+        algebra::Tensor<T,2> x(f[0], f[1]), g(f[0], f[2]), w(f[1], f[2]);
+        llenar(x, rng);
+        llenar(g, rng);
+        llenar(w, rng);
+
+        auto dW = algebra::matmul_tn(x, g);
+        auto dW_ref = producto_ingenuo(algebra::transpose_2d(x), g);
+        check(dW.shape() == dW_ref.shape() && error_maximo(dW, dW_ref) < tol * double(f[0]),
+              std::string("matmul_tn ") + tipo);
+
+        auto dX = algebra::matmul_nt(g, w);
+        auto dX_ref = producto_ingenuo(g, algebra::transpose_2d(w));
+        check(dX.shape() == dX_ref.shape() && error_maximo(dX, dX_ref) < tol * double(f[2]),
+              std::string("matmul_nt ") + tipo);
+    }
+}
+
+static void test_vistas() {
+    std::mt19937 rng(11);
+    algebra::Tensor<double,2> X(10, 4);
+    llenar(X, rng);
+
+    // operator[] devuelve una vista y asignar a la fila temporal copia los datos.
+    algebra::Tensor<double,2> batch(3, 4);
+    batch[0] = X[7];
+    batch[2] = X[1];
+    bool filas_ok = true;
+    for (size_t j = 0; j < 4; ++j)
+        filas_ok &= batch(0, j) == X(7, j) && batch(2, j) == X(1, j) && batch(1, j) == 0.0;
+    check(filas_ok, "asignación de filas por vista");
+
+    // Gather de filas: la vista lee a través del índice, gather_rows lo materializa.
+    const size_t idx[] = {9, 0, 4, 4, 2};
+    auto g = X.view().gather_rows(idx, 5);
+    algebra::Tensor<double,2> G(5, 4);
+    algebra::gather_rows(X, idx, 5, G);
+    bool gather_ok = true;
+    for (size_t i = 0; i < 5; ++i)
+        for (size_t j = 0; j < 4; ++j)
+            gather_ok &= g(i, j) == X(idx[i], j) && G(i, j) == X(idx[i], j);
+    check(gather_ok, "gather de filas");
+
+    // Transpuesta: vista, materialización y transpose_2d deben coincidir.
+    algebra::Tensor<double,2> Xt(X.view().transposed());
+    auto Xt2 = algebra::transpose_2d(X);
+    bool t_ok = Xt.shape() == std::array<size_t,2>{4, 10} && error_maximo(Xt, Xt2) == 0.0;
+    for (size_t i = 0; i < 10; ++i)
+        for (size_t j = 0; j < 4; ++j)
+            t_ok &= Xt(j, i) == X(i, j);
+    check(t_ok, "transposición por vista");
+
+    // El GEMM consume las vistas directamente: gather de A, transpuesta de A (gather de
+    // columnas) y corte de filas.
+    algebra::Tensor<double,2> W(4, 3);
+    llenar(W, rng);
+    algebra::Tensor<double,2> out(5, 3);
+    algebra::matrix_product(g, W.view(), out.view());
+    check(error_maximo(out, producto_ingenuo(G, W)) < 1e-14, "GEMM con gather de filas");
+
+    algebra::Tensor<double,2> D(5, 3), dW(4, 3);
+    llenar(D, rng);
+    algebra::matrix_product(g.transposed(), D.view(), dW.view());
+    check(error_maximo(dW, producto_ingenuo(algebra::transpose_2d(G), D)) < 1e-14, "GEMM con gather transpuesto");
+
+    algebra::Tensor<double,2> out2(2, 3);
+    algebra::matrix_product(X.view().slice_rows(3, 2), W.view(), out2.view());
+    algebra::Tensor<double,2> X32(X.view().slice_rows(3, 2));
+    check(error_maximo(out2, producto_ingenuo(X32, W)) < 1e-14, "GEMM con corte de filas");
+}
+
+template <typename T>
+static void test_epilogo(const char* tipo, double tol) {
+    std::mt19937 rng(5);
+    // El epílogo debe verse una sola vez por elemento, también en la ruta por bloques donde
+    // la reducción en k se parte en varios KC.
+    const size_t formas[][3] = {{1, 3, 16}, {64, 16, 8}, {7, 17, 33}, {97, 300, 45}};
+    for (auto& f : formas) {
+        algebra::Tensor<T,2> a(f[0], f[1]), b(f[1], f[2]), bias(1, f[2]), c(f[0], f[2]);
+        llenar(a, rng);
+        llenar(b, rng);
+        llenar(bias, rng);
+        const T* pb = bias.data();
+        algebra::matrix_product(a.view(), b.view(), c.view(), false,
+                                [pb](T v, size_t j) { return std::max(v + pb[j], T(0)); });
+        auto ref = producto_ingenuo(a, b);
+        for (size_t i = 0; i < f[0]; ++i)
+            for (size_t j = 0; j < f[2]; ++j)
+                ref(i, j) = std::max(ref(i, j) + pb[j], T(0));
+        check(error_maximo(c, ref) < tol * double(f[1]),
+              std::string("epílogo bias+ReLU ") + tipo + " " + std::to_string(f[0]) + "x" +
+              std::to_string(f[1]) + "x" + std::to_string(f[2]));
+    }
+}
+
+template <typename T>
+static bool identicos(const algebra::Tensor<T,2>& a, const algebra::Tensor<T,2>& b) {
+    return a.shape() == b.shape() && std::memcmp(a.data(), b.data(), a.size() * sizeof(T)) == 0;
+}
+
+// Con varios hilos el GEMM, el gradiente del bias y los optimizadores dan exactamente los mismos
+// bits que en serie.
+static void test_determinismo() {
+    std::mt19937 rng(21);
+    algebra::Tensor<float,2> a(517, 300), b(300, 260), w(300, 260);
+    llenar(a, rng);
+    llenar(b, rng);
+    llenar(w, rng);
+    std::vector<size_t> idx(400);
+    for (auto& i : idx) i = rng() % 517;
+
+    auto correr = [&](size_t hilos) {
+        thread::intra_op::set_threads(hilos);
+        algebra::Tensor<float,2> c = algebra::matrix_product(a, b);
+        algebra::Tensor<float,2> g(400, 260);
+        algebra::matrix_product(a.view().gather_rows(idx.data(), idx.size()), b.view(), g.view(), false,
+                                [](float v, size_t j) { return v * 0.5f + float(j); });
+        algebra::Tensor<float,2> tn = algebra::matmul_tn(a, a);
+
+        neural_network::Dense<float> capa(300, 260, [&](auto& W) { W = w; }, [](auto& B) { B.fill(0.1f); });
+        algebra::Tensor<float,2> dx(517, 300);
+        capa.forward_into(a.view(), algebra::Tensor<float,2>(517, 260).view());
+        capa.backward_into(c.view(), dx.view());
+
+        algebra::Tensor<float,2> p1 = w, p2 = w;
+        neural_network::SGD<float> sgd(0.01f);
+        neural_network::Adam<float> adam(0.01f);
+        neural_network::Adam<float>::State estado;
+        for (int paso = 0; paso < 3; ++paso) {
+            sgd.update(p1, b);
+            adam.update(p2, b, estado);
+        }
+        return std::vector<algebra::Tensor<float,2>>{c, g, tn, dx, p1, p2};
+    };
+
+    auto serie = correr(1);
+    auto paralelo = correr(4);
+    thread::intra_op::set_threads(4);
+    const char* nombres[] = {"matrix_product", "GEMM con gather y epílogo", "matmul_tn", "Dense backward",
+                             "SGD", "Adam"};
+    for (size_t i = 0; i < serie.size(); ++i)
+        check(identicos(serie[i], paralelo[i]), std::string("determinismo con 4 hilos: ") + nombres[i]);
+}
+
+static algebra::Tensor<float,2> temporal(size_t filas, size_t cols, float v) {
+    algebra::Tensor<float,2> t(filas, cols);
+    t.fill(v);
+    return t;
+}
+
+static void test_expresiones() {
+    std::mt19937 rng(5);
+    algebra::Tensor<float,2> t(6, 5), u(6, 5), bias(1, 5);
+    llenar(t, rng);
+    llenar(u, rng);
+    llenar(bias, rng);
+    const float a = 1.5f, b = -0.25f, c = 4.0f;
+    // El compilador puede contraer a * x + y en un FMA de un lado y no del otro.
+    auto cerca = [](float x, float y) { return std::fabs(x - y) <= 1e-6f * std::max(1.0f, std::fabs(y)); };
+
+    // Cadena de escalares y formas invertidas, elemento a elemento contra el cálculo directo.
+    algebra::Tensor<float,2> r = (t * a + b) / c;
+    algebra::Tensor<float,2> inv = 2.0f - t * 3 + 1.0f / (u * u + 1);
+    bool ok = r.shape() == t.shape() && inv.shape() == t.shape();
+    for (size_t i = 0; i < 6; ++i)
+        for (size_t j = 0; j < 5; ++j) {
+            ok &= cerca(r(i, j), (t(i, j) * a + b) / c);
+            ok &= cerca(inv(i, j), 2.0f - t(i, j) * 3 + 1.0f / (u(i, j) * u(i, j) + 1));
+        }
+    check(ok, "expresiones con escalares");
+
+    // Difusión de una fila 1 x N a cada lado y mapas unarios y binarios.
+    algebra::Tensor<float,2> z = t * u + bias;
+    algebra::Tensor<float,2> z2 = bias - u;
+    algebra::Tensor<float,2> m = algebra::map(-z, [](float v) { return v > 0 ? v : 0.0f; });
+    algebra::Tensor<float,2> m2 = algebra::map(t, bias, [](float x, float y) { return std::max(x, y); });
+    ok = true;
+    for (size_t i = 0; i < 6; ++i)
+        for (size_t j = 0; j < 5; ++j) {
+            ok &= cerca(z(i, j), t(i, j) * u(i, j) + bias(0, j)) && z2(i, j) == bias(0, j) - u(i, j);
+            ok &= m(i, j) == std::max(-z(i, j), 0.0f) && m2(i, j) == std::max(t(i, j), bias(0, j));
+        }
+    check(ok, "difusión 1 x N y mapas");
+
+    // Asignación en el lugar aunque la expresión lea el destino, y operadores compuestos.
+    algebra::Tensor<float,2> w = t;
+    w = w * 2 + w;
+    w += bias;
+    w /= 2;
+    ok = true;
+    for (size_t i = 0; i < 6; ++i)
+        for (size_t j = 0; j < 5; ++j) ok &= cerca(w(i, j), (t(i, j) * 2 + t(i, j) + bias(0, j)) / 2);
+    check(ok, "asignación con alias y operadores compuestos");
+
+    // Un temporal pasa a ser dueño de su nodo: la expresión guardada no queda colgando.
+    auto e = temporal(2, 3, 2.0f) * temporal(1, 3, 0.5f) + 1;
+    algebra::Tensor<float,2> q = e;
+    ok = q.shape() == std::array<size_t,2>{2, 3};
+    for (float v : q) ok &= v == 2.0f;
+    check(ok && algebra::sum(e) == 12.0f, "temporales dueños de su nodo y suma");
+
+    // Otras formas y rangos.
+    bool lanzo = false;
+    try {
+        algebra::Tensor<float,2> x(3, 5);
+        algebra::Tensor<float,2> mal = t + x;
+    } catch (const std::runtime_error&) {
+        lanzo = true;
+    }
+    lanzo = lanzo && [&] {
+        try {
+            bias += t;
+        } catch (const std::runtime_error&) {
+            return true;
+        }
+        return false;
+    }();
+    check(lanzo, "formas incompatibles lanzan");
+
+    algebra::Tensor<double,3> c3(2, 3, 4);
+    for (size_t k = 0; k < c3.size(); ++k) c3.data()[k] = double(k);
+    algebra::Tensor<double,3> d3 = c3 * c3 - c3;
+    ok = d3.shape() == c3.shape();
+    for (size_t k = 0; k < c3.size(); ++k) ok &= d3.data()[k] == double(k) * double(k) - double(k);
+    check(ok, "expresiones en rango 3");
+}
+
+int main() {
+    // Antes de cualquier operación paralela, para que el pool compartido tenga 3 workers.
+    thread::intra_op::set_threads(4);
+    test_matrix_product<float>("float", 1e-6);
+    test_matrix_product<double>("double", 1e-14);
+    test_transpuestas<float>("float", 1e-6);
+    test_transpuestas<double>("double", 1e-14);
+    test_vistas();
+    test_epilogo<float>("float", 1e-6);
+    test_epilogo<double>("double", 1e-14);
+    test_determinismo();
+    test_expresiones();
+
+    if (fallos == 0) std::cout << "Todas las pruebas de tensor pasaron\n";
+    return fallos == 0 ? 0 : 1;
+}
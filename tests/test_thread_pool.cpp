@@ -0,0 +1,86 @@
+#include "utec/thread/ThreadPool.h"
+#include "test_util.h"
+#include <atomic>
+#include <iostream>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+
+using namespace utec;
+
+int main() {
+    thread::ThreadPool pool(4);
+
+    // enqueue conserva la interfaz con futuros: valores, void, argumentos y excepciones.
+    auto f1 = pool.enqueue([](int a, int b) { return a * b; }, 6, 7);
+    std::atomic<int> efecto{0};
+    auto f2 = pool.enqueue([&] { efecto = 1; });
+    auto f3 = pool.enqueue([]() -> int { throw std::runtime_error("falla"); });
+    auto movil = std::make_unique<int>(5);
+    auto f4 = pool.enqueue([p = std::move(movil)] { return *p + 1; });
+    std::string grande(200, 'x');
+    auto f5 = pool.enqueue([grande, relleno = std::array<char, 256>{}] { return grande.size() + relleno.size(); });
+    f2.get();
+    bool lanzo = false;
+    try { f3.get(); } catch (const std::runtime_error&) { lanzo = true; }
+    check(f1.get() == 42 && efecto == 1 && lanzo && f4.get() == 6 && f5.get() == 456, "enqueue con futuros");
+
+    // Muchos productores externos y tareas que encolan desde dentro del pool (deque propio y robo).
+    std::atomic<long> total{0};
+    {
+        std::vector<std::thread> productores;
+        std::vector<std::future<void>> futuros[3];
+        for (int p = 0; p < 3; ++p)
+            productores.emplace_back([&, p] {
+                for (int i = 0; i < 2000; ++i)
+                    futuros[p].push_back(pool.enqueue([&total, i] { total += i; }));
+            });
+        for (auto& t : productores) t.join();
+        for (auto& fs : futuros)
+            for (auto& f : fs) f.get();
+    }
+    check(total == 3L * (1999L * 2000L / 2), "tareas de productores externos");
+
+    std::atomic<int> hijas{0};
+    auto padre = pool.enqueue([&] {
+        std::vector<std::future<void>> fs;
+        for (int i = 0; i < 500; ++i) fs.push_back(pool.enqueue([&] { ++hijas; }));
+        return fs;
+    });
+    for (auto& f : padre.get()) f.get();
+    check(hijas == 500, "tareas encoladas desde un worker");
+
+    // parallel_for cubre cada índice exactamente una vez, también anidado dentro de workers.
+    std::vector<int> visitas(10007, 0);
+    pool.parallel_for(0, visitas.size(), 64, [&](size_t i0, size_t i1) {
+        for (size_t i = i0; i < i1; ++i) ++visitas[i];
+    });
+    check(std::all_of(visitas.begin(), visitas.end(), [](int v) { return v == 1; }), "parallel_for sin repetir índices");
+
+    std::vector<long> filas(32, 0);
+    pool.parallel_for(0, filas.size(), 1, [&](size_t r0, size_t r1) {
+        for (size_t r = r0; r < r1; ++r) {
+            std::atomic<long> acc{0};
+            pool.parallel_for(0, 1000, 100, [&](size_t c0, size_t c1) {
+                long s = 0;
+                for (size_t c = c0; c < c1; ++c) s += long(c);
+                acc += s;
+            });
+            filas[r] = acc;
+        }
+    });
+    check(std::all_of(filas.begin(), filas.end(), [](long v) { return v == 999L * 1000L / 2; }), "parallel_for anidado");
+
+    bool propagada = false;
+    try {
+        pool.parallel_for(0, 100, 1, [](size_t i0, size_t) {
+            if (i0 == 37) throw std::runtime_error("trozo 37");
+        });
+    } catch (const std::runtime_error&) {
+        propagada = true;
+    }
+    check(propagada, "parallel_for propaga excepciones");
+
+    if (fallos == 0) std::cout << "Todas las pruebas del pool pasaron\n";
+    return fallos == 0 ? 0 : 1;
+}
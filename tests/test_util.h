@@ -0,0 +1,49 @@
+#pragma once
+
+#include "neural_network.h"
+#include "utec/random/Philox.h"
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+// Lo que comparten las pruebas: el contador de fallos que decide el código de salida, check y
+// las redes de prueba.
+
+inline int fallos = 0;
+
+inline void check(bool ok, const std::string& nombre) {
+    if (!ok) {
+        ++fallos;
+        std::cout << "FALLO: " << nombre << "\n";
+    }
+}
+
+// true si f lanza std::runtime_error.
+template <typename F>
+bool lanza(F&& f) {
+    try {
+        f();
+    } catch (const std::runtime_error&) {
+        return true;
+    }
+    return false;
+}
+
+// Red dims[0] -> ... -> dims.back() de Dense con ReLU entre ellas (y Sigmoid al final si se
+// pide), con pesos y sesgos uniformes en [-amplitud, amplitud) del flujo de inicialización de
+// la semilla dada.
+template <typename T>
+void armar(utec::neural_network::NeuralNetwork<T>& net, std::vector<size_t> dims, uint64_t semilla,
+           bool sigmoide = false, std::type_identity_t<T> amplitud = T(0.5)) {
+    utec::random::Stream rng(utec::random::stream_id(utec::random::Domain::Init, 0), semilla);
+    auto init = [&](auto& W) { for (auto& v : W) v = T(rng.uniform(float(-amplitud), float(amplitud))); };
+    for (size_t k = 0; k + 1 < dims.size(); ++k) {
+        net.add_layer(std::make_unique<utec::neural_network::Dense<T>>(dims[k], dims[k + 1], init, init));
+        if (k + 2 < dims.size()) net.add_layer(std::make_unique<utec::neural_network::ReLU<T>>());
+    }
+    if (sigmoide) net.add_layer(std::make_unique<utec::neural_network::Sigmoid<T>>());
+}
@@ -0,0 +1,94 @@
+#include "utec/agent/VectorEnvGym.h"
+#include "utec/agent/PongAgent.h"
+#include "neural_network.h"
+#include "test_util.h"
+#include <cmath>
+#include <iostream>
+
+using namespace utec;
+
+int main() {
+    const size_t n = 37;
+    nn::VectorEnvGym env(n, 1234), gemelo(n, 1234);
+
+    const auto& obs = env.reset();
+    check(obs.shape() == std::array<size_t,2>{n, 3}, "observación N x 3");
+    bool reset_ok = true;
+    for (size_t i = 0; i < n; ++i)
+        reset_ok &= obs(i, 0) == 0.5f && obs(i, 2) == 0.5f && obs(i, 1) >= 0.f && obs(i, 1) < 1.f;
+    check(reset_ok, "reset deja la paleta al centro y la pelota en [0, 1)");
+
+    std::vector<int> acciones(n);
+    for (size_t i = 0; i < n; ++i) acciones[i] = int(i % 3) - 1;
+    std::vector<float> recompensas;
+    std::vector<uint8_t> terminados;
+
+    bool paso_ok = true, reinicio_ok = true;
+    for (int paso = 0; paso < 5; ++paso) {
+        env.step(acciones, recompensas, terminados);
+        const auto& fin = env.final_observations();
+        for (size_t i = 0; i < n; ++i) {
+            // La recompensa sale del estado final; la observación ya es la del episodio nuevo.
+            float esperada = std::fabs(fin(i, 1) - fin(i, 2)) < 0.2f ? 1.f : -1.f;
+            paso_ok &= recompensas[i] == esperada && fin(i, 2) == 0.5f + 0.1f * float(acciones[i]);
+            reinicio_ok &= terminados[i] == 1 && env.observations()(i, 2) == 0.5f &&
+                           env.state(i).paddle_y == 0.5f;
+        }
+    }
+    check(recompensas.size() == n && terminados.size() == n, "salidas de tamaño N");
+    check(paso_ok, "dinámica igual a EnvGym");
+    check(reinicio_ok, "auto-reset de entornos terminados");
+
+    // Misma semilla, misma secuencia; entornos distintos no comparten estado aleatorio.
+    gemelo.reset();
+    for (int paso = 0; paso < 5; ++paso) gemelo.step(acciones, recompensas, terminados);
+    bool igual = true, distintos = false;
+    for (size_t i = 0; i < n; ++i) {
+        igual &= gemelo.observations()(i, 1) == env.observations()(i, 1);
+        distintos |= env.observations()(i, 1) != env.observations()(0, 1);
+    }
+    check(igual, "determinista con semilla");
+    check(distintos, "un generador por entorno");
+
+    // act_batch con forward_fn evalúa el lote en una sola llamada.
+    int llamadas = 0;
+    nn::PongAgent<float> agente([&](const algebra::Tensor<float,2>& x) {
+        ++llamadas;
+        algebra::Tensor<float,2> out(x.shape()[0], 1);
+        for (size_t i = 0; i < x.shape()[0]; ++i) out(i, 0) = x(i, 1) - x(i, 2);
+        return out;
+    });
+    std::vector<int> elegidas;
+    agente.act_batch(env.observations(), elegidas);
+    bool act_ok = llamadas == 1 && elegidas.size() == n;
+    for (size_t i = 0; i < n; ++i)
+        act_ok &= elegidas[i] == agente.act(env.state(i));
+    check(act_ok, "act_batch coincide con act");
+
+    // De punta a punta con la red de main.cpp: 100 episodios de un paso con una sola predicción
+    // por lotes, las mismas acciones que act sobre cada estado y una recompensa por entorno.
+    {
+        neural_network::NeuralNetwork<float> net;
+        float w = 0.3f;
+        auto init = [&](auto& W) { for (auto& v : W) v = (w = -w * 1.1f); };
+        net.add_layer(std::make_unique<neural_network::Dense<float>>(3, 16, init, init));
+        net.add_layer(std::make_unique<neural_network::ReLU<float>>());
+        net.add_layer(std::make_unique<neural_network::Dense<float>>(16, 8, init, init));
+        net.add_layer(std::make_unique<neural_network::ReLU<float>>());
+        net.add_layer(std::make_unique<neural_network::Dense<float>>(8, 1, init, init));
+        nn::PongAgent<float> politica([&](const algebra::Tensor<float,2>& x) { return net.predict(x); });
+
+        nn::VectorEnvGym episodios(100, 7);
+        std::vector<int> a;
+        politica.act_batch(episodios.reset(), a);
+        bool iguales = a.size() == 100;
+        for (size_t i = 0; i < a.size(); ++i) iguales &= a[i] == politica.act(episodios.state(i));
+        episodios.step(a, recompensas, terminados);
+        bool recompensas_ok = recompensas.size() == 100;
+        for (float r : recompensas) recompensas_ok &= r == 1.f || r == -1.f;
+        check(iguales && recompensas_ok, "episodios por lotes con la red de main.cpp");
+    }
+
+    if (fallos == 0) std::cout << "Todas las pruebas de VectorEnvGym pasaron\n";
+    return fallos == 0 ? 0 : 1;
+}
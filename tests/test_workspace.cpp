@@ -0,0 +1,178 @@
+#include "neural_network.h"
+#include "test_util.h"
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+
+// Reemplaza el operador new global para contar asignaciones y comprobar que el
+// entrenamiento y la inferencia en estado estable no tocan el heap. Van noinline para que GCC
+// no las expanda y confunda el free de delete con un new que no es de malloc
+// (-Wmismatched-new-delete).
+
+static std::atomic<size_t> asignaciones{0};
+
+[[gnu::noinline]] void* operator new(std::size_t n) {
+    ++asignaciones;
+    if (void* p = std::malloc(n ? n : 1)) return p;
+    throw std::bad_alloc();
+}
+
+[[gnu::noinline]] void* operator new(std::size_t n, std::align_val_t al) {
+    ++asignaciones;
+    std::size_t a = static_cast<std::size_t>(al);
+    if (void* p = std::aligned_alloc(a, (n + a - 1) / a * a)) return p;
+    throw std::bad_alloc();
+}
+
+[[gnu::noinline]] void* operator new[](std::size_t n) { return operator new(n); }
+[[gnu::noinline]] void* operator new[](std::size_t n, std::align_val_t al) { return operator new(n, al); }
+[[gnu::noinline]] void operator delete(void* p) noexcept { std::free(p); }
+[[gnu::noinline]] void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+[[gnu::noinline]] void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+[[gnu::noinline]] void operator delete(void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+[[gnu::noinline]] void operator delete[](void* p) noexcept { std::free(p); }
+[[gnu::noinline]] void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+[[gnu::noinline]] void operator delete[](void* p, std::align_val_t) noexcept { std::free(p); }
+[[gnu::noinline]] void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+
+using namespace utec;
+
+template <typename F>
+static size_t contar(F&& f) {
+    size_t antes = asignaciones.load();
+    f();
+    return asignaciones.load() - antes;
+}
+
+int main() {
+    using T = float;
+
+    neural_network::NeuralNetwork<T> net;
+    net.add_layer(std::make_unique<neural_network::Dense<T>>(3, 16));
+    net.add_layer(std::make_unique<neural_network::ReLU<T>>());
+    net.add_layer(std::make_unique<neural_network::Dense<T>>(16, 8));
+    net.add_layer(std::make_unique<neural_network::ReLU<T>>());
+    net.add_layer(std::make_unique<neural_network::Dense<T>>(8, 1));
+    net.add_layer(std::make_unique<neural_network::Sigmoid<T>>());
+
+    algebra::Tensor<T,2> X(64, 3), Y(64, 1);
+    for (size_t i = 0; i < 64; ++i) {
+        X(i, 0) = T(i % 7) / 7;
+        X(i, 1) = T(i % 5) / 5;
+        X(i, 2) = T(i % 3) / 3;
+        Y(i, 0) = X(i, 1) > X(i, 2) ? T(1) : T(0);
+    }
+
+    neural_network::SGD<T> sgd(0.05f);
+
+    // Calentamiento: planifica la arena y los buffers de empaquetado del GEMM.
+    net.train_batch(X.view(), Y.view(), sgd);
+    net.infer(X.view());
+
+    size_t en_train = contar([&] {
+        for (int i = 0; i < 100; ++i)
+            net.train_batch(X.view(), Y.view(), sgd);
+    });
+    check(en_train == 0, "train_batch sin asignaciones (" + std::to_string(en_train) + ")");
+
+    // Lotes más chicos reutilizan el prefijo de la arena.
+    size_t en_lote_parcial = contar([&] {
+        net.train_batch(X.view().slice_rows(0, 10), Y.view().slice_rows(0, 10), sgd);
+    });
+    check(en_lote_parcial == 0, "lote parcial sin asignaciones");
+
+    size_t en_infer = contar([&] {
+        for (int i = 0; i < 100; ++i) net.infer(X.view().slice_rows(i % 64, 1));
+    });
+    check(en_infer == 0, "infer sin asignaciones (" + std::to_string(en_infer) + ")");
+
+    // train(): las asignaciones por llamada no dependen del número de pasos.
+    size_t una_epoca = contar([&] { net.train<neural_network::BCELoss<T>>(X, Y, 1, 8, 0.05f); });
+    size_t veinte_epocas = contar([&] { net.train<neural_network::BCELoss<T>>(X, Y, 20, 8, 0.05f); });
+    check(una_epoca == veinte_epocas, "train(): asignaciones constantes por llamada (" +
+          std::to_string(una_epoca) + " vs " + std::to_string(veinte_epocas) + ")");
+
+    // La ruta por arena coincide con la ruta clásica capa por capa (Tensor por valor).
+    neural_network::NeuralNetwork<T> arena;
+    arena.add_layer(std::make_unique<neural_network::Dense<T>>(3, 16));
+    arena.add_layer(std::make_unique<neural_network::ReLU<T>>());
+    arena.add_layer(std::make_unique<neural_network::Dense<T>>(16, 1));
+    arena.add_layer(std::make_unique<neural_network::Sigmoid<T>>());
+    neural_network::Dense<T> d1(3, 16), d2(16, 1);
+    neural_network::ReLU<T> relu;
+    neural_network::Sigmoid<T> sig;
+    for (int paso = 0; paso < 5; ++paso) {
+        arena.train_batch(X.view(), Y.view(), sgd);
+        auto out = sig.forward(d2.forward(relu.forward(d1.forward(X))));
+        neural_network::MSELoss<T> loss(out, Y);
+        d1.backward(relu.backward(d2.backward(sig.backward(loss.loss_gradient()))));
+        d1.update_params(sgd);
+        d2.update_params(sgd);
+    }
+    auto pred = arena.predict(X);
+    auto ref = sig.forward(d2.forward(relu.forward(d1.forward(X))));
+    double err = 0;
+    for (size_t i = 0; i < 64; ++i) err = std::max(err, double(std::fabs(pred(i, 0) - ref(i, 0))));
+    check(err < 1e-6, "arena coincide con la ruta clásica");
+
+    // Cadenas donde la capa anterior conserva su salida (Sigmoid -> Sigmoid, Sigmoid -> ReLU): la
+    // arena no debe pisarla al correr en el lugar.
+    neural_network::NeuralNetwork<T> cadena;
+    cadena.add_layer(std::make_unique<neural_network::Dense<T>>(3, 8));
+    cadena.add_layer(std::make_unique<neural_network::Sigmoid<T>>());
+    cadena.add_layer(std::make_unique<neural_network::Sigmoid<T>>());
+    cadena.add_layer(std::make_unique<neural_network::ReLU<T>>());
+    cadena.add_layer(std::make_unique<neural_network::Dense<T>>(8, 1));
+    neural_network::Dense<T> c1(3, 8), c2(8, 1);
+    neural_network::Sigmoid<T> cs, cr1;
+    neural_network::ReLU<T> cr2;
+    neural_network::SGD<T> sgd_fuerte(0.5f);
+    for (int paso = 0; paso < 20; ++paso) {
+        cadena.train_batch(X.view(), Y.view(), sgd_fuerte);
+        auto out = c2.forward(cr2.forward(cr1.forward(cs.forward(c1.forward(X)))));
+        neural_network::MSELoss<T> loss(out, Y);
+        c1.backward(cs.backward(cr1.backward(cr2.backward(c2.backward(loss.loss_gradient())))));
+        c1.update_params(sgd_fuerte);
+        c2.update_params(sgd_fuerte);
+    }
+    auto pred_c = cadena.predict(X);
+    auto ref_c = c2.forward(cr2.forward(cr1.forward(cs.forward(c1.forward(X)))));
+    double err_c = 0;
+    for (size_t i = 0; i < 64; ++i) err_c = std::max(err_c, double(std::fabs(pred_c(i, 0) - ref_c(i, 0))));
+    check(err_c < 1e-5, "capas en el lugar respetan salidas conservadas");
+
+    // Plan compilado: mismo resultado que la ruta capa por capa con Dense seguidas de
+    // activación (fusionadas), activaciones sueltas y una Dense final sin activación.
+    auto sin_plan = cadena.predict(X);
+    cadena.compile(4);
+    check(cadena.compiled(), "compile() arma el plan");
+    auto con_plan = cadena.predict(X);
+    double err_p = 0;
+    for (size_t i = 0; i < 64; ++i) err_p = std::max(err_p, double(std::fabs(sin_plan(i, 0) - con_plan(i, 0))));
+    check(err_p < 1e-6, "plan compilado coincide con la ruta por capas");
+    check(std::fabs(cadena.score(&X(5, 0)) - sin_plan(5, 0)) < 1e-6, "score de una fila");
+
+    // El plan lee los pesos en vivo: entrenar no requiere recompilar.
+    cadena.train_batch(X.view(), Y.view(), sgd_fuerte);
+    auto tras_paso = cadena.predict(X);
+    cadena.add_layer(std::make_unique<neural_network::ReLU<T>>());
+    check(!cadena.compiled(), "add_layer descarta el plan");
+    auto ref_paso = cadena.predict(X);
+    double err_v = 0;
+    for (size_t i = 0; i < 64; ++i)
+        err_v = std::max(err_v, double(std::fabs(std::max(tras_paso(i, 0), T(0)) - ref_paso(i, 0))));
+    check(err_v < 1e-6, "plan sigue a los pesos entrenados");
+
+    net.compile();
+    net.score(&X(0, 0));
+    size_t en_score = contar([&] {
+        T acc = 0;
+        for (size_t i = 0; i < 64; ++i) acc += net.score(&X(i, 0));
+        check(acc == acc, "score finito");
+    });
+    check(en_score == 0, "score sin asignaciones (" + std::to_string(en_score) + ")");
+
+    if (fallos == 0) std::cout << "Todas las pruebas de workspace pasaron\n";
+    return fallos == 0 ? 0 : 1;
+}